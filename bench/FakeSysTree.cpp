@@ -0,0 +1,692 @@
+#include <bench/FakeSysTree.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string interfaceName(std::size_t i)
+{
+    return i == 0 ? "lo" : i == 1 ? "eth0" : "veth" + std::to_string(i - 2) + "a1b2";
+}
+
+// Rewrites in place so open descriptors stay valid. Writing first and
+// trimming the tail afterwards means a concurrent reader never sees an
+// empty file, which procfs never shows either.
+void writeFile(const std::string& path, const std::string& content)
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error(path + ": " + std::strerror(errno));
+    const char* p = content.data();
+    std::size_t left = content.size();
+    off_t offset = 0;
+    while (left > 0) {
+        ssize_t n = ::pwrite(fd, p, left, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) { ::close(fd); throw std::runtime_error(path + ": " + std::strerror(errno)); }
+        p += n;
+        offset += n;
+        left -= std::size_t(n);
+    }
+    if (::ftruncate(fd, offset) != 0) {
+        ::close(fd);
+        throw std::runtime_error(path + ": " + std::strerror(errno));
+    }
+    ::close(fd);
+}
+
+// Formats a CPU mask the way sysfs does: "0-3,6,8-11\n"
+std::string cpuList(const std::vector<char>& mask)
+{
+    std::string out;
+    const int n = int(mask.size());
+    for (int i = 0; i < n;) {
+        if (!mask[std::size_t(i)]) { ++i; continue; }
+        int j = i;
+        while (j + 1 < n && mask[std::size_t(j + 1)]) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(i);
+        if (j > i) out += '-' + std::to_string(j);
+        i = j + 1;
+    }
+    return out + "\n";
+}
+
+// Same as the kernel default; new PIDs wrap back to kPidWrap
+constexpr int kPidMax = 4194304;
+constexpr int kPidWrap = 300;
+
+// One hwmon chip: <dir>/name plus temp<N>_input/_label pairs
+struct Chip {
+    std::string name;
+    std::vector<std::pair<int, std::string>> temps;   // index, label ("" = no label file)
+    bool legacy = false;                              // attributes under device/
+};
+
+// Returns the temp*_input paths it created through inputs
+void writeChip(const fs::path& hwmonDir, const Chip& chip, std::vector<std::string>& inputs)
+{
+    fs::path dir = hwmonDir;
+    if (chip.legacy) dir /= "device";
+    fs::create_directories(dir);
+    writeFile((dir / "name").string(), chip.name + "\n");
+    for (const auto& [index, label] : chip.temps) {
+        const std::string base = (dir / ("temp" + std::to_string(index))).string();
+        writeFile(base + "_input", std::to_string(40000 + index * 500) + "\n");
+        inputs.push_back(base + "_input");
+        if (!label.empty()) writeFile(base + "_label", label + "\n");
+    }
+}
+
+Chip coretempChip(int package, int coresPerPackage)
+{
+    Chip chip{"coretemp", {}, false};
+    chip.temps.emplace_back(1, "Package id " + std::to_string(package));
+    // coretemp reports physical cores; assume two hardware threads each
+    const int physical = std::max(1, coresPerPackage / 2);
+    for (int c = 0; c < physical; ++c)
+        chip.temps.emplace_back(c + 2, "Core " + std::to_string(c));
+    return chip;
+}
+
+Chip k10tempChip(int coresPerPackage)
+{
+    Chip chip{"k10temp", {}, false};
+    chip.temps.emplace_back(1, "Tctl");
+    const int ccds = std::min(12, std::max(1, coresPerPackage / 16));
+    for (int c = 0; c < ccds; ++c)
+        chip.temps.emplace_back(c + 3, "Tccd" + std::to_string(c + 1));
+    return chip;
+}
+
+} // namespace
+
+const char* hwmonLayoutName(HwmonLayout layout)
+{
+    switch (layout) {
+    case HwmonLayout::None:     return "none";
+    case HwmonLayout::Coretemp: return "coretemp";
+    case HwmonLayout::K10temp:  return "k10temp";
+    case HwmonLayout::Mixed:    return "mixed";
+    }
+    return "unknown";
+}
+
+bool parseHwmonLayout(const std::string& name, HwmonLayout& out)
+{
+    for (HwmonLayout l : {HwmonLayout::None, HwmonLayout::Coretemp, HwmonLayout::K10temp, HwmonLayout::Mixed}) {
+        if (name == hwmonLayoutName(l)) { out = l; return true; }
+    }
+    return false;
+}
+
+FakeSysTree::FakeSysTree(std::string root, unsigned seed)
+    : m_root(std::move(root))
+    , m_rng(seed)
+{
+    fs::create_directories(procRoot());
+    fs::create_directories(sysRoot());
+}
+
+void FakeSysTree::build(const FakeTreeSpec& spec)
+{
+    fs::remove_all(procRoot());
+    fs::remove_all(sysRoot());
+    fs::create_directories(procRoot());
+    fs::create_directories(sysRoot());
+
+    m_spec = spec;
+    m_jiffies.clear();
+    m_online.clear();
+    m_procs.clear();
+    m_nextPid = 1;
+    m_uptimeTicks = 100000;
+    m_forks = 0;
+    m_cgroupUsage.clear();
+    writeMeminfo();
+    setCores(spec.cores);
+    setPids(spec.pids);
+    setCgroups(spec.cgroups);
+    m_netBytes.clear();
+    m_ifindex.clear();
+    m_nextIfindex = 1;
+    fs::remove_all(sysRoot() + "/class/net");
+    m_diskSectors.clear();
+    fs::create_directories(procRoot() + "/net");
+    setInterfaces(spec.interfaces);
+    setDisks(spec.disks);
+}
+
+void FakeSysTree::setCores(int cores)
+{
+    const int previous = int(m_jiffies.size());
+    m_spec.cores = std::max(1, cores);
+
+    m_jiffies.resize(std::size_t(m_spec.cores));
+    for (int i = previous; i < m_spec.cores; ++i) {
+        // Staggered starting counters so CPUs are distinguishable
+        const unsigned long long base = 1000 + unsigned(i);
+        Jiffies& j = m_jiffies[std::size_t(i)];
+        j.user = base * 40;
+        j.nice = base;
+        j.system = base * 12;
+        j.idle = base * 300;
+        j.iowait = base * 2;
+        j.softirq = base;
+    }
+    m_online.assign(std::size_t(m_spec.cores), 1);
+
+    writeProcStat();
+    writeCpuinfo();
+    writeCpuDirs(previous);
+    // coretemp/k10temp sensor counts follow the core count
+    setHwmon(m_spec.hwmon, m_spec.packages);
+}
+
+void FakeSysTree::setPids(int pids)
+{
+    pids = std::max(0, pids);
+    while (int(m_procs.size()) < pids) spawn();
+    while (int(m_procs.size()) > pids) {
+        fs::remove_all(procRoot() + "/" + std::to_string(m_procs.back().pid));
+        m_procs.pop_back();
+    }
+    m_spec.pids = pids;
+    // the "processes" line tracks forks
+    writeProcStat();
+}
+
+void FakeSysTree::setHwmon(HwmonLayout layout, int packages)
+{
+    m_spec.hwmon = layout;
+    m_spec.packages = std::max(1, packages);
+
+    const fs::path hwmon = sysRoot() + "/class/hwmon";
+    fs::remove_all(hwmon);
+    fs::create_directories(hwmon);
+
+    const int perPackage = std::max(1, m_spec.cores / m_spec.packages);
+    std::vector<Chip> chips;
+    // Unrelated chips every machine has; discovery has to skip them
+    chips.push_back({"acpitz", {{1, ""}}, false});
+
+    switch (layout) {
+    case HwmonLayout::None:
+        break;
+    case HwmonLayout::Coretemp:
+        for (int p = 0; p < m_spec.packages; ++p) chips.push_back(coretempChip(p, perPackage));
+        break;
+    case HwmonLayout::K10temp:
+        for (int p = 0; p < m_spec.packages; ++p) chips.push_back(k10tempChip(perPackage));
+        break;
+    case HwmonLayout::Mixed:
+        for (int p = 0; p < m_spec.packages; ++p) chips.push_back(coretempChip(p, perPackage));
+        chips.push_back({"cpu_thermal", {{1, ""}}, true});
+        break;
+    }
+    chips.push_back({"nvme", {{1, "Composite"}, {2, "Sensor 1"}}, false});
+
+    m_tempInputs.clear();
+    for (std::size_t i = 0; i < chips.size(); ++i)
+        writeChip(hwmon / ("hwmon" + std::to_string(i)), chips[i], m_tempInputs);
+}
+
+namespace {
+
+constexpr int kCgroupsPerPod = 8;
+
+std::string podRel(int leaf)
+{
+    return "kubepods.slice/pod" + std::to_string(leaf / kCgroupsPerPod);
+}
+
+std::string leafRel(int leaf)
+{
+    return podRel(leaf) + "/ctr" + std::to_string(leaf % kCgroupsPerPod);
+}
+
+} // namespace
+
+void FakeSysTree::setCgroups(int cgroups)
+{
+    cgroups = std::max(0, cgroups);
+    const int previous = int(m_cgroupUsage.size());
+    if (cgroups > 0 && !fs::exists(cgroupRoot() + "/cgroup.controllers")) {
+        fs::create_directories(cgroupRoot() + "/kubepods.slice");
+        writeFile(cgroupRoot() + "/cgroup.controllers", "cpuset cpu io memory hugetlb pids rdma misc\n");
+        writeCgroup("", 0, 0);
+        writeCgroup("kubepods.slice", 0, 0);
+    }
+
+    for (int i = previous; i < cgroups; ++i) {
+        if (i % kCgroupsPerPod == 0) {
+            fs::create_directories(cgroupRoot() + "/" + podRel(i));
+            writeCgroup(podRel(i), 0, 0);
+        }
+        fs::create_directories(cgroupRoot() + "/" + leafRel(i));
+        m_cgroupUsage.push_back(1000000 + unsigned(i) * 1000);
+        writeCgroup(leafRel(i), m_cgroupUsage.back(), 0);
+    }
+    for (int i = previous - 1; i >= cgroups; --i) {
+        // Files first: a tmpfs directory, unlike a cgroup, must be empty
+        fs::remove_all(cgroupRoot() + "/" + leafRel(i));
+        if (i % kCgroupsPerPod == 0) fs::remove_all(cgroupRoot() + "/" + podRel(i));
+        m_cgroupUsage.pop_back();
+    }
+    m_spec.cgroups = cgroups;
+}
+
+void FakeSysTree::setInterfaces(int interfaces)
+{
+    m_spec.interfaces = std::max(1, interfaces);
+    while (int(m_netBytes.size()) < m_spec.interfaces) {
+        m_netBytes.push_back(1000000ULL * (m_netBytes.size() + 1));
+        m_ifindex.push_back(m_nextIfindex++);
+        writeIfindex(m_ifindex.size() - 1);
+    }
+    for (std::size_t i = std::size_t(m_spec.interfaces); i < m_netBytes.size(); ++i)
+        fs::remove_all(sysRoot() + "/class/net/" + interfaceName(i));
+    m_netBytes.resize(std::size_t(m_spec.interfaces));
+    m_ifindex.resize(std::size_t(m_spec.interfaces));
+    writeNetDev();
+}
+
+void FakeSysTree::recreateInterface(int i, unsigned long long bytes)
+{
+    if (i < 0 || i >= int(m_netBytes.size())) return;
+    m_netBytes[std::size_t(i)] = bytes;
+    m_ifindex[std::size_t(i)] = m_nextIfindex++;
+    writeIfindex(std::size_t(i));
+    writeNetDev();
+}
+
+void FakeSysTree::setInterfaceBytes(int i, unsigned long long bytes)
+{
+    if (i < 0 || i >= int(m_netBytes.size())) return;
+    m_netBytes[std::size_t(i)] = bytes;
+    writeNetDev();
+}
+
+void FakeSysTree::writeIfindex(std::size_t i)
+{
+    const std::string dir = sysRoot() + "/class/net/" + interfaceName(i);
+    fs::create_directories(dir);
+    writeFile(dir + "/ifindex", std::to_string(m_ifindex[i]) + "\n");
+}
+
+void FakeSysTree::setDisks(int disks)
+{
+    m_spec.disks = std::max(0, disks);
+    const std::size_t lines = std::size_t(m_spec.disks) * 3;
+    while (m_diskSectors.size() < lines) m_diskSectors.push_back(20000ULL * (m_diskSectors.size() + 1));
+    m_diskSectors.resize(lines);
+    // Partitions are told apart by <sys>/class/block/<name>/partition
+    fs::remove_all(sysRoot() + "/class/block");
+    for (int disk = 0; disk < m_spec.disks; ++disk) {
+        for (int part = 1; part <= 2; ++part) {
+            const std::string dir = sysRoot() + "/class/block/nvme" + std::to_string(disk) + "n1p" + std::to_string(part);
+            fs::create_directories(dir);
+            writeFile(dir + "/partition", std::to_string(part) + "\n");
+        }
+    }
+    writeDiskstats();
+}
+
+void FakeSysTree::writeNetDev()
+{
+    std::string out =
+        "Inter-|   Receive                                                |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n";
+    out.reserve(out.size() + m_netBytes.size() * 160);
+    char line[256];
+    for (std::size_t i = 0; i < m_netBytes.size(); ++i) {
+        const std::string name = interfaceName(i);
+        const unsigned long long rx = m_netBytes[i];
+        const unsigned long long tx = rx / 2 + 1000;
+        std::snprintf(line, sizeof(line), "%*s: %llu %llu 0 0 0 0 0 0 %llu %llu 0 0 0 0 0 0\n",
+                      6, name.c_str(), rx, rx / 1000, tx, tx / 1000);
+        out += line;
+    }
+    writeFile(procRoot() + "/net/dev", out);
+}
+
+void FakeSysTree::writeDiskstats()
+{
+    std::string out;
+    char line[256];
+    for (std::size_t i = 0; i < m_diskSectors.size(); ++i) {
+        const std::size_t disk = i / 3, part = i % 3;
+        const std::string name = "nvme" + std::to_string(disk) + "n1" + (part ? "p" + std::to_string(part) : "");
+        const unsigned long long sectors = m_diskSectors[i];
+        const unsigned long long reads = sectors / 16;
+        std::snprintf(line, sizeof(line), "%4d %7zu %s %llu 0 %llu %llu %llu 0 %llu %llu 0 %llu %llu 0 0 0 0 0 0\n",
+                      259, disk * 3 + part, name.c_str(), reads, sectors, reads / 10,
+                      reads / 2, sectors / 2, reads / 20, reads / 8, reads / 6);
+        out += line;
+    }
+    writeFile(procRoot() + "/diskstats", out);
+}
+
+void FakeSysTree::writeCgroup(const std::string& rel, unsigned long long usageUs, unsigned long long ioBytes)
+{
+    const std::string dir = rel.empty() ? cgroupRoot() : cgroupRoot() + "/" + rel;
+    const std::string usage = std::to_string(usageUs);
+    writeFile(dir + "/cpu.stat",
+              "usage_usec " + usage + "\nuser_usec " + std::to_string(usageUs * 3 / 4)
+              + "\nsystem_usec " + std::to_string(usageUs / 4)
+              + "\nnr_periods 0\nnr_throttled 0\nthrottled_usec 0\nnr_bursts 0\nburst_usec 0\n");
+    writeFile(dir + "/io.stat",
+              "8:0 rbytes=" + std::to_string(ioBytes) + " wbytes=" + std::to_string(ioBytes / 2)
+              + " rios=" + std::to_string(ioBytes / 4096) + " wios=" + std::to_string(ioBytes / 8192)
+              + " dbytes=0 dios=0\n");
+    writeFile(dir + "/memory.stat",
+              "anon 104857600\nfile 52428800\nkernel 4194304\nkernel_stack 262144\npagetables 1048576\n"
+              "sec_pagetables 0\npercpu 8192\nsock 0\nvmalloc 0\nshmem 1048576\nfile_mapped 8388608\n"
+              "file_dirty 0\nfile_writeback 0\nswapcached 0\nanon_thp 0\nfile_thp 0\nshmem_thp 0\n"
+              "inactive_anon 0\nactive_anon 104857600\ninactive_file 26214400\nactive_file 26214400\n"
+              "unevictable 0\nslab_reclaimable 2097152\nslab_unreclaimable 1048576\nslab 3145728\n"
+              "pgfault 120000\npgmajfault 12\n");
+    if (rel.empty()) return;    // the root has no memory.current or pids.current
+    writeFile(dir + "/memory.current", "167772160\n");
+    writeFile(dir + "/pids.current", "4\n");
+}
+
+void FakeSysTree::advance(int jiffies, int busyProcesses)
+{
+    if (jiffies <= 0) return;
+    const unsigned long long ticks = unsigned(jiffies);
+    m_uptimeTicks += ticks;
+
+    for (std::size_t i = 0; i < m_jiffies.size(); ++i) {
+        if (!m_online[i]) continue;
+        // Random load per CPU; whatever is not busy is idle
+        const unsigned long long busy = m_rng() % (ticks + 1);
+        Jiffies& j = m_jiffies[i];
+        const unsigned long long user = busy * 7 / 10;
+        const unsigned long long system = busy * 2 / 10;
+        const unsigned long long softirq = busy / 20;
+        const unsigned long long iowait = busy - user - system - softirq;
+        j.user += user;
+        j.system += system;
+        j.softirq += softirq;
+        j.iowait += iowait;
+        j.idle += ticks - busy;
+    }
+    writeProcStat();
+
+    if (!m_procs.empty()) {
+        for (int n = 0; n < busyProcesses; ++n) {
+            Process& p = m_procs[m_rng() % m_procs.size()];
+            p.utime += m_rng() % (ticks + 1);
+            p.stime += m_rng() % (ticks / 4 + 1);
+            writePidStat(p);
+        }
+    }
+
+    writeTemperatures();
+
+    for (unsigned long long& bytes : m_netBytes) bytes += m_rng() % (ticks * 100000 + 1);
+    writeNetDev();
+    for (unsigned long long& sectors : m_diskSectors) sectors += m_rng() % (ticks * 200 + 1);
+    writeDiskstats();
+
+    // About half a CPU per leaf cgroup
+    const unsigned long long usPerTick = 10000;
+    for (std::size_t i = 0; i < m_cgroupUsage.size(); ++i) {
+        m_cgroupUsage[i] += m_rng() % (ticks * usPerTick + 1);
+        writeCgroup(leafRel(int(i)), m_cgroupUsage[i], m_cgroupUsage[i] * 16);
+    }
+}
+
+void FakeSysTree::churn(int exits, int spawns)
+{
+    for (int n = 0; n < exits && !m_procs.empty(); ++n) {
+        const std::size_t victim = m_rng() % m_procs.size();
+        fs::remove_all(procRoot() + "/" + std::to_string(m_procs[victim].pid));
+        m_procs[victim] = m_procs.back();
+        m_procs.pop_back();
+    }
+    for (int n = 0; n < spawns; ++n) spawn();
+    m_spec.pids = int(m_procs.size());
+    writeProcStat();
+}
+
+void FakeSysTree::setOnline(int cpu, bool online)
+{
+    if (cpu <= 0 || cpu >= int(m_online.size())) return;
+    if (bool(m_online[std::size_t(cpu)]) == online) return;
+    m_online[std::size_t(cpu)] = online;
+
+    writeFile(sysRoot() + "/devices/system/cpu/cpu" + std::to_string(cpu) + "/online", online ? "1\n" : "0\n");
+    writeOnlineMask();
+    writeProcStat();
+    writeCpuinfo();
+}
+
+int FakeSysTree::toggleRandomCpu()
+{
+    if (m_online.size() < 2) return -1;
+    const int cpu = 1 + int(m_rng() % (m_online.size() - 1));
+    setOnline(cpu, !m_online[std::size_t(cpu)]);
+    return cpu;
+}
+
+int FakeSysTree::onlineCount() const
+{
+    return int(std::count(m_online.begin(), m_online.end(), 1));
+}
+
+void FakeSysTree::remove()
+{
+    fs::remove_all(m_root);
+    m_procs.clear();
+    m_jiffies.clear();
+    m_online.clear();
+    m_cgroupUsage.clear();
+    m_netBytes.clear();
+    m_ifindex.clear();
+    m_diskSectors.clear();
+}
+
+void FakeSysTree::writeProcStat()
+{
+    std::string out;
+    out.reserve((m_jiffies.size() + 8) * 96);
+
+    auto line = [&out](const std::string& name, const Jiffies& j) {
+        // user nice system idle iowait irq softirq steal guest guest_nice
+        out += name;
+        for (unsigned long long v : {j.user, j.nice, j.system, j.idle, j.iowait, j.irq, j.softirq, j.steal, 0ULL, 0ULL}) {
+            out += ' ';
+            out += std::to_string(v);
+        }
+        out += '\n';
+    };
+
+    // The aggregate line covers every possible CPU, the per-CPU lines only
+    // the online ones
+    Jiffies sum;
+    for (const Jiffies& j : m_jiffies) {
+        sum.user += j.user;
+        sum.nice += j.nice;
+        sum.system += j.system;
+        sum.idle += j.idle;
+        sum.iowait += j.iowait;
+        sum.irq += j.irq;
+        sum.softirq += j.softirq;
+        sum.steal += j.steal;
+    }
+    line("cpu ", sum);
+    for (std::size_t i = 0; i < m_jiffies.size(); ++i)
+        if (m_online[i]) line("cpu" + std::to_string(i), m_jiffies[i]);
+
+    out += "intr " + std::to_string(m_uptimeTicks * 50);
+    for (int i = 0; i < 64; ++i) out += " 0";
+    out += "\nctxt " + std::to_string(m_uptimeTicks * 400) + "\nbtime 1700000000\nprocesses "
+         + std::to_string(m_forks) + "\nprocs_running 2\nprocs_blocked 0\nsoftirq 1234 0 0 0 0 0 0 0 0 0 0\n";
+
+    writeFile(procRoot() + "/stat", out);
+}
+
+void FakeSysTree::writeMeminfo()
+{
+    static const char kMeminfo[] =
+        "MemTotal:       65536000 kB\n"
+        "MemFree:        20480000 kB\n"
+        "MemAvailable:   40960000 kB\n"
+        "Buffers:          512000 kB\n"
+        "Cached:         18432000 kB\n"
+        "SwapCached:        10240 kB\n"
+        "Active:         24576000 kB\n"
+        "Inactive:       12288000 kB\n"
+        "Active(anon):   16384000 kB\n"
+        "Inactive(anon):  1024000 kB\n"
+        "Active(file):    8192000 kB\n"
+        "Inactive(file): 11264000 kB\n"
+        "Unevictable:       65536 kB\n"
+        "Mlocked:           65536 kB\n"
+        "SwapTotal:       8388608 kB\n"
+        "SwapFree:        8000000 kB\n"
+        "Zswap:                 0 kB\n"
+        "Zswapped:              0 kB\n"
+        "Dirty:              4096 kB\n"
+        "Writeback:             0 kB\n"
+        "AnonPages:      17000000 kB\n"
+        "Mapped:          2048000 kB\n"
+        "Shmem:           1024000 kB\n"
+        "KReclaimable:    1536000 kB\n"
+        "Slab:            2048000 kB\n"
+        "SReclaimable:    1536000 kB\n"
+        "SUnreclaim:       512000 kB\n"
+        "KernelStack:       32768 kB\n"
+        "PageTables:       131072 kB\n"
+        "SecPageTables:         0 kB\n"
+        "NFS_Unstable:          0 kB\n"
+        "Bounce:                0 kB\n"
+        "WritebackTmp:          0 kB\n"
+        "CommitLimit:    41156608 kB\n"
+        "Committed_AS:   30000000 kB\n"
+        "VmallocTotal:   34359738367 kB\n"
+        "VmallocUsed:      204800 kB\n"
+        "VmallocChunk:          0 kB\n"
+        "Percpu:            40960 kB\n"
+        "HardwareCorrupted:     0 kB\n"
+        "AnonHugePages:   4194304 kB\n"
+        "ShmemHugePages:        0 kB\n"
+        "ShmemPmdMapped:        0 kB\n"
+        "FileHugePages:         0 kB\n"
+        "FilePmdMapped:         0 kB\n"
+        "Unaccepted:            0 kB\n"
+        "HugePages_Total:       0\n"
+        "HugePages_Free:        0\n"
+        "HugePages_Rsvd:        0\n"
+        "HugePages_Surp:        0\n"
+        "Hugepagesize:       2048 kB\n"
+        "Hugetlb:               0 kB\n"
+        "DirectMap4k:      524288 kB\n"
+        "DirectMap2M:    33554432 kB\n"
+        "DirectMap1G:    33554432 kB\n";
+    writeFile(procRoot() + "/meminfo", kMeminfo);
+}
+
+void FakeSysTree::writeCpuinfo()
+{
+    std::string out;
+    out.reserve(std::size_t(m_spec.cores) * 160);
+    const int perPackage = std::max(1, m_spec.cores / m_spec.packages);
+    for (int i = 0; i < m_spec.cores; ++i) {
+        if (!m_online[std::size_t(i)]) continue;
+        out += "processor\t: " + std::to_string(i)
+             + "\nvendor_id\t: GenuineIntel\nmodel name\t: Synthetic CPU @ 2.40GHz"
+             + "\ncpu MHz\t\t: " + std::to_string(2400 + i % 8 * 100) + ".000"
+             + "\nphysical id\t: " + std::to_string(std::min(i / perPackage, m_spec.packages - 1))
+             + "\ncore id\t\t: " + std::to_string(i % perPackage / 2)
+             + "\n\n";
+    }
+    writeFile(procRoot() + "/cpuinfo", out);
+}
+
+void FakeSysTree::writeCpuDirs(int previousCores)
+{
+    const std::string cpuRoot = sysRoot() + "/devices/system/cpu";
+    fs::create_directories(cpuRoot);
+
+    for (int i = m_spec.cores; i < previousCores; ++i)
+        fs::remove_all(cpuRoot + "/cpu" + std::to_string(i));
+    for (int i = 0; i < m_spec.cores; ++i) {
+        const std::string dir = cpuRoot + "/cpu" + std::to_string(i);
+        fs::create_directories(dir + "/cpufreq");
+        writeFile(dir + "/cpufreq/scaling_cur_freq", std::to_string(2400000 + i % 8 * 100000) + "\n");
+        // cpu0 has no online switch on most machines
+        if (i > 0) writeFile(dir + "/online", "1\n");
+    }
+
+    const std::string all = cpuList(std::vector<char>(std::size_t(m_spec.cores), 1));
+    writeFile(cpuRoot + "/possible", all);
+    writeFile(cpuRoot + "/present", all);
+    writeOnlineMask();
+}
+
+void FakeSysTree::writeOnlineMask()
+{
+    writeFile(sysRoot() + "/devices/system/cpu/online", cpuList(m_online));
+}
+
+void FakeSysTree::writePidStat(const Process& p)
+{
+    const std::string id = std::to_string(p.pid);
+    writeFile(procRoot() + "/" + id + "/stat",
+              id + " (worker " + id + ") S 1 " + id + ' ' + id
+              + " 0 -1 4194560 100 0 0 0 " + std::to_string(p.utime) + ' ' + std::to_string(p.stime)
+              + " 0 0 20 0 " + std::to_string(p.threads) + " 0 " + std::to_string(p.startTime)
+              + " 10000000 250 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0\n");
+}
+
+void FakeSysTree::writePid(const Process& p)
+{
+    const std::string id = std::to_string(p.pid);
+    const std::string dir = procRoot() + "/" + id;
+    fs::create_directory(dir);
+
+    writePidStat(p);
+    writeFile(dir + "/status",
+              "Name:\tworker " + id + "\nState:\tS (sleeping)\nTgid:\t" + id + "\nPid:\t" + id
+              + "\nPPid:\t1\nVmRSS:\t1000 kB\nThreads:\t" + std::to_string(p.threads) + "\n");
+    writeFile(dir + "/cmdline", std::string("/usr/bin/worker\0--id\0", 21) + id + '\0');
+}
+
+void FakeSysTree::spawn()
+{
+    // Live PIDs are never handed out again until they exit
+    int pid = m_nextPid;
+    while (fs::exists(procRoot() + "/" + std::to_string(pid)))
+        pid = pid + 1 >= kPidMax ? kPidWrap : pid + 1;
+    m_nextPid = pid + 1 >= kPidMax ? kPidWrap : pid + 1;
+
+    Process p;
+    p.pid = pid;
+    p.threads = 1 + int(m_rng() % 8);
+    p.startTime = m_uptimeTicks;
+    writePid(p);
+    m_procs.push_back(p);
+    ++m_forks;
+}
+
+void FakeSysTree::writeTemperatures()
+{
+    // Bounded random walk shared by every sensor, offset per channel
+    m_tempBase += int(m_rng() % 1001) - 500;
+    m_tempBase = std::min(95000, std::max(30000, m_tempBase));
+    for (std::size_t i = 0; i < m_tempInputs.size(); ++i)
+        writeFile(m_tempInputs[i], std::to_string(m_tempBase + int(i % 8) * 500) + "\n");
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic procfs/sysfs tree for benchmarks and load tests. <root>/proc and
+// <root>/sys are laid out the way the Linux collectors read them; point
+// LinuxMonitorOptions::procRoot/sysRoot at procRoot()/sysRoot().
+//
+// Files are rewritten in place (write + trim, never rename) so that
+// descriptors the collectors keep open see the new contents, as they would
+// on the real pseudo filesystems. All mutation is driven by a seeded PRNG,
+// so the same seed and call sequence produce the same tree.
+
+enum class HwmonLayout {
+    None,       // no CPU sensor chips, only unrelated ones
+    Coretemp,   // one coretemp chip per package: "Package id N" + "Core N"
+    K10temp,    // one k10temp chip per package: Tctl + Tccd*
+    Mixed       // coretemp, a legacy device/ chip, and non-CPU chips
+};
+
+const char* hwmonLayoutName(HwmonLayout layout);
+bool parseHwmonLayout(const std::string& name, HwmonLayout& out);
+
+struct FakeTreeSpec {
+    int cores = 4;
+    int pids = 100;
+    int packages = 1;
+    HwmonLayout hwmon = HwmonLayout::Coretemp;
+    int cgroups = 0;            // leaf cgroups; 0 leaves out <sys>/fs/cgroup
+    int interfaces = 2;         // /proc/net/dev: lo, eth0, then veth pairs
+    int disks = 2;              // /proc/diskstats: whole disks, two partitions each
+};
+
+class FakeSysTree {
+public:
+    // Creates <root>/proc and <root>/sys; root itself must be writable
+    explicit FakeSysTree(std::string root, unsigned seed = 1);
+
+    FakeSysTree(const FakeSysTree&) = delete;
+    FakeSysTree& operator=(const FakeSysTree&) = delete;
+
+    // Writes every file for spec, replacing whatever the tree held before
+    void build(const FakeTreeSpec& spec);
+
+    // Reshapes one dimension of an already built tree. setCores brings
+    // every CPU online; setPids adds or removes the newest PIDs.
+    void setCores(int cores);
+    void setPids(int pids);
+    void setHwmon(HwmonLayout layout, int packages);
+    // cgroup v2 tree under <sys>/fs/cgroup: `cgroups` leaf groups, eight per
+    // kubepods.slice/podN parent. Shrinking removes the newest leaves (and
+    // pods left empty) with rmdir, as a container runtime would.
+    void setCgroups(int cgroups);
+    // Interfaces beyond lo and eth0 are veths; disks are nvme namespaces.
+    // Each interface has <sys>/class/net/<name>/ifindex.
+    void setInterfaces(int interfaces);
+    void setDisks(int disks);
+    // Deletes interface i and creates it again under the same name, as
+    // container runtimes do with veths: a new ifindex, counters from
+    // `bytes` instead of where the old one stood
+    void recreateInterface(int i, unsigned long long bytes = 0);
+    // Sets interface i's received bytes (transmit follows), e.g. just below
+    // 2^32 to make a 32-bit counter wrap
+    void setInterfaceBytes(int i, unsigned long long bytes);
+
+    // --- mutation over time ---
+    // Advances every online CPU by `jiffies` ticks split across the usage
+    // categories, charges CPU time to `busyProcesses` random PIDs and moves
+    // the temperature readings. Every leaf cgroup gets CPU time and IO, and
+    // every interface and disk moves traffic.
+    void advance(int jiffies, int busyProcesses);
+    // `exits` random PIDs disappear and `spawns` new ones appear with
+    // increasing PID numbers (wrapping like pid_max)
+    void churn(int exits, int spawns);
+    // Takes a CPU on or offline: /proc/stat, cpuinfo and the online mask
+    // drop it; CPU 0 cannot go offline
+    void setOnline(int cpu, bool online);
+    // Toggles one random CPU other than 0; returns its id
+    int toggleRandomCpu();
+
+    // Deletes the whole tree from disk
+    void remove();
+
+    const FakeTreeSpec& spec() const { return m_spec; }
+    int onlineCount() const;
+    const std::string& root() const { return m_root; }
+    std::string procRoot() const { return m_root + "/proc"; }
+    std::string sysRoot() const { return m_root + "/sys"; }
+
+private:
+    struct Jiffies {
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0;
+        unsigned long long iowait = 0, irq = 0, softirq = 0, steal = 0;
+    };
+    struct Process {
+        int pid = 0;
+        int threads = 1;
+        unsigned long long utime = 0;
+        unsigned long long stime = 0;
+        unsigned long long startTime = 0;
+    };
+
+    void writeProcStat();
+    void writeMeminfo();
+    void writeCpuinfo();
+    void writeCpuDirs(int previousCores);
+    void writeOnlineMask();
+    void writePidStat(const Process& p);
+    void writePid(const Process& p);
+    void spawn();
+    void writeTemperatures();
+    void writeNetDev();
+    void writeIfindex(std::size_t i);
+    void writeDiskstats();
+    void writeCgroup(const std::string& rel, unsigned long long usageUs, unsigned long long ioBytes);
+    std::string cgroupRoot() const { return sysRoot() + "/fs/cgroup"; }
+
+    std::string m_root;
+    FakeTreeSpec m_spec;
+    std::mt19937 m_rng;
+
+    std::vector<Jiffies> m_jiffies;     // per CPU
+    std::vector<char> m_online;         // per CPU
+    std::vector<Process> m_procs;
+    int m_nextPid = 1;
+    unsigned long long m_uptimeTicks = 0;
+    unsigned long long m_forks = 0;
+    std::vector<std::string> m_tempInputs;
+    std::vector<unsigned long long> m_cgroupUsage;     // per leaf, usage_usec
+    std::vector<unsigned long long> m_netBytes;        // per interface, received
+    std::vector<int> m_ifindex;                        // per interface
+    int m_nextIfindex = 1;
+    std::vector<unsigned long long> m_diskSectors;     // per disk line (disk, p1, p2), read
+    int m_tempBase = 40000;
+};
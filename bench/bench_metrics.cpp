@@ -0,0 +1,198 @@
+// bench_metrics.cpp
+// Load test for the /metrics endpoint: many concurrent keep-alive clients
+// scrape MetricsHttpServer on loopback while an updater thread re-renders
+// the exporter at the sampling engine's default cadence. Reports scrape
+// throughput and latency next to the cost of one render, which is what
+// every scrape would pay if the response were rendered on demand.
+//
+//   bench_metrics [clients] [seconds] [cores]     (default 64 5 128)
+#include <core/MetricsExporter.h>
+#include <core/MetricsHttpServer.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static CpuStats syntheticCpu(int cores, int tick)
+{
+    CpuStats cpu;
+    cpu.cpuUsage = 20 + tick % 50;
+    cpu.cpuTimes = {12, 0.5, 6, 80, 1, 0.1, 0.3, 0};
+    CpuUtilization& u = cpu.perCore;
+    for (int i = 0; i < cores; ++i) {
+        const double busy = (i * 7 + tick) % 100;
+        u.cpuId.push_back(i);
+        u.usage.push_back(busy);
+        u.user.push_back(busy * 0.7);
+        u.nice.push_back(0);
+        u.system.push_back(busy * 0.3);
+        u.idle.push_back(100 - busy);
+        u.iowait.push_back(0);
+        u.irq.push_back(0);
+        u.softirq.push_back(0);
+        u.steal.push_back(0);
+        cpu.cores.coreFreq.push_back(2400 + i % 8 * 100);
+    }
+    cpu.cores.totalCores = cores;
+    cpu.cores.averageFreq = 2750;
+    cpu.cpuClock = 2750;
+    cpu.temperatures.max = 61;
+    cpu.temperatures.packages = {58, 61};
+    for (int c = 0; c < cores / 2; ++c)
+        cpu.temperatures.cores.push_back({qint16(c * 2 / std::max(1, cores / 2)), qint16(c), 50.0 + c % 10});
+    return cpu;
+}
+
+static int connectLoopback(quint16 port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// One keep-alive request/response; false on any protocol error
+static bool scrape(int fd, std::string& buf, std::size_t& bodyBytes, bool& complete)
+{
+    static const char kRequest[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    if (::send(fd, kRequest, sizeof(kRequest) - 1, MSG_NOSIGNAL) != ssize_t(sizeof(kRequest) - 1)) return false;
+
+    buf.clear();
+    std::size_t headerEnd = std::string::npos;
+    std::size_t contentLength = 0;
+    char chunk[65536];
+    for (;;) {
+        const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buf.append(chunk, std::size_t(n));
+        if (headerEnd == std::string::npos) {
+            headerEnd = buf.find("\r\n\r\n");
+            if (headerEnd == std::string::npos) continue;
+            if (buf.compare(0, 12, "HTTP/1.1 200") != 0) return false;
+            const std::size_t cl = buf.find("Content-Length: ");
+            if (cl == std::string::npos || cl > headerEnd) return false;
+            contentLength = std::strtoull(buf.c_str() + cl + 16, nullptr, 10);
+        }
+        if (buf.size() >= headerEnd + 4 + contentLength) break;
+    }
+    bodyBytes = contentLength;
+    complete = buf.size() >= 6 && buf.compare(buf.size() - 6, 6, "# EOF\n") == 0;
+    return buf.size() == headerEnd + 4 + contentLength;
+}
+
+int main(int argc, char* argv[])
+{
+    const int clients = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int seconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const int cores = argc > 3 ? std::atoi(argv[3]) : 128;
+
+    MetricsExporter exporter;
+    MemStats mem;
+    mem.total = 64ULL << 30;
+    mem.used = 20ULL << 30;
+    mem.free = 44ULL << 30;
+    mem.swapUsed = 1ULL << 30;
+    mem.swapTotal = 8ULL << 30;
+    exporter.updateCpu(syntheticCpu(cores, 0));
+    exporter.updateMem(mem);
+    exporter.updateProcesses({1500, 9000});
+
+    // Cost of one render, i.e. what a render-per-scrape server pays each time
+    const CpuStats sample = syntheticCpu(cores, 1);
+    const int renders = 200;
+    const auto r0 = Clock::now();
+    for (int i = 0; i < renders; ++i) exporter.updateCpu(sample);
+    const double renderUs = std::chrono::duration<double, std::micro>(Clock::now() - r0).count() / renders;
+
+    MetricsHttpServer server(exporter);
+    if (!server.start("127.0.0.1", 0)) { std::perror("start"); return 1; }
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> failures{0}, truncated{0};
+
+    // Engine cadences: cpu every 250 ms, memory every second
+    std::thread updater([&] {
+        int tick = 2;
+        std::vector<CpuStats> samples{syntheticCpu(cores, 2), syntheticCpu(cores, 3)};
+        while (!stop) {
+            exporter.updateCpu(samples[std::size_t(tick % 2)]);
+            if (tick % 4 == 0) exporter.updateMem(mem);
+            ++tick;
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        }
+    });
+
+    std::vector<std::vector<double>> latencies(static_cast<std::size_t>(clients));
+    std::vector<std::thread> threads;
+    std::size_t bodyBytes = 0;
+    const auto deadline = Clock::now() + std::chrono::seconds(seconds);
+    for (int t = 0; t < clients; ++t) {
+        threads.emplace_back([&, t] {
+            int fd = connectLoopback(server.port());
+            if (fd < 0) { ++failures; return; }
+            std::string buf;
+            std::vector<double>& lat = latencies[std::size_t(t)];
+            lat.reserve(100000);
+            std::size_t bytes = 0;
+            while (Clock::now() < deadline) {
+                bool complete = false;
+                const auto t0 = Clock::now();
+                if (!scrape(fd, buf, bytes, complete)) { ++failures; break; }
+                lat.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+                if (!complete) ++truncated;
+            }
+            if (t == 0) bodyBytes = bytes;
+            ::close(fd);
+        });
+    }
+    for (std::thread& th : threads) th.join();
+    stop = true;
+    updater.join();
+
+    // Unknown paths are rejected
+    bool notFoundOk = false;
+    if (int fd = connectLoopback(server.port()); fd >= 0) {
+        static const char kBad[] = "GET /nope HTTP/1.1\r\n\r\n";
+        char reply[64] = {};
+        if (::send(fd, kBad, sizeof(kBad) - 1, MSG_NOSIGNAL) > 0 && ::recv(fd, reply, sizeof(reply) - 1, 0) > 0)
+            notFoundOk = std::strncmp(reply, "HTTP/1.1 404", 12) == 0;
+        ::close(fd);
+    }
+    server.stop();
+
+    std::vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&all](double q) { return all.empty() ? 0.0 : all[std::min(all.size() - 1, std::size_t(q * double(all.size())))]; };
+
+    std::printf("clients %d, %d s, %d cores, body %zu bytes\n", clients, seconds, cores, bodyBytes);
+    std::printf("render per update    %10.1f us\n", renderUs);
+    std::printf("scrapes              %10zu  (%.0f/s, server counted %llu)\n",
+                all.size(), double(all.size()) / seconds, (unsigned long long)server.scrapes());
+    std::printf("scrape latency us    p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+                pct(0.50), pct(0.90), pct(0.99), all.empty() ? 0.0 : all.back());
+    std::printf("failures %ld, bodies without # EOF %ld, 404 check %s\n",
+                failures.load(), truncated.load(), notFoundOk ? "ok" : "FAILED");
+    return failures == 0 && truncated == 0 && notFoundOk ? 0 : 1;
+}
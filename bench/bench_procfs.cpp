@@ -0,0 +1,89 @@
+// bench_procfs.cpp
+// Compares the old ifstream-based /proc/stat and /proc/meminfo readers with
+// the persistent-descriptor ProcFile + non-allocating parsers.
+#include <platform/linux/ProcFile.h>
+#include <platform/linux/ProcReaders.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// ----- previous implementation, kept here as the baseline -----
+static CpuLoad legacyReadCpuLoad()
+{
+    CpuLoad load{};
+    std::ifstream file("/proc/stat");
+    std::string cpu;
+    if (file.is_open()) {
+        file >> cpu >> load.user >> load.nice >> load.system >> load.idle;
+    }
+    return load;
+}
+
+static MemStats legacyReadMemStats()
+{
+    MemStats ms{};
+    std::ifstream file("/proc/meminfo");
+    std::string key;
+    unsigned long value;
+    std::string unit;
+
+    unsigned long memFree=0, buffers=0, cached=0;
+
+    while (file >> key >> value >> unit) {
+        if (key == "MemTotal:")   ms.total = value * 1024ULL;
+        else if (key == "MemFree:") memFree = value * 1024ULL;
+        else if (key == "Buffers:") buffers = value * 1024ULL;
+        else if (key == "Cached:") cached = value * 1024ULL;
+        else if (key == "SwapTotal:") ms.swapTotal = value * 1024ULL;
+        else if (key == "SwapFree:") {
+            unsigned long swapFree = value * 1024ULL;
+            ms.swapUsed = ms.swapTotal - swapFree;
+        }
+    }
+
+    ms.free = memFree + buffers + cached;
+    ms.used = ms.total - ms.free;
+    return ms;
+}
+
+// Keeps the optimizer from dropping the work
+static volatile unsigned long long g_sink;
+
+template <typename F>
+static double nsPerCall(int iterations, F&& fn)
+{
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < iterations / 10; ++i) fn(); // warm-up
+    auto t0 = clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto t1 = clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    ProcFile procStat("/proc/stat", 64 * 1024);
+    ProcFile meminfo("/proc/meminfo", 8 * 1024);
+
+    const double oldStat = nsPerCall(iterations, [] { g_sink = legacyReadCpuLoad().user; });
+    const double newStat = nsPerCall(iterations, [&] {
+        CpuLoad l{};
+        parseCpuLoad(procStat.read(), l);
+        g_sink = l.user;
+    });
+    const double oldMem = nsPerCall(iterations, [] { g_sink = legacyReadMemStats().total; });
+    const double newMem = nsPerCall(iterations, [&] {
+        MemStats ms{};
+        parseMemInfo(meminfo.read(), ms);
+        g_sink = ms.total;
+    });
+
+    std::printf("%-16s %12s %12s %8s\n", "file", "ifstream ns", "pread ns", "speedup");
+    std::printf("%-16s %12.0f %12.0f %7.2fx\n", "/proc/stat", oldStat, newStat, oldStat / newStat);
+    std::printf("%-16s %12.0f %12.0f %7.2fx\n", "/proc/meminfo", oldMem, newMem, oldMem / newMem);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// bench_threads.cpp
+// Cost of one ThreadWatcher read on a process with many threads: this
+// process starts the threads (most sleep a second at a time, one in a
+// hundred wakes every 5 ms, so some schedstat counters move between reads),
+// watches itself and times reads at the sampling engine's 100 ms cadence.
+// Reports wall and thread CPU time per read and syscalls per thread.
+//
+//   bench_threads [threads] [reads]     (default 3000 20)
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ThreadWatcher.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double threadCpuUs()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return double(ts.tv_sec) * 1e6 + double(ts.tv_nsec) / 1e3;
+}
+
+int main(int argc, char* argv[])
+{
+    const int threads = argc > 1 ? std::atoi(argv[1]) : 3000;
+    const int reads = argc > 2 ? std::atoi(argv[2]) : 20;
+    if (threads < 0 || reads < 1) {
+        std::fprintf(stderr, "usage: %s [threads] [reads]\n", argv[0]);
+        return 2;
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> pool;
+    pool.reserve(std::size_t(threads));
+    for (int i = 0; i < threads; ++i) {
+        const auto nap = std::chrono::milliseconds(i % 100 == 0 ? 5 : 1000);
+        pool.emplace_back([&stop, nap] {
+            while (!stop) std::this_thread::sleep_for(nap);
+        });
+    }
+
+    ProcScanner scanner;
+    ThreadWatcher watcher(scanner);
+    if (!watcher.watch(int(::getpid()))) {
+        std::fprintf(stderr, "cannot watch own pid\n");
+        return 1;
+    }
+    watcher.read();     // opens every thread's files
+
+    CollectorProbe probe("threads");
+    std::vector<double> wallUs, cpuUs;
+    std::size_t rows = 0;
+    for (int r = 0; r < reads; ++r) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto t0 = Clock::now();
+        const double c0 = threadCpuUs();
+        ThreadTable table;
+        {
+            ProbeScope scope(probe);
+            table = watcher.read();
+        }
+        cpuUs.push_back(threadCpuUs() - c0);
+        wallUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        rows = table.processes.empty() ? 0 : table.processes.front().threads.size();
+    }
+    stop = true;
+    for (std::thread& t : pool) t.join();
+
+    std::sort(wallUs.begin(), wallUs.end());
+    std::sort(cpuUs.begin(), cpuUs.end());
+    const CollectorStats stats = probe.stats();
+    std::printf("%zu threads watched (%zu files open), %d reads\n", rows, watcher.openFiles(), reads);
+    std::printf("read wall us         p50 %.0f  max %.0f\n", wallUs[wallUs.size() / 2], wallUs.back());
+    std::printf("read cpu us          p50 %.0f  max %.0f\n", cpuUs[cpuUs.size() / 2], cpuUs.back());
+    std::printf("syscalls per thread  %10.2f\n",
+                rows ? double(stats.syscalls) / reads / double(rows) : 0.0);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// check_locale.cpp
+// Output and config parsing that must not follow LC_NUMERIC. Switches the
+// process to a locale with a decimal comma, as QCoreApplication does from
+// the environment on such hosts, then checks that the OpenMetrics text
+// still uses '.' and spells non-finite values NaN/+Inf/-Inf, and that rule
+// files with fractional numbers and durations still parse. Exits 77
+// (skipped) when no comma-decimal locale is installed, 1 on a failure.
+//
+//   check_locale [locale]     (default: the first of de_DE, fr_FR, ru_RU, nl_NL found)
+#include <core/MetricsExporter.h>
+#include <core/RuleEngine.h>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static bool useCommaLocale(const char* requested)
+{
+    static const char* const kCandidates[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8",
+                                              "ru_RU.UTF-8", "ru_RU.utf8", "nl_NL.UTF-8", "nl_NL.utf8"};
+    if (requested) return std::setlocale(LC_ALL, requested) && std::strcmp(std::localeconv()->decimal_point, ",") == 0;
+    for (const char* name : kCandidates)
+        if (std::setlocale(LC_ALL, name) && std::strcmp(std::localeconv()->decimal_point, ",") == 0) return true;
+    return false;
+}
+
+static void checkExporter()
+{
+    CpuStats cpu;
+    cpu.cpuUsage = 42;
+    cpu.cpuTimes = {12.5, 0, 6, 80, 1, 0.1, 0.3, 0};
+    cpu.cores.totalCores = 2;
+    cpu.cores.averageFreq = std::numeric_limits<double>::quiet_NaN();
+    cpu.perCore.cpuId = {0, 1};
+    cpu.perCore.usage = {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+
+    MetricsExporter exporter;
+    exporter.updateCpu(cpu);
+    const std::string body = MetricsExporter::body(exporter.response());
+
+    expect(body.find("sysmon_cpu_usage_ratio 0.42\n") != std::string::npos, "usage rendered as 0.42");
+    expect(body.find("sysmon_cpu_time_ratio{mode=\"user\"} 0.125\n") != std::string::npos, "user share rendered as 0.125");
+    expect(body.find("sysmon_cpu_average_frequency_hertz NaN\n") != std::string::npos, "NaN spelled NaN");
+    expect(body.find("sysmon_cpu_core_usage_ratio{cpu=\"0\"} +Inf\n") != std::string::npos, "infinity spelled +Inf");
+    expect(body.find("sysmon_cpu_core_usage_ratio{cpu=\"1\"} -Inf\n") != std::string::npos, "negative infinity spelled -Inf");
+
+    // No sample line may carry a decimal comma
+    std::size_t line = 0;
+    bool comma = false;
+    while (line < body.size()) {
+        const std::size_t end = body.find('\n', line);
+        const std::string text = body.substr(line, end - line);
+        if (text[0] != '#' && text.find(',', text.rfind(' ')) != std::string::npos) comma = true;
+        line = end + 1;
+    }
+    expect(!comma, "no decimal comma in sample values");
+}
+
+static void checkRules()
+{
+    RuleEngine engine;
+    std::string error;
+    const bool compiled = engine.compile("hot: cpu.usage > 90.5 for 1.5s clear < 80.25\n"
+                                         "low: mem.available < 0.5G\n", &error);
+    if (!compiled) std::printf("rules: %s\n", error.c_str());
+    expect(compiled, "rules with fractional numbers and durations compile");
+    if (!compiled) return;
+
+    CpuStats cpu;
+    cpu.cpuUsage = 90.75;
+    engine.updateCpu(cpu, 0);
+    engine.updateCpu(cpu, 1400);
+    expect(engine.state(0) == RuleEngine::State::Pending, "90.75 > 90.5 pending before 1.5s");
+    engine.updateCpu(cpu, 1500);
+    expect(engine.state(0) == RuleEngine::State::Firing, "firing after 1.5s");
+    cpu.cpuUsage = 80.5;
+    engine.updateCpu(cpu, 2000);
+    expect(engine.state(0) == RuleEngine::State::Firing, "80.5 does not clear below 80.25");
+    cpu.cpuUsage = 80;
+    engine.updateCpu(cpu, 2500);
+    expect(engine.state(0) == RuleEngine::State::Inactive, "80 clears below 80.25");
+
+    MemStats mem;
+    mem.available = 511ULL << 20;
+    engine.updateMem(mem, 0);
+    expect(engine.state(1) == RuleEngine::State::Firing, "511M < 0.5G");
+    mem.available = 513ULL << 20;
+    engine.updateMem(mem, 1000);
+    expect(engine.state(1) == RuleEngine::State::Inactive, "513M not < 0.5G");
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 2) {
+        std::fprintf(stderr, "usage: %s [locale]\n", argv[0]);
+        return 2;
+    }
+    if (!useCommaLocale(argc > 1 ? argv[1] : nullptr)) {
+        std::printf("no locale with a decimal comma installed, skipped\n");
+        return 77;
+    }
+    char probe[16];
+    std::snprintf(probe, sizeof(probe), "%.1f", 0.5);
+    std::printf("LC_NUMERIC %s formats 0.5 as %s\n", std::setlocale(LC_NUMERIC, nullptr), probe);
+
+    checkExporter();
+    checkRules();
+
+    std::printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
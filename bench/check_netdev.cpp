@@ -0,0 +1,98 @@
+// check_netdev.cpp
+// NetDevReader on a synthetic tree when a veth is deleted and re-created
+// under the same name while its byte counter sits in [2^31, 2^32): the new
+// interface must start over, not be taken for a 32-bit wrap and reported as
+// a multi-GiB burst. A genuine wrap on an interface that stayed must still
+// count the bytes across it. Exits 1 on a failure.
+//
+//   check_netdev [dir]     (default $TMPDIR or /tmp)
+#include <bench/FakeSysTree.h>
+#include <platform/linux/NetDevReader.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static const NetInterfaceStats* find(const NetStats& stats, const char* name)
+{
+    for (const NetInterfaceStats& s : stats.interfaces)
+        if (s.name == QString::fromLatin1(name)) return &s;
+    return nullptr;
+}
+
+// Bytes the reader saw move on interface `name` during the last interval
+static double received(const NetStats& stats, const char* name)
+{
+    const NetInterfaceStats* s = find(stats, name);
+    return s ? s->rxBytesPerSec * stats.intervalSeconds : -1;
+}
+
+static NetStats nextRead(NetDevReader& reader)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return reader.read();
+}
+
+int main(int argc, char* argv[])
+{
+    const char* tmp = argc > 1 ? argv[1] : std::getenv("TMPDIR");
+    const std::string root = std::string(tmp && *tmp ? tmp : "/tmp") + "/check_netdev." + std::to_string(::getpid());
+
+    FakeSysTree fake(root);
+    FakeTreeSpec spec;
+    spec.cores = 1;
+    spec.pids = 1;
+    spec.interfaces = 4;        // lo, eth0, veth0a1b2, veth1a1b2
+    spec.disks = 0;
+    fake.build(spec);
+
+    NetDevReader reader(fake.procRoot(), fake.sysRoot());
+    const unsigned long long high = 3000000000ULL;      // between 2^31 and 2^32
+    fake.setInterfaceBytes(2, high);
+    fake.setInterfaceBytes(3, high);
+    reader.read();
+    fake.setInterfaceBytes(2, high + 5000);
+    fake.setInterfaceBytes(3, high + 5000);
+    NetStats stats = nextRead(reader);
+    expect(received(stats, "veth0a1b2") > 4999 && received(stats, "veth0a1b2") < 5001, "5000 bytes before the re-creation");
+
+    // veth0 comes back as a new interface; veth1 stays and keeps counting
+    fake.recreateInterface(2, 1000);
+    fake.setInterfaceBytes(3, high + 10000);
+    stats = nextRead(reader);
+    const double recreated = received(stats, "veth0a1b2");
+    std::printf("re-created veth0a1b2: %.0f bytes in the interval (old code: ~%.0f)\n",
+                recreated, double(0x100000000ULL - (high + 5000) + 1000));
+    expect(recreated == 0, "re-created interface starts over instead of wrapping");
+    expect(received(stats, "veth1a1b2") > 4999 && received(stats, "veth1a1b2") < 5001, "untouched interface keeps its rate");
+
+    stats = nextRead(reader);
+    fake.setInterfaceBytes(2, 3000);
+    stats = nextRead(reader);
+    expect(received(stats, "veth0a1b2") > 1999 && received(stats, "veth0a1b2") < 2001, "re-created interface counts from its new value");
+
+    // Same interface, 32-bit counter wrapping
+    fake.setInterfaceBytes(3, 0xFFFFFFFFULL - 299);
+    nextRead(reader);
+    fake.setInterfaceBytes(3, 500);
+    stats = nextRead(reader);
+    const double wrapped = received(stats, "veth1a1b2");
+    std::printf("wrapped veth1a1b2: %.0f bytes in the interval\n", wrapped);
+    expect(wrapped > 799 && wrapped < 801, "a 32-bit wrap on the same interface counts 800 bytes");
+
+    fake.remove();
+    std::printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+// check_procevents.cpp
+// Fork/reap check for ProcEventTracker: forks and reaps thousands of
+// children, each starting a few threads, while this process also starts and
+// joins threads, and after every round compares the event-driven totals with
+// a fresh /proc scan. Needs CAP_NET_ADMIN in the initial namespaces; exits 77
+// (skipped) when the proc connector is unavailable, 1 on a mismatch.
+//
+//   check_procevents [--children N] [--threads N] [--rounds N]
+#include <platform/linux/ProcEventTracker.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static int usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--children N] [--threads N] [--rounds N]\n"
+                 "\n"
+                 "  --children N   children alive at once per round (default 500)\n"
+                 "  --threads N    extra threads started by every child (default 3)\n"
+                 "  --rounds N     fork/reap rounds (default 6)\n", argv0);
+    return 2;
+}
+
+// Child: start threads, report readiness, block until the parent closes go
+static void childMain(int ready, int go, int threads)
+{
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back([go] {
+            char c;
+            while (::read(go, &c, 1) < 0) {}
+        });
+    }
+    const char c = 1;
+    (void)::write(ready, &c, 1);
+    char x;
+    while (::read(go, &x, 1) < 0) {}
+    for (std::thread& t : pool) t.join();
+    ::_exit(0);
+}
+
+// Tracker and a /proc scan agree once nothing else on the host moved in
+// between; other processes may fork meanwhile, so retry a few times
+static bool matches(ProcEventTracker& tracker, ProcScanner& scanner, const char* when, int round)
+{
+    ProcessThreadTotals events{}, scan{};
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        events = tracker.totals();
+        scan = scanner.scanTotals();
+        if (events.processCount == scan.processCount && events.threadCount == scan.threadCount) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::printf("round %d %s: events %d processes / %lld threads, scan %d / %lld\n", round, when,
+                events.processCount, static_cast<long long>(events.threadCount), scan.processCount,
+                static_cast<long long>(scan.threadCount));
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    int children = 500;
+    int threads = 3;
+    int rounds = 6;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--children") && hasValue) children = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--threads") && hasValue) threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--rounds") && hasValue) rounds = std::atoi(argv[++i]);
+        else return usage(argv[0]);
+    }
+    if (children < 1 || threads < 0 || rounds < 1) return usage(argv[0]);
+
+    ProcScanner scanner;
+    // No periodic rescan during the run: every count has to come from events
+    ProcEventTracker tracker(scanner, std::chrono::hours(1));
+    if (!tracker.start()) {
+        std::printf("proc connector unavailable (needs CAP_NET_ADMIN in the initial namespaces), skipped\n");
+        return 77;
+    }
+    const unsigned long long baseRescans = tracker.rescanCount();
+
+    bool ok = matches(tracker, scanner, "at start", 0);
+    long forked = 0;
+    for (int round = 1; round <= rounds && ok; ++round) {
+        int ready[2], go[2];
+        if (::pipe(ready) != 0 || ::pipe(go) != 0) {
+            std::perror("pipe");
+            return 1;
+        }
+
+        std::vector<pid_t> pids;
+        for (int i = 0; i < children; ++i) {
+            const pid_t pid = ::fork();
+            if (pid < 0) {
+                std::perror("fork");
+                break;
+            }
+            if (pid == 0) {
+                ::close(ready[0]);
+                ::close(go[1]);
+                childMain(ready[1], go[0], threads);
+            }
+            pids.push_back(pid);
+        }
+        ::close(ready[1]);
+        ::close(go[0]);
+        forked += long(pids.size());
+
+        // Threads of our own come and go alongside the children
+        std::vector<std::thread> own;
+        for (int i = 0; i < round * 4; ++i)
+            own.emplace_back([] { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+
+        for (std::size_t i = 0; i < pids.size(); ++i) {
+            char c;
+            if (::read(ready[0], &c, 1) != 1) break;
+        }
+        ok = matches(tracker, scanner, "with children alive", round);
+
+        for (std::thread& t : own) t.join();
+        ::close(go[1]);     // every child sees EOF and exits
+        for (pid_t pid : pids) ::waitpid(pid, nullptr, 0);
+        ::close(ready[0]);
+        ok = ok && matches(tracker, scanner, "after reaping", round);
+    }
+
+    const unsigned long long rescans = tracker.rescanCount() - baseRescans;
+    std::printf("forked %ld children with %d threads each over %d rounds: %s (%llu rescans after lost events)\n",
+                forked, threads, rounds, ok ? "counts match /proc" : "MISMATCH", rescans);
+    tracker.stop();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// check_recording.cpp
+// Round trip of RecordingWriter/RecordingReader: writes samples across
+// several chunks and checks that every recorded field comes back, the
+// memory fields added in version 2 included. Then reads a version 1 file
+// built by hand and checks the upgrade, and that the writer refuses to
+// append to it. Exits 1 on a failure.
+//
+//   check_recording [samples]     (default 2000)
+#include <core/DeltaCodec.h>
+#include <core/Recording.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static RecordedSample sampleAt(int i)
+{
+    RecordedSample s;
+    s.timeMs = 1700000000000LL + i * 1000LL + (i % 7 == 0 ? 3 : 0);
+    s.cpu.cpuUsage = (i * 37) % 100 + 0.25;
+    s.cpu.cpuClock = 2400 + i % 13;
+    s.cpu.cpuTemperature = 50 + i % 20;
+    s.cpu.cores.totalCores = 64;
+    s.cpu.cores.averageFreq = 2500 + i % 11;
+    s.cpu.temperatures.max = 60 + i % 5;
+    s.mem.total = 64ULL << 30;
+    s.mem.available = (20ULL << 30) + quint64(i) * 4096;
+    s.mem.used = s.mem.total - s.mem.available;
+    s.mem.free = (10ULL << 30) - quint64(i) * 4096;
+    s.mem.swapTotal = 8ULL << 30;
+    s.mem.swapUsed = quint64(i % 50) << 20;
+    s.mem.committed = (30ULL << 30) + quint64(i) * 8192;
+    s.mem.commitLimit = 40ULL << 30;
+    s.processes.processCount = 500 + i % 40;
+    s.processes.threadCount = 3000 + i % 400;
+    return s;
+}
+
+static bool same(const RecordedSample& a, const RecordedSample& b)
+{
+    return a.timeMs == b.timeMs && a.cpu.cpuUsage == b.cpu.cpuUsage && a.cpu.cpuClock == b.cpu.cpuClock
+        && a.cpu.cpuTemperature == b.cpu.cpuTemperature && a.cpu.cores.totalCores == b.cpu.cores.totalCores
+        && a.cpu.cores.averageFreq == b.cpu.cores.averageFreq && a.cpu.temperatures.max == b.cpu.temperatures.max
+        && a.mem.total == b.mem.total && a.mem.used == b.mem.used && a.mem.free == b.mem.free
+        && a.mem.swapUsed == b.mem.swapUsed && a.mem.swapTotal == b.mem.swapTotal
+        && a.mem.available == b.mem.available && a.mem.committed == b.mem.committed
+        && a.mem.commitLimit == b.mem.commitLimit && a.processes.processCount == b.processes.processCount
+        && a.processes.threadCount == b.processes.threadCount;
+}
+
+static void checkRoundTrip(const std::string& path, int samples)
+{
+    {
+        RecordingWriter writer(128);
+        expect(writer.open(path), "create recording");
+        for (int i = 0; i < samples; ++i) writer.append(sampleAt(i));
+    }
+
+    RecordingReader reader;
+    expect(reader.open(path), "open recording");
+    expect(reader.sampleCount() == std::size_t(samples), "sample count");
+    RecordingReader::Cursor cursor = reader.cursor();
+    RecordedSample s;
+    int read = 0, mismatched = 0;
+    while (cursor.next(s)) {
+        if (!same(s, sampleAt(read))) ++mismatched;
+        ++read;
+    }
+    std::printf("round trip: %d of %d samples read, %d mismatched\n", read, samples, mismatched);
+    expect(read == samples && mismatched == 0, "every field survives the round trip");
+    expect(s.mem.available != 0 && s.mem.committed != 0 && s.mem.commitLimit != 0,
+           "available, committed and commitLimit are recorded");
+}
+
+// One chunk with one sample in the version 1 layout: eight integer fields
+// (cores, total, used, free, swapUsed, swapTotal, processes, threads) and
+// five floating-point fields
+static void writeV1(const std::string& path, const RecordedSample& s)
+{
+    using namespace deltacodec;
+    std::vector<unsigned char> payload;
+    const qint64 ints[] = {s.cpu.cores.totalCores, qint64(s.mem.total), qint64(s.mem.used), qint64(s.mem.free),
+                           qint64(s.mem.swapUsed), qint64(s.mem.swapTotal), s.processes.processCount,
+                           s.processes.threadCount};
+    for (qint64 v : ints) putVarint(payload, zigzag(v));
+    const double floats[] = {s.cpu.cpuUsage, s.cpu.cpuClock, s.cpu.cpuTemperature, s.cpu.cores.averageFreq,
+                             s.cpu.temperatures.max};
+    for (double v : floats) putXor(payload, bitsOf(v));
+
+    auto le = [](std::vector<unsigned char>& out, quint64 v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    };
+    std::vector<unsigned char> file = {'S', 'Y', 'S', 'M', 'R', 'E', 'C', '1'};
+    le(file, 1, 4);
+    le(file, 13, 4);
+    le(file, 0x4B4E4843, 4);
+    le(file, 1, 4);
+    le(file, payload.size(), 4);
+    le(file, 0, 4);
+    le(file, quint64(s.timeMs), 8);
+    file.insert(file.end(), payload.begin(), payload.end());
+
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return;
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+}
+
+static void checkVersion1(const std::string& path)
+{
+    const RecordedSample written = sampleAt(5);
+    writeV1(path, written);
+
+    RecordingReader reader;
+    expect(reader.open(path), "open version 1 recording");
+    RecordedSample s;
+    RecordingReader::Cursor cursor = reader.cursor();
+    expect(cursor.next(s), "read version 1 sample");
+    std::printf("version 1: available %llu (expected %llu), committed %llu\n",
+                (unsigned long long)s.mem.available, (unsigned long long)written.mem.available,
+                (unsigned long long)s.mem.committed);
+    expect(s.mem.used == written.mem.used && s.mem.available == written.mem.available,
+           "version 1 available derived from total - used");
+    expect(s.mem.committed == 0 && s.mem.commitLimit == 0, "version 1 commit charge reads as 0");
+    reader.close();
+
+    RecordingWriter writer;
+    expect(!writer.open(path), "writer refuses to append to a version 1 file");
+}
+
+int main(int argc, char* argv[])
+{
+    const int samples = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (samples < 1) {
+        std::fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+        return 2;
+    }
+
+    const char* tmp = std::getenv("TMPDIR");
+    const std::string base = std::string(tmp && *tmp ? tmp : "/tmp") + "/check_recording."
+                           + std::to_string(::getpid());
+    checkRoundTrip(base + ".v2", samples);
+    checkVersion1(base + ".v1");
+    ::unlink((base + ".v2").c_str());
+    ::unlink((base + ".v1").c_str());
+
+    std::printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,326 @@
+// sysmon_bench.cpp
+// Latency and allocation benchmark for every Linux collector, run against
+// synthetic procfs/sysfs trees (FakeSysTree) so results do not depend on the
+// machine. Each tree is built once per (cores, pids) pair; every collector is
+// timed call by call and reported as percentiles plus heap allocations per
+// call. Output is one JSON document.
+//
+//   sysmon_bench [--cores 4,64,512] [--pids 100,10000,100000]
+//                [--hwmon none|coretemp|k10temp|mixed] [--packages N]
+//                [--cgroups N] [--interfaces N] [--disks N] [--iterations N] [--out file.json] [--root dir] [--keep]
+#include <bench/FakeSysTree.h>
+#include <core/MetricsExporter.h>
+#include <platform/linux/CgroupCollector.h>
+#include <platform/linux/DiskStatsReader.h>
+#include <platform/linux/LinuxSystemMonitor.h>
+#include <platform/linux/NetDevReader.h>
+#include <platform/linux/ProcReaders.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// ----- allocation counting -----
+// Replacing the global operators counts every heap allocation in the
+// process, worker pool threads included.
+static std::atomic<unsigned long long> g_allocs{0};
+static std::atomic<unsigned long long> g_allocBytes{0};
+
+void* operator new(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// ----- measurement -----
+struct Result {
+    std::string collector;
+    FakeTreeSpec tree;
+    int iterations = 0;
+    double meanUs = 0, p50Us = 0, p90Us = 0, p99Us = 0, maxUs = 0;
+    double allocsPerCall = 0;
+    double bytesPerCall = 0;
+};
+
+static double percentile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty()) return 0;
+    const std::size_t i = std::min(sorted.size() - 1, std::size_t(q * double(sorted.size() - 1) + 0.5));
+    return sorted[i];
+}
+
+static Result measure(const char* collector, const FakeTreeSpec& tree, int iterations,
+                      const std::function<void()>& fn)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Warm-up: first calls open descriptors, discover sensors, seed caches
+    for (int i = 0; i < 3; ++i) fn();
+
+    std::vector<double> samples(static_cast<std::size_t>(iterations));
+    const unsigned long long allocs0 = g_allocs.load();
+    const unsigned long long bytes0 = g_allocBytes.load();
+    for (int i = 0; i < iterations; ++i) {
+        const auto t0 = clock::now();
+        fn();
+        const auto t1 = clock::now();
+        samples[std::size_t(i)] = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }
+    const unsigned long long allocs = g_allocs.load() - allocs0;
+    const unsigned long long bytes = g_allocBytes.load() - bytes0;
+
+    Result r;
+    r.collector = collector;
+    r.tree = tree;
+    r.iterations = iterations;
+    double sum = 0;
+    for (double s : samples) sum += s;
+    std::sort(samples.begin(), samples.end());
+    r.meanUs = sum / iterations;
+    r.p50Us = percentile(samples, 0.50);
+    r.p90Us = percentile(samples, 0.90);
+    r.p99Us = percentile(samples, 0.99);
+    r.maxUs = samples.back();
+    r.allocsPerCall = double(allocs) / iterations;
+    r.bytesPerCall = double(bytes) / iterations;
+    return r;
+}
+
+// Process walks cost O(pids); keep their wall time per case bounded
+static int iterationsFor(int base, int pids)
+{
+    if (pids <= 0) return base;
+    return std::max(5, std::min(base, 2000000 / pids));
+}
+
+static void runTree(const FakeSysTree& fake, int baseIterations, std::vector<Result>& out)
+{
+    const FakeTreeSpec& spec = fake.spec();
+    const int pids = spec.pids;
+
+    // Whole collectors, as the sampling engine calls them
+    {
+        LinuxMonitorOptions options;
+        options.procRoot = fake.procRoot();
+        options.sysRoot = fake.sysRoot();
+        LinuxSystemMonitor monitor(options);
+
+        out.push_back(measure("LinuxSystemMonitor::getCpuStats", spec, baseIterations,
+                              [&] { CpuStats s = monitor.getCpuStats(); (void)s; }));
+        out.push_back(measure("LinuxSystemMonitor::getMemStats", spec, baseIterations,
+                              [&] { MemStats s = monitor.getMemStats(); (void)s; }));
+        out.push_back(measure("LinuxSystemMonitor::getProcessThreadCount", spec,
+                              iterationsFor(baseIterations, pids),
+                              [&] { ProcessThreadTotals t = monitor.getProcessThreadCount(); (void)t; }));
+        out.push_back(measure("LinuxSystemMonitor::getProcessTable", spec,
+                              iterationsFor(baseIterations, pids),
+                              [&] { ProcessTable t = monitor.getProcessTable(); (void)t; }));
+
+        // Re-rendering the exporter sections from a fixed snapshot; once
+        // warmed up this should not touch the heap
+        const CpuStats cpu = monitor.getCpuStats();
+        const MemStats mem = monitor.getMemStats();
+        // The built-in collector names fit the small-string buffer; a longer
+        // one shows whether rendering converts names per call
+        SelfStats self = monitor.getSelfStats();
+        self.collectors.push_back(self.collectors.front());
+        self.collectors.back().name = QString::fromUtf8("process.table.cgroup.pressure");
+        MetricsExporter exporter;
+        out.push_back(measure("MetricsExporter::updateCpu", spec, baseIterations, [&] { exporter.updateCpu(cpu); }));
+        out.push_back(measure("MetricsExporter::updateMem", spec, baseIterations, [&] { exporter.updateMem(mem); }));
+        out.push_back(measure("MetricsExporter::updateSelf", spec, baseIterations, [&] { exporter.updateSelf(self); }));
+    }
+
+    // The building blocks behind the static helpers in LinuxSystemMonitor.cpp
+    {
+        ProcFile procStat(fake.procRoot() + "/stat", 64 * 1024);
+        ProcFile meminfo(fake.procRoot() + "/meminfo", 8 * 1024);
+        CpuJiffies jiffies;
+        CpuUsageSampler sampler;
+        CpuStats cpu;
+        MemStats mem{};
+
+        out.push_back(measure("parseCpuJiffies", spec, baseIterations,
+                              [&] { parseCpuJiffies(procStat.read(), jiffies); }));
+        out.push_back(measure("CpuUsageSampler::sample", spec, baseIterations,
+                              [&] { sampler.sample(procStat.read(), cpu); }));
+        out.push_back(measure("parseMemInfo", spec, baseIterations,
+                              [&] { parseMemInfo(meminfo.read(), mem); }));
+    }
+    {
+        CpuFreqReader freq(fake.sysRoot() + "/devices/system/cpu", fake.procRoot() + "/cpuinfo");
+        out.push_back(measure("CpuFreqReader::read", spec, baseIterations,
+                              [&] { CpuCoresStats s = freq.read(); (void)s; }));
+    }
+    {
+        HwmonSensors hwmon(fake.sysRoot() + "/class/hwmon");
+        out.push_back(measure("HwmonSensors::read", spec, baseIterations,
+                              [&] { CpuTemperatures t = hwmon.read(); (void)t; }));
+        out.push_back(measure("HwmonSensors::refresh+read", spec, std::max(5, baseIterations / 10),
+                              [&] { hwmon.refresh(); CpuTemperatures t = hwmon.read(); (void)t; }));
+    }
+    {
+        ProcScanner serial(fake.procRoot(), 1);
+        ProcScanner pooled(fake.procRoot(), 0);
+        ProcessTableCache table(pooled);
+        ProcessTableCache topTable(pooled);
+        std::vector<int> list;
+
+        out.push_back(measure("ProcScanner::listPids", spec, iterationsFor(baseIterations, pids),
+                              [&] { serial.listPids(list); }));
+        out.push_back(measure("ProcScanner::scanTotals(serial)", spec, iterationsFor(baseIterations, pids),
+                              [&] { ProcessThreadTotals t = serial.scanTotals(); (void)t; }));
+        out.push_back(measure("ProcScanner::scanTotals(pool)", spec, iterationsFor(baseIterations, pids),
+                              [&] { ProcessThreadTotals t = pooled.scanTotals(); (void)t; }));
+        out.push_back(measure("ProcessTableCache::refresh", spec, iterationsFor(baseIterations, pids),
+                              [&] { ProcessTable t = table.refresh(); (void)t; }));
+        out.push_back(measure("ProcessTableCache::top(20)", spec, iterationsFor(baseIterations, pids),
+                              [&] { TopProcesses t = topTable.top(20, ProcessSortKey::Cpu); (void)t; }));
+    }
+    {
+        NetDevReader net(fake.procRoot(), fake.sysRoot());
+        DiskStatsReader disks(fake.procRoot(), fake.sysRoot());
+        out.push_back(measure("NetDevReader::read", spec, iterationsFor(baseIterations, spec.interfaces),
+                              [&] { NetStats s = net.read(); (void)s; }));
+        out.push_back(measure("DiskStatsReader::read", spec, iterationsFor(baseIterations, spec.disks * 3),
+                              [&] { DiskStats s = disks.read(); (void)s; }));
+    }
+    if (spec.cgroups > 0) {
+        CgroupCollector serial(fake.sysRoot() + "/fs/cgroup");
+        CgroupCollector pooled(fake.sysRoot() + "/fs/cgroup", 3);
+        out.push_back(measure("CgroupCollector::read(serial)", spec, iterationsFor(baseIterations, spec.cgroups * 5),
+                              [&] { CgroupTable t = serial.read(); (void)t; }));
+        out.push_back(measure("CgroupCollector::read(pool)", spec, iterationsFor(baseIterations, spec.cgroups * 5),
+                              [&] { CgroupTable t = pooled.read(); (void)t; }));
+    }
+}
+
+// ----- output -----
+static void writeJson(std::FILE* f, const std::vector<Result>& results)
+{
+    std::fprintf(f, "{\n  \"benchmark\": \"sysmon_bench\",\n  \"hardwareThreads\": %ld,\n  \"results\": [\n",
+                 ::sysconf(_SC_NPROCESSORS_ONLN));
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(f,
+                     "    {\"collector\": \"%s\", \"cores\": %d, \"pids\": %d, \"cgroups\": %d, \"interfaces\": %d, \"disks\": %d, \"hwmon\": \"%s\", \"packages\": %d, "
+                     "\"iterations\": %d, \"meanUs\": %.3f, \"p50Us\": %.3f, \"p90Us\": %.3f, \"p99Us\": %.3f, "
+                     "\"maxUs\": %.3f, \"allocsPerCall\": %.2f, \"allocBytesPerCall\": %.1f}%s\n",
+                     r.collector.c_str(), r.tree.cores, r.tree.pids, r.tree.cgroups, r.tree.interfaces, r.tree.disks,
+                     hwmonLayoutName(r.tree.hwmon), r.tree.packages,
+                     r.iterations, r.meanUs, r.p50Us, r.p90Us, r.p99Us, r.maxUs, r.allocsPerCall, r.bytesPerCall,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+static std::vector<int> parseIntList(const char* s)
+{
+    std::vector<int> out;
+    while (*s) {
+        char* end = nullptr;
+        const long v = std::strtol(s, &end, 10);
+        if (end == s) break;
+        if (v > 0) out.push_back(int(v));
+        s = *end == ',' ? end + 1 : end;
+    }
+    return out;
+}
+
+static int usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--cores 4,64,512] [--pids 100,10000,100000] [--hwmon none|coretemp|k10temp|mixed]\n"
+                 "       [--packages N] [--cgroups N] [--interfaces N] [--disks N] [--iterations N] [--out file.json] [--root dir] [--keep]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> cores{4, 64, 512};
+    std::vector<int> pids{100, 10000, 100000};
+    FakeTreeSpec base;
+    base.packages = 2;
+    int iterations = 200;
+    const char* outPath = nullptr;
+    std::string root;
+    bool keep = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--cores") && hasValue) cores = parseIntList(argv[++i]);
+        else if (!std::strcmp(arg, "--pids") && hasValue) pids = parseIntList(argv[++i]);
+        else if (!std::strcmp(arg, "--hwmon") && hasValue) {
+            if (!parseHwmonLayout(argv[++i], base.hwmon)) return usage(argv[0]);
+        }
+        else if (!std::strcmp(arg, "--packages") && hasValue) base.packages = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(arg, "--cgroups") && hasValue) base.cgroups = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(arg, "--interfaces") && hasValue) base.interfaces = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(arg, "--disks") && hasValue) base.disks = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(arg, "--iterations") && hasValue) iterations = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(arg, "--out") && hasValue) outPath = argv[++i];
+        else if (!std::strcmp(arg, "--root") && hasValue) root = argv[++i];
+        else if (!std::strcmp(arg, "--keep")) keep = true;
+        else return usage(argv[0]);
+    }
+    if (cores.empty() || pids.empty()) return usage(argv[0]);
+
+    if (root.empty()) {
+        char tmpl[] = "/tmp/sysmon-bench-XXXXXX";
+        const char* dir = mkdtemp(tmpl);
+        if (!dir) { std::perror("mkdtemp"); return 1; }
+        root = dir;
+    }
+
+    std::vector<Result> results;
+    try {
+        FakeSysTree fake(root);
+        for (int pidCount : pids) {
+            FakeTreeSpec spec = base;
+            spec.cores = cores.front();
+            spec.pids = pidCount;
+            std::fprintf(stderr, "building tree: %d pids\n", pidCount);
+            fake.build(spec);
+            for (int coreCount : cores) {
+                fake.setCores(coreCount);
+                std::fprintf(stderr, "  %d cores, %d pids, hwmon %s\n",
+                             coreCount, pidCount, hwmonLayoutName(base.hwmon));
+                runTree(fake, iterations, results);
+            }
+        }
+        if (!keep) fake.remove();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::FILE* f = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!f) { std::perror(outPath); return 1; }
+    writeJson(f, results);
+    if (f != stdout) std::fclose(f);
+    return 0;
+}
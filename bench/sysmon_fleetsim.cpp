@@ -0,0 +1,200 @@
+// sysmon_fleetsim.cpp
+// Simulates a fleet of agents on one machine: N StreamAgents, each with its
+// own connection and a seeded random walk of CPU, memory and process values,
+// stream one sample per interval. Without --target an in-process
+// StreamAggregator listens on a free local port (or --unix path), and the
+// run ends by checking that every sample arrived and that the last rollup
+// saw every node. Prints one JSON object.
+//
+//   sysmon_fleetsim [--agents N] [--interval-ms N] [--seconds N] [--target host:port|unix:path]
+//                   [--unix path] [--seed N]
+#include <core/StreamAgent.h>
+#include <platform/linux/StreamAggregator.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+static int usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--agents N] [--interval-ms N] [--seconds N] [--target host:port|unix:path]\n"
+                 "       [--unix path] [--seed N]\n"
+                 "\n"
+                 "  --agents N       simulated nodes, one connection each (default 1000)\n"
+                 "  --interval-ms N  sample interval of every agent (default 1000)\n"
+                 "  --seconds N      run time (default 10)\n"
+                 "  --target         stream to a running sysmon_aggregator instead of an in-process one\n"
+                 "  --unix path      in-process aggregator listens on a Unix socket instead of TCP\n", argv0);
+    return 2;
+}
+
+static double cpuSeconds()
+{
+    rusage ru{};
+    ::getrusage(RUSAGE_SELF, &ru);
+    return double(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) + double(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+struct SimNode {
+    std::unique_ptr<StreamAgent> agent;
+    RecordedSample sample;
+};
+
+int main(int argc, char* argv[])
+{
+    int agents = 1000;
+    int intervalMs = 1000;
+    int seconds = 10;
+    std::string target;
+    std::string unixPath;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--agents") && hasValue) agents = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--interval-ms") && hasValue) intervalMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--seconds") && hasValue) seconds = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--target") && hasValue) target = argv[++i];
+        else if (!std::strcmp(arg, "--unix") && hasValue) unixPath = argv[++i];
+        else if (!std::strcmp(arg, "--seed") && hasValue) seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else return usage(argv[0]);
+    }
+    if (agents < 1 || intervalMs < 1 || seconds < 1) return usage(argv[0]);
+
+    // Two descriptors per agent when the aggregator runs in this process
+    rlimit rl{};
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &rl);
+        if (rl.rlim_cur < rlim_t(agents) * 2 + 64)
+            std::fprintf(stderr, "warning: RLIMIT_NOFILE %llu is too low for %d agents\n",
+                         static_cast<unsigned long long>(rl.rlim_cur), agents);
+    }
+
+    std::unique_ptr<StreamAggregator> aggregator;
+    if (target.empty()) {
+        StreamAggregatorOptions options;
+        options.rollupIntervalMs = std::max(100, intervalMs / 2);
+        options.staleMs = qint64(intervalMs) * 3;
+        aggregator = std::make_unique<StreamAggregator>(options);
+        if (!aggregator->start(unixPath.empty() ? "127.0.0.1:0" : "unix:" + unixPath)) {
+            std::fprintf(stderr, "cannot start the aggregator\n");
+            return 1;
+        }
+        target = unixPath.empty() ? "127.0.0.1:" + std::to_string(aggregator->port()) : "unix:" + unixPath;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<SimNode> nodes(static_cast<std::size_t>(agents));
+    for (int i = 0; i < agents; ++i) {
+        SimNode& n = nodes[std::size_t(i)];
+        n.agent = std::make_unique<StreamAgent>("node-" + std::to_string(i));
+        if (!n.agent->open(target)) {
+            std::fprintf(stderr, "bad target %s\n", target.c_str());
+            return usage(argv[0]);
+        }
+        RecordedSample& s = n.sample;
+        s.cpu.cores.totalCores = 8 << (i % 4);
+        s.cpu.cpuUsage = unit(rng) * 100;
+        s.cpu.cpuClock = 2000 + 1000 * unit(rng);
+        s.cpu.cpuTemperature = s.cpu.temperatures.max = 40 + 30 * unit(rng);
+        s.mem.total = quint64(16 + 16 * (i % 8)) << 30;
+        s.mem.used = quint64(double(s.mem.total) * unit(rng));
+        s.mem.available = s.mem.total - s.mem.used;
+        s.processes.processCount = 200 + int(800 * unit(rng));
+        s.processes.threadCount = s.processes.processCount * 4;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const double cpuStart = cpuSeconds();
+    const int ticks = seconds * 1000 / intervalMs;
+    double sendSeconds = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        const auto due = start + std::chrono::milliseconds(qint64(tick) * intervalMs);
+        std::this_thread::sleep_until(due);
+        const qint64 nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch()).count();
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (SimNode& n : nodes) {
+            RecordedSample& s = n.sample;
+            s.timeMs = nowMs;
+            s.cpu.cpuUsage = std::clamp(s.cpu.cpuUsage + (unit(rng) - 0.5) * 10, 0.0, 100.0);
+            s.cpu.cpuTimes.user = s.cpu.cpuUsage * 0.7;
+            s.cpu.cpuTimes.system = s.cpu.cpuUsage * 0.3;
+            s.cpu.cpuTimes.iowait = unit(rng) < 0.9 ? 0.0 : unit(rng) * 20;
+            const qint64 step = qint64((unit(rng) - 0.5) * 64) << 20;
+            s.mem.used = quint64(std::clamp<qint64>(qint64(s.mem.used) + step, 0, qint64(s.mem.total)));
+            s.mem.available = s.mem.total - s.mem.used;
+            s.processes.processCount += int(unit(rng) * 5) - 2;
+            s.processes.threadCount = s.processes.processCount * 4;
+            n.agent->send(s);
+        }
+        sendSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    quint64 sent = 0, dropped = 0, bytes = 0;
+    int connected = 0;
+    for (const SimNode& n : nodes) {
+        sent += n.agent->samplesSent();
+        dropped += n.agent->samplesDropped();
+        bytes += n.agent->bytesSent();
+        connected += n.agent->isConnected();
+    }
+
+    // Let the aggregator catch up, then take a rollup that saw the last tick
+    quint64 received = 0;
+    int reporting = -1;
+    double p50 = 0;
+    if (aggregator) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (aggregator->samples() < sent && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const quint64 seq = aggregator->rollup() ? aggregator->rollup()->sequence : 0;
+        while ((!aggregator->rollup() || aggregator->rollup()->sequence == seq)
+               && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        received = aggregator->samples();
+        if (auto r = aggregator->rollup()) {
+            reporting = r->value.reporting;
+            p50 = r->value.metrics.front().p50;
+        }
+    }
+    const double cpu = cpuSeconds() - cpuStart;
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Ground truth for the rollup's cpu.usage median (nearest rank)
+    std::vector<double> usage;
+    for (const SimNode& n : nodes) usage.push_back(n.sample.cpu.cpuUsage);
+    std::nth_element(usage.begin(), usage.begin() + (agents + 1) / 2 - 1, usage.end());
+    const double trueP50 = usage[std::size_t((agents + 1) / 2 - 1)];
+
+    std::printf("{\n");
+    std::printf("  \"agents\": %d, \"connected\": %d, \"interval_ms\": %d, \"seconds\": %d,\n", agents, connected,
+                intervalMs, seconds);
+    std::printf("  \"sent\": %llu, \"dropped\": %llu, \"bytes_per_sample\": %.1f,\n",
+                static_cast<unsigned long long>(sent), static_cast<unsigned long long>(dropped),
+                sent ? double(bytes) / double(sent) : 0.0);
+    std::printf("  \"send_us_per_sample\": %.2f, \"cpu_seconds\": %.2f, \"wall_seconds\": %.2f",
+                sent ? sendSeconds * 1e6 / double(sent + dropped) : 0.0, cpu, wall);
+    if (aggregator) {
+        std::printf(",\n  \"received\": %llu, \"reporting\": %d, \"cpu_p50\": %.3f, \"cpu_p50_expected\": %.3f",
+                    static_cast<unsigned long long>(received), reporting, p50, trueP50);
+    }
+    std::printf("\n}\n");
+
+    const bool ok = !aggregator || (received == sent && reporting == connected);
+    for (SimNode& n : nodes) n.agent->close();
+    if (aggregator) aggregator->stop();
+    return ok ? 0 : 1;
+}
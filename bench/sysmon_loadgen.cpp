@@ -0,0 +1,120 @@
+// sysmon_loadgen.cpp
+// Builds a synthetic procfs/sysfs tree and keeps mutating it: PIDs exit and
+// spawn, CPU, per-process, network and disk counters advance, temperatures
+// drift and CPUs go on and offline. Point statsTest (--proc-root/--sys-root) or any
+// LinuxSystemMonitor at it to load-test the collectors at production scale.
+// All changes come from a seeded PRNG, so a run is reproducible.
+//
+//   sysmon_loadgen --root dir [--cores N] [--pids N] [--hwmon none|coretemp|k10temp|mixed]
+//                  [--packages N] [--cgroups N] [--interfaces N] [--disks N] [--interval-ms N]
+//                  [--churn N] [--busy N] [--hotplug-every N] [--ticks N] [--seed N] [--cleanup]
+#include <bench/FakeSysTree.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static std::atomic<bool> g_stop{false};
+
+static void onSignal(int)
+{
+    g_stop = true;
+}
+
+static int usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s --root dir [--cores N] [--pids N] [--hwmon none|coretemp|k10temp|mixed]\n"
+                 "       [--packages N] [--cgroups N] [--interfaces N] [--disks N] [--interval-ms N] [--churn N]\n"
+                 "       [--busy N] [--hotplug-every N] [--ticks N] [--seed N] [--cleanup]\n"
+                 "\n"
+                 "  --churn N          PIDs that exit and spawn per tick (default pids/100)\n"
+                 "  --busy N           processes charged CPU time per tick (default pids/20)\n"
+                 "  --hotplug-every N  toggle a random CPU every N ticks, 0 = never (default 10)\n"
+                 "  --ticks N          stop after N ticks, 0 = until SIGINT/SIGTERM (default 0)\n"
+                 "  --cleanup          delete the tree on exit\n", argv0);
+    return 2;
+}
+
+int main(int argc, char* argv[])
+{
+    FakeTreeSpec spec;
+    spec.cores = 64;
+    spec.pids = 20000;
+    spec.packages = 2;
+    std::string root;
+    int intervalMs = 1000;
+    int churn = -1;
+    int busy = -1;
+    int hotplugEvery = 10;
+    long ticks = 0;
+    unsigned seed = 1;
+    bool cleanup = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--root") && hasValue) root = argv[++i];
+        else if (!std::strcmp(arg, "--cores") && hasValue) spec.cores = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--pids") && hasValue) spec.pids = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--hwmon") && hasValue) {
+            if (!parseHwmonLayout(argv[++i], spec.hwmon)) return usage(argv[0]);
+        }
+        else if (!std::strcmp(arg, "--packages") && hasValue) spec.packages = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--cgroups") && hasValue) spec.cgroups = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--interfaces") && hasValue) spec.interfaces = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--disks") && hasValue) spec.disks = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--interval-ms") && hasValue) intervalMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--churn") && hasValue) churn = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--busy") && hasValue) busy = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--hotplug-every") && hasValue) hotplugEvery = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--ticks") && hasValue) ticks = std::atol(argv[++i]);
+        else if (!std::strcmp(arg, "--seed") && hasValue) seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(arg, "--cleanup")) cleanup = true;
+        else return usage(argv[0]);
+    }
+    if (root.empty() || spec.cores < 1 || spec.pids < 0) return usage(argv[0]);
+    if (churn < 0) churn = spec.pids / 100;
+    if (busy < 0) busy = spec.pids / 20;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    try {
+        FakeSysTree fake(root, seed);
+        fake.build(spec);
+        std::printf("proc root: %s\nsys root:  %s\n", fake.procRoot().c_str(), fake.sysRoot().c_str());
+        std::fflush(stdout);
+
+        // One tick advances the counters by as many jiffies (USER_HZ = 100)
+        // as the interval lasts in real time
+        const int jiffiesPerTick = std::max(1, intervalMs / 10);
+        auto next = std::chrono::steady_clock::now();
+        for (long tick = 1; !g_stop && (ticks == 0 || tick <= ticks); ++tick) {
+            const auto t0 = std::chrono::steady_clock::now();
+            fake.churn(churn, churn);
+            fake.advance(jiffiesPerTick, busy);
+            int toggled = -1;
+            if (hotplugEvery > 0 && tick % hotplugEvery == 0) toggled = fake.toggleRandomCpu();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            std::fprintf(stderr, "tick %ld: %d pids, %d/%d cpus online%s%s, mutation %.1f ms\n",
+                         tick, fake.spec().pids, fake.onlineCount(), fake.spec().cores,
+                         toggled >= 0 ? ", toggled cpu" : "",
+                         toggled >= 0 ? std::to_string(toggled).c_str() : "", ms);
+
+            next += std::chrono::milliseconds(intervalMs);
+            std::this_thread::sleep_until(next);
+        }
+
+        if (cleanup) fake.remove();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
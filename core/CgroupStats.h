@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
+
+// ----- Per-cgroup view (cgroup v2) -----
+// Counters are cumulative; rates cover the interval since the previous
+// table and are 0 for a group seen for the first time. Fields whose
+// controller is not enabled for the group stay 0.
+struct CgroupStats {
+    QString path;                   // relative to the cgroup root; "/" is the root
+    quint64 id = 0;                 // cgroup id (directory inode), stable while the group lives
+
+    // cpu.stat
+    quint64 cpuUsageUs = 0;
+    quint64 cpuUserUs = 0;
+    quint64 cpuSystemUs = 0;
+    quint64 nrThrottled = 0;
+    quint64 throttledUs = 0;
+    double cpuPercent = 0;          // 100 = one full core
+    double throttledPercent = 0;    // share of the interval spent throttled
+
+    // memory.current, memory.stat
+    quint64 memoryCurrent = 0;
+    quint64 memoryAnon = 0;
+    quint64 memoryFile = 0;
+    quint64 memoryKernel = 0;
+    quint64 memoryShmem = 0;
+    quint64 memorySock = 0;
+    quint64 pgMajFault = 0;
+    double pgMajFaultPerSec = 0;
+
+    // io.stat, summed over devices
+    quint64 ioReadBytes = 0;
+    quint64 ioWriteBytes = 0;
+    quint64 ioReadOps = 0;
+    quint64 ioWriteOps = 0;
+    double ioReadBytesPerSec = 0;
+    double ioWriteBytesPerSec = 0;
+    double ioReadOpsPerSec = 0;
+    double ioWriteOpsPerSec = 0;
+
+    // pids.current
+    quint64 pids = 0;
+};
+
+struct CgroupTable {
+    std::vector<CgroupStats> groups;    // parents before their children
+    std::vector<QString> added;         // paths that appeared since the previous table
+    std::vector<QString> removed;       // paths that went away since the previous table
+    double intervalSeconds = 0;         // 0 on the first table
+};
@@ -1,18 +1,55 @@
 #pragma once
 
 #include <QString>
-#include <map>
+#include <vector>
 
 struct CpuCoresStats {
-    qint8 totalCores = 0;
+    qint32 totalCores = 0;
     double averageFreq = 0;
-    std::map<int, double> coresMap = {};
+    std::vector<double> coreFreq = {};  // MHz, index = CPU id; 0 if offline/unknown
+};
+
+// Share of CPU time (percent) per /proc/stat category over one interval
+struct CpuTimeShares {
+    double user = 0, nice = 0, system = 0, idle = 0;
+    double iowait = 0, irq = 0, softirq = 0, steal = 0;
+};
+
+// Per-CPU utilization as a structure of arrays: element i of every vector
+// belongs to cpuId[i]. Values are percent of that CPU's time.
+struct CpuUtilization {
+    std::vector<int> cpuId = {};
+    std::vector<double> usage = {};     // everything but idle and iowait
+    std::vector<double> user = {}, nice = {}, system = {}, idle = {};
+    std::vector<double> iowait = {}, irq = {}, softirq = {}, steal = {};
+};
+
+struct CpuTemperatureSensor {
+    QString chip;               // hwmon driver name, e.g. "coretemp"
+    QString label;              // e.g. "Package id 0", "Core 3", "Tctl"
+    double celsius = -1;
+};
+
+struct CoreTemperature {
+    qint16 package = 0;
+    qint16 core = 0;
+    double celsius = -1;
+};
+
+struct CpuTemperatures {
+    double max = -1;                            // -1 if no sensor
+    std::vector<double> packages = {};          // index = package id, -1 if unknown
+    std::vector<CoreTemperature> cores = {};
+    std::vector<CpuTemperatureSensor> sensors = {}; // every CPU sensor read
 };
 
 struct CpuStats {
-    double cpuUsage = 0;
+    double cpuUsage = 0;                        // all CPUs, everything but idle and iowait
+    CpuTimeShares cpuTimes = {};                // all CPUs, per category
+    CpuUtilization perCore = {};
     double cpuClock = 0;
     CpuCoresStats cores = {};
-    double cpuTemperature = 0;
+    double cpuTemperature = 0;                  // package 0 (or first sensor), -1 if N/A
+    CpuTemperatures temperatures = {};
 };
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <cstring>
+#include <vector>
+
+// Byte-aligned integer and floating-point delta coding shared by recordings
+// and the agent stream: zigzag varints for integer deltas, and doubles XORed
+// with their previous value stored as (leading zero bytes, meaningful bytes).
+namespace deltacodec {
+
+inline quint64 zigzag(qint64 v) { return (quint64(v) << 1) ^ quint64(v >> 63); }
+inline qint64 unzigzag(quint64 v) { return qint64(v >> 1) ^ -qint64(v & 1); }
+
+// Two's complement wrap-around instead of signed overflow: decoded deltas
+// come from files and sockets and may be anything. wrappingAdd(a,
+// wrappingSub(b, a)) == b for every pair, so encoders use the same.
+inline qint64 wrappingAdd(qint64 a, qint64 b) { return qint64(quint64(a) + quint64(b)); }
+inline qint64 wrappingSub(qint64 a, qint64 b) { return qint64(quint64(a) - quint64(b)); }
+
+inline quint64 bitsOf(double d) { quint64 b; std::memcpy(&b, &d, sizeof(b)); return b; }
+inline double doubleOf(quint64 b) { double d; std::memcpy(&d, &b, sizeof(d)); return d; }
+
+inline void putVarint(std::vector<unsigned char>& out, quint64 v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(v));
+}
+
+inline bool getVarint(const unsigned char*& p, const unsigned char* end, quint64& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const unsigned char b = *p++;
+        v |= quint64(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// XOR with the previous value: 0x00 if unchanged, else a header byte
+// (leading zero bytes << 4 | meaningful bytes) and the meaningful bytes
+inline void putXor(std::vector<unsigned char>& out, quint64 x)
+{
+    if (x == 0) {
+        out.push_back(0);
+        return;
+    }
+    int lead = 0, trail = 0;
+    while ((x >> (56 - 8 * lead)) == 0) ++lead;          // x != 0, so this stops
+    while (((x >> (8 * trail)) & 0xFF) == 0) ++trail;
+    const int meaningful = 8 - lead - trail;
+    out.push_back(static_cast<unsigned char>((lead << 4) | meaningful));
+    const quint64 m = x >> (trail * 8);
+    for (int i = meaningful - 1; i >= 0; --i) out.push_back(static_cast<unsigned char>(m >> (i * 8)));
+}
+
+inline bool getXor(const unsigned char*& p, const unsigned char* end, quint64& x)
+{
+    if (p >= end) return false;
+    const unsigned char h = *p++;
+    x = 0;
+    if (h == 0) return true;
+    const int lead = h >> 4;
+    const int meaningful = h & 0x0F;
+    if (meaningful == 0 || lead + meaningful > 8 || end - p < meaningful) return false;
+    quint64 m = 0;
+    for (int i = 0; i < meaningful; ++i) m = (m << 8) | *p++;
+    x = m << ((8 - lead - meaningful) * 8);
+    return true;
+}
+
+} // namespace deltacodec
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
+
+// ----- Block devices -----
+// Counters are cumulative since boot (bytes, operations, milliseconds);
+// rates cover the interval since the previous call and are 0 on the first
+// call and for a device seen for the first time.
+struct DiskDeviceStats {
+    QString name;                   // "nvme0n1", "sda1", ...
+    qint32 index = -1;              // stable for the monitor's lifetime, even if the device comes back
+    quint32 major = 0;
+    quint32 minor = 0;
+    bool partition = false;
+
+    quint64 reads = 0;
+    quint64 readBytes = 0;
+    quint64 readTimeMs = 0;
+    quint64 writes = 0;
+    quint64 writeBytes = 0;
+    quint64 writeTimeMs = 0;
+    quint64 inFlight = 0;           // requests in progress right now
+    quint64 ioTimeMs = 0;           // time with at least one request in flight
+
+    double readBytesPerSec = 0;
+    double writeBytesPerSec = 0;
+    double readIops = 0;
+    double writeIops = 0;
+    double utilization = 0;         // percent of the interval the device was busy
+    double readLatencyMs = 0;       // average per read completed in the interval
+    double writeLatencyMs = 0;
+    double queueDepth = 0;          // average requests in flight
+};
+
+struct DiskStats {
+    std::vector<DiskDeviceStats> devices;   // in /proc/diskstats order
+    double intervalSeconds = 0;             // 0 on the first call
+};
@@ -0,0 +1,126 @@
+#include <core/FleetRollup.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+constexpr std::array<const char*, FleetTable::kMetrics> kNames = {
+    "cpu.usage", "cpu.iowait", "cpu.steal", "cpu.clock", "cpu.temperature.max",
+    "mem.usedPercent", "mem.used", "mem.available", "mem.swapUsed",
+    "proc.count", "proc.threads",
+};
+
+void extract(const RecordedSample& s, double* v)
+{
+    v[0] = s.cpu.cpuUsage;
+    v[1] = s.cpu.cpuTimes.iowait;
+    v[2] = s.cpu.cpuTimes.steal;
+    v[3] = s.cpu.cpuClock > 0 ? s.cpu.cpuClock : kNaN;
+    v[4] = s.cpu.temperatures.max >= 0 ? s.cpu.temperatures.max : kNaN;
+    v[5] = s.mem.total ? double(s.mem.used) / double(s.mem.total) * 100.0 : kNaN;
+    v[6] = double(s.mem.used);
+    v[7] = double(s.mem.available);
+    v[8] = double(s.mem.swapUsed);
+    v[9] = double(s.processes.processCount);
+    v[10] = double(s.processes.threadCount);
+}
+
+} // namespace
+
+const std::array<const char*, FleetTable::kMetrics>& FleetTable::metricNames()
+{
+    return kNames;
+}
+
+int FleetTable::addNode(std::string name)
+{
+    int node;
+    if (!m_free.empty()) {
+        node = m_free.back();
+        m_free.pop_back();
+        m_names[std::size_t(node)] = std::move(name);
+    } else {
+        node = int(m_names.size());
+        m_names.push_back(std::move(name));
+        m_updatedMs.push_back(0);
+        m_live.push_back(false);
+        for (auto& column : m_columns) column.push_back(kNaN);
+    }
+    m_updatedMs[std::size_t(node)] = 0;
+    m_live[std::size_t(node)] = true;
+    return node;
+}
+
+void FleetTable::removeNode(int node)
+{
+    const std::size_t i = std::size_t(node);
+    m_live[i] = false;
+    m_updatedMs[i] = 0;
+    m_names[i].clear();
+    for (auto& column : m_columns) column[i] = kNaN;
+    m_free.push_back(node);
+}
+
+void FleetTable::update(int node, const RecordedSample& sample, qint64 receivedMs)
+{
+    double v[kMetrics];
+    extract(sample, v);
+    const std::size_t i = std::size_t(node);
+    for (std::size_t m = 0; m < kMetrics; ++m) m_columns[m][i] = v[m];
+    m_updatedMs[i] = receivedMs;
+}
+
+void FleetTable::rollup(qint64 nowMs, qint64 staleMs, FleetRollup& out)
+{
+    m_fresh.clear();
+    for (std::size_t i = 0; i < m_names.size(); ++i) {
+        if (m_live[i] && m_updatedMs[i] > 0 && m_updatedMs[i] > nowMs - staleMs) m_fresh.push_back(int(i));
+    }
+    out.nodes = int(nodeCount());
+    out.reporting = int(m_fresh.size());
+    out.metrics.resize(kMetrics);
+
+    for (std::size_t m = 0; m < kMetrics; ++m) {
+        const std::vector<double>& column = m_columns[m];
+        MetricRollup& r = out.metrics[m];
+        r = MetricRollup();
+        r.name = kNames[m];
+
+        m_scratch.clear();
+        for (int node : m_fresh) {
+            const double v = column[std::size_t(node)];
+            if (!std::isnan(v)) m_scratch.emplace_back(v, node);
+        }
+        if (m_scratch.empty()) continue;
+
+        double sum = 0;
+        auto maxIt = m_scratch.begin();
+        r.min = m_scratch.front().first;
+        for (auto it = m_scratch.begin(); it != m_scratch.end(); ++it) {
+            sum += it->first;
+            r.min = std::min(r.min, it->first);
+            if (it->first > maxIt->first) maxIt = it;
+        }
+        r.nodes = int(m_scratch.size());
+        r.sum = sum;
+        r.mean = sum / double(m_scratch.size());
+        r.max = maxIt->first;
+        r.maxNode = m_names[std::size_t(maxIt->second)];
+
+        // Ascending quantiles, each selection narrowed to the range above
+        // the previous one: O(n) overall
+        const double qs[3] = {0.50, 0.90, 0.99};
+        double* outs[3] = {&r.p50, &r.p90, &r.p99};
+        auto from = m_scratch.begin();
+        for (int q = 0; q < 3; ++q) {
+            const std::size_t rank = std::size_t(std::ceil(qs[q] * double(m_scratch.size())));
+            auto nth = m_scratch.begin() + std::ptrdiff_t(std::max<std::size_t>(rank, 1) - 1);
+            std::nth_element(from, nth, m_scratch.end());
+            *outs[q] = nth->first;
+            from = nth;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <core/Recording.h>
+#include <QtCore/qtypes.h>
+#include <array>
+#include <string>
+#include <vector>
+
+// Distribution of one metric across the nodes that report it
+struct MetricRollup {
+    const char* name = "";      // e.g. "cpu.usage", as in RuleEngine
+    int nodes = 0;              // nodes with a value; the rest are left out
+    double min = 0, max = 0, mean = 0, sum = 0;
+    double p50 = 0, p90 = 0, p99 = 0;   // nearest rank
+    std::string maxNode;        // a node holding max
+};
+
+struct FleetRollup {
+    int nodes = 0;              // connected agents
+    int reporting = 0;          // of those, with a fresh sample
+    quint64 samples = 0;        // received since start
+    quint64 bytes = 0;
+    quint64 protocolErrors = 0; // streams closed for a malformed frame
+    std::vector<MetricRollup> metrics;
+};
+
+// Latest sample of every node, stored as one column of doubles per metric
+// so a rollup walks contiguous memory. Node slots are reused after
+// removeNode(). Not thread-safe.
+class FleetTable {
+public:
+    static constexpr std::size_t kMetrics = 11;
+
+    // Metric names, in FleetRollup::metrics order
+    static const std::array<const char*, kMetrics>& metricNames();
+
+    int addNode(std::string name);
+    void removeNode(int node);
+    void rename(int node, std::string name) { m_names[std::size_t(node)] = std::move(name); }
+    void update(int node, const RecordedSample& sample, qint64 receivedMs);
+
+    std::size_t nodeCount() const { return m_names.size() - m_free.size(); }
+
+    // Fills out.nodes, out.reporting and out.metrics over the nodes updated
+    // after nowMs - staleMs
+    void rollup(qint64 nowMs, qint64 staleMs, FleetRollup& out);
+
+private:
+    std::vector<std::string> m_names;
+    std::vector<qint64> m_updatedMs;        // 0: no sample yet
+    std::vector<bool> m_live;
+    std::vector<int> m_free;
+    std::array<std::vector<double>, kMetrics> m_columns;    // NaN: unknown
+    std::vector<int> m_fresh;               // rollup scratch
+    std::vector<std::pair<double, int>> m_scratch;
+};
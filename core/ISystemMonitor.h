@@ -1,9 +1,50 @@
 #pragma once
 
 #include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "CgroupStats.h"
 #include "CpuStats.h"
+#include "DiskStats.h"
 #include "MemStats.h"
+#include "NetStats.h"
+#include "PressureStats.h"
 #include "ProcessStats.h"
+#include "SelfStats.h"
+#include "ThreadStats.h"
+
+// Fields a caller needs from a sample. Implementations skip the reads
+// behind everything not requested; those fields keep their defaults.
+namespace Metric {
+enum : quint32 {
+    CpuUsage       = 1u << 0,   // CpuStats::cpuUsage, cpuTimes
+    CpuPerCore     = 1u << 1,   // CpuStats::perCore
+    CpuFrequency   = 1u << 2,   // CpuStats::cpuClock, cores
+    CpuTemperature = 1u << 3,   // CpuStats::cpuTemperature, temperatures
+    Memory         = 1u << 4,   // MemStats
+    Processes      = 1u << 5,   // ProcessThreadTotals
+    Pressure       = 1u << 6,   // PressureStats
+    Disk           = 1u << 7,   // DiskStats
+    Network        = 1u << 8,   // NetStats
+
+    Cpu = CpuUsage | CpuPerCore | CpuFrequency | CpuTemperature,
+    All = Cpu | Memory | Processes | Pressure | Disk | Network
+};
+}
+using MetricMask = quint32;
+
+// Result of ISystemMonitor::getSnapshot(): every requested metric, collected
+// in one pass under one timestamp
+struct SystemSnapshot {
+    std::chrono::system_clock::time_point timestamp{};
+    MetricMask fields = 0;      // what was collected
+    CpuStats cpu;
+    MemStats mem;
+    ProcessThreadTotals processes;
+    PressureStats pressure;
+    DiskStats disk;
+    NetStats net;
+};
 
 
 class ISystemMonitor {
@@ -12,5 +53,81 @@ public:
     virtual CpuStats getCpuStats() = 0;
     virtual MemStats getMemStats() = 0;
     virtual ProcessThreadTotals getProcessThreadCount() = 0;
-};
 
+    // Only the CpuStats fields selected by the Metric::Cpu* bits.
+    // Implementations without a cheaper path collect everything.
+    virtual CpuStats getCpuStats(MetricMask fields)
+    {
+        (void)fields;
+        return getCpuStats();
+    }
+
+    virtual SystemSnapshot getSnapshot(MetricMask fields)
+    {
+        SystemSnapshot s;
+        s.timestamp = std::chrono::system_clock::now();
+        s.fields = fields & Metric::All;
+        if (fields & Metric::Cpu) s.cpu = getCpuStats(fields & Metric::Cpu);
+        if (fields & Metric::Memory) s.mem = getMemStats();
+        if (fields & Metric::Processes) s.processes = getProcessThreadCount();
+        if (fields & Metric::Pressure) s.pressure = getPressureStats();
+        if (fields & Metric::Disk) s.disk = getDiskStats();
+        if (fields & Metric::Network) s.net = getNetStats();
+        return s;
+    }
+
+    // CPU, memory and IO stall averages. Platforms without PSI report every
+    // resource as unavailable.
+    virtual PressureStats getPressureStats() { return {}; }
+
+    // Block device and network interface counters with rates against the
+    // previous call. Empty where not implemented.
+    virtual DiskStats getDiskStats() { return {}; }
+    virtual NetStats getNetStats() { return {}; }
+
+    // Per-process table with deltas against the previous call.
+    // Platforms without an implementation return an empty table.
+    virtual ProcessTable getProcessTable() { return {}; }
+
+    // The n heaviest processes by key, CPU% covering the interval since the
+    // previous call. The default ranks a whole getProcessTable().
+    virtual TopProcesses getTopProcesses(int n, ProcessSortKey key)
+    {
+        TopProcesses top;
+        top.key = key;
+        ProcessTable table = getProcessTable();
+        std::vector<ProcessInfo>& all = table.processes;
+        top.totals.processCount = qint32(all.size());
+        for (const ProcessInfo& p : all) top.totals.threadCount += p.threads;
+
+        const std::size_t keep = std::min(all.size(), std::size_t(std::max(0, n)));
+        std::partial_sort(all.begin(), all.begin() + std::ptrdiff_t(keep), all.end(),
+                          [key](const ProcessInfo& a, const ProcessInfo& b) { return processRanksAbove(a, b, key); });
+        all.resize(keep);
+        top.processes = std::move(all);
+        return top;
+    }
+
+    // Per-cgroup (container) usage with rates against the previous call.
+    // Empty without a cgroup v2 hierarchy.
+    virtual CgroupTable getCgroupTable() { return {}; }
+
+    // Per-thread CPU and scheduling stats of a chosen set of processes (the
+    // watch list). watchProcess() and unwatchProcess() may be called from any
+    // thread, concurrently with the other calls, so implementations must
+    // guard whatever they touch; changes take effect on the next
+    // getThreadTable(). An exited process is dropped from the list. Not
+    // implemented: nothing can be watched.
+    virtual bool watchProcess(qint32 pid)
+    {
+        (void)pid;
+        return false;
+    }
+    virtual void unwatchProcess(qint32 pid) { (void)pid; }
+    virtual ThreadTable getThreadTable() { return {}; }
+
+    // What collecting has cost so far: per-collector latency percentiles,
+    // syscalls and bytes read. Empty where the collectors are not
+    // instrumented.
+    virtual SelfStats getSelfStats() { return {}; }
+};
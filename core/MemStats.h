@@ -4,10 +4,41 @@
 
 
 // ----- RAM -----
+// Every /proc/meminfo field, in bytes except the HugePages_* counts. Zero
+// where the kernel (or the platform) does not report the field.
+struct MemInfo {
+    quint64 memTotal = 0, memFree = 0, memAvailable = 0;
+    quint64 buffers = 0, cached = 0, swapCached = 0;
+    quint64 active = 0, inactive = 0;
+    quint64 activeAnon = 0, inactiveAnon = 0, activeFile = 0, inactiveFile = 0;
+    quint64 unevictable = 0, mlocked = 0;
+    quint64 swapTotal = 0, swapFree = 0, zswap = 0, zswapped = 0;
+    quint64 dirty = 0, writeback = 0;
+    quint64 anonPages = 0, mapped = 0, shmem = 0;
+    quint64 kReclaimable = 0, slab = 0, sReclaimable = 0, sUnreclaim = 0;
+    quint64 kernelStack = 0, shadowCallStack = 0, pageTables = 0, secPageTables = 0;
+    quint64 nfsUnstable = 0, bounce = 0, writebackTmp = 0;
+    quint64 commitLimit = 0, committedAs = 0;
+    quint64 vmallocTotal = 0, vmallocUsed = 0, vmallocChunk = 0, percpu = 0;
+    quint64 hardwareCorrupted = 0;
+    quint64 anonHugePages = 0, shmemHugePages = 0, shmemPmdMapped = 0;
+    quint64 fileHugePages = 0, filePmdMapped = 0;
+    quint64 cmaTotal = 0, cmaFree = 0, unaccepted = 0;
+    quint64 hugePagesTotal = 0, hugePagesFree = 0, hugePagesRsvd = 0, hugePagesSurp = 0;   // pages
+    quint64 hugepageSize = 0, hugetlb = 0;
+    quint64 directMap4k = 0, directMap2M = 0, directMap1G = 0;
+};
+
 struct MemStats {
     quint64 total = 0;
-    quint64 used = 0;
-    quint64 free = 0;
+    quint64 used = 0;           // total - available
+    quint64 free = 0;           // unused; page cache and reclaimable slab are not free
     quint64 swapUsed = 0;
     quint64 swapTotal = 0;
+
+    quint64 available = 0;      // allocatable without swapping (MemAvailable)
+    quint64 committed = 0;      // commit charge (Committed_AS)
+    quint64 commitLimit = 0;
+
+    MemInfo info;               // Linux only
 };
@@ -0,0 +1,208 @@
+#include <core/MetricHistory.h>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+// floor division that also works for times before the base
+qint64 floorDiv(qint64 a, qint64 b)
+{
+    qint64 q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) --q;
+    return q;
+}
+
+} // namespace
+
+MetricHistory::Config MetricHistory::compactConfig()
+{
+    Config c;
+    c.rawCapacity = 0;
+    c.tierCapacity = {120, 60, 24};
+    return c;
+}
+
+MetricHistory::SeriesId MetricHistory::series(const std::string& name)
+{
+    return series(name, Config{});
+}
+
+MetricHistory::SeriesId MetricHistory::series(const std::string& name, const Config& config)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(name);
+        if (it != m_ids.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    if (it != m_ids.end()) return it->second;
+
+    auto s = std::make_unique<Series>();
+    s->raw.resize(config.rawCapacity);
+    for (int t = 0; t < TierCount; ++t) s->tiers[t].resize(config.tierCapacity[t]);
+
+    const SeriesId id = SeriesId(m_series.size());
+    m_series.push_back(std::move(s));
+    m_ids.emplace(name, id);
+    return id;
+}
+
+MetricHistory::SeriesId MetricHistory::find(const std::string& name) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    return it == m_ids.end() ? -1 : it->second;
+}
+
+std::vector<std::string> MetricHistory::names() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<std::string> out(m_series.size());
+    for (const auto& [name, id] : m_ids) out[std::size_t(id)] = name;
+    return out;
+}
+
+void MetricHistory::append(SeriesId id, qint64 timeMs, double value)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (id < 0 || std::size_t(id) >= m_series.size()) return;
+    Series& s = *m_series[std::size_t(id)];
+
+    if (!s.hasBase) {
+        // Align to the hour so every tier's buckets start on round times
+        s.baseMs = floorDiv(timeMs, tierWidthMs(Hour)) * tierWidthMs(Hour);
+        s.hasBase = true;
+    }
+    // Samples older than the base cannot be placed in a bucket
+    if (timeMs < s.baseMs) return;
+    s.lastMs = std::max(s.lastMs, timeMs);
+
+    if (!s.raw.empty()) {
+        s.raw[s.rawHead] = {timeMs, value};
+        s.rawHead = (s.rawHead + 1) % s.raw.size();
+        s.rawSize = std::min(s.rawSize + 1, s.raw.size());
+    }
+
+    const float v = float(value);
+    for (int t = 0; t < TierCount; ++t) {
+        std::vector<Cell>& cells = s.tiers[t];
+        if (cells.empty()) continue;
+
+        const qint64 epoch = (timeMs - s.baseMs) / tierWidthMs(Tier(t));
+        Cell& c = cells[std::size_t(epoch % qint64(cells.size()))];
+        if (c.epoch != qint32(epoch)) {
+            // Slot held an expired bucket (or none): start over
+            if (c.epoch > qint32(epoch)) continue; // late sample for a recycled slot
+            c = {qint32(epoch), 1, v, v, v};
+            continue;
+        }
+        ++c.count;
+        c.min = std::min(c.min, v);
+        c.max = std::max(c.max, v);
+        c.mean += (v - c.mean) / float(c.count);
+    }
+}
+
+std::vector<MetricHistory::Sample> MetricHistory::raw(SeriesId id, qint64 fromMs, qint64 toMs) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<Sample> out;
+    if (id < 0 || std::size_t(id) >= m_series.size()) return out;
+    const Series& s = *m_series[std::size_t(id)];
+
+    const std::size_t cap = s.raw.size();
+    for (std::size_t i = 0; i < s.rawSize; ++i) {
+        const Sample& smp = s.raw[(s.rawHead + cap - s.rawSize + i) % cap];
+        if (smp.timeMs >= fromMs && smp.timeMs < toMs) out.push_back(smp);
+    }
+    return out;
+}
+
+MetricHistory::Tier MetricHistory::pickTier(const Series& s, qint64 fromMs) const
+{
+    for (int t = 0; t < TierCount; ++t) {
+        const qint64 retention = qint64(s.tiers[t].size()) * tierWidthMs(Tier(t));
+        if (retention > 0 && s.lastMs - fromMs < retention) return Tier(t);
+    }
+    return Hour;
+}
+
+template <typename F>
+void MetricHistory::forEachBucket(const Series& s, qint64 fromMs, qint64 toMs, Tier tier, F&& fn) const
+{
+    const std::vector<Cell>& cells = s.tiers[tier];
+    if (!s.hasBase || cells.empty() || toMs <= fromMs) return;
+
+    const qint64 width = tierWidthMs(tier);
+    const qint64 cap = qint64(cells.size());
+    const qint64 newest = (s.lastMs - s.baseMs) / width;
+
+    // Only the last `cap` epochs can still be in the ring
+    const qint64 first = std::max(floorDiv(fromMs - s.baseMs, width), std::max<qint64>(0, newest - cap + 1));
+    const qint64 last = std::min(floorDiv(toMs - 1 - s.baseMs, width), newest);
+
+    for (qint64 e = first; e <= last; ++e) {
+        const Cell& c = cells[std::size_t(e % cap)];
+        if (c.epoch != qint32(e) || c.count == 0) continue;
+        fn(s.baseMs + e * width, c);
+    }
+}
+
+std::vector<MetricHistory::Bucket> MetricHistory::range(SeriesId id, qint64 fromMs, qint64 toMs,
+                                                        Tier tier) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<Bucket> out;
+    if (id < 0 || std::size_t(id) >= m_series.size()) return out;
+    forEachBucket(*m_series[std::size_t(id)], fromMs, toMs, tier, [&](qint64 startMs, const Cell& c) {
+        out.push_back({startMs, c.min, c.max, c.mean, c.count});
+    });
+    return out;
+}
+
+std::vector<MetricHistory::Bucket> MetricHistory::range(SeriesId id, qint64 fromMs, qint64 toMs) const
+{
+    Tier tier;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        if (id < 0 || std::size_t(id) >= m_series.size()) return {};
+        tier = pickTier(*m_series[std::size_t(id)], fromMs);
+    }
+    return range(id, fromMs, toMs, tier);
+}
+
+MetricHistory::Bucket MetricHistory::summarize(SeriesId id, qint64 fromMs, qint64 toMs) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    Bucket sum;
+    if (id < 0 || std::size_t(id) >= m_series.size()) return sum;
+    const Series& s = *m_series[std::size_t(id)];
+
+    double weighted = 0;
+    sum.min = std::numeric_limits<double>::max();
+    sum.max = std::numeric_limits<double>::lowest();
+    forEachBucket(s, fromMs, toMs, pickTier(s, fromMs), [&](qint64 startMs, const Cell& c) {
+        if (sum.count == 0) sum.startMs = startMs;
+        sum.min = std::min<double>(sum.min, c.min);
+        sum.max = std::max<double>(sum.max, c.max);
+        weighted += double(c.mean) * c.count;
+        sum.count += c.count;
+    });
+    if (sum.count == 0) return Bucket{};
+    sum.avg = weighted / sum.count;
+    return sum;
+}
+
+std::size_t MetricHistory::memoryBytes() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::size_t bytes = 0;
+    for (const auto& s : m_series) {
+        bytes += sizeof(Series) + s->raw.capacity() * sizeof(Sample);
+        for (const auto& t : s->tiers) bytes += t.capacity() * sizeof(Cell);
+    }
+    return bytes;
+}
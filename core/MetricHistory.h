@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Bounded in-memory history for named metric series.
+//
+// Every series keeps a small ring of raw samples plus three rollup tiers
+// (1 s, 1 min, 1 h buckets with min/max/avg). Each append updates all tiers
+// in O(1); a bucket's slot is derived from its time, so nothing is ever
+// shifted or compacted and memory is fixed when the series is created.
+// Range queries read only the buckets that overlap the range from the
+// finest tier that still covers it.
+class MetricHistory {
+public:
+    enum Tier { Second = 0, Minute = 1, Hour = 2, TierCount = 3 };
+
+    struct Config {
+        std::size_t rawCapacity = 256;
+        std::array<std::size_t, TierCount> tierCapacity = {600, 1440, 720}; // 10 min, 24 h, 30 days
+    };
+
+    // 2 min at 1 s, 1 h at 1 min, 24 h at 1 h, no raw samples: 204 cells,
+    // ~4.2 KB per series (1.1 MB at 256 cores, 2.2 MB at 512). Meant for
+    // per-core series on large hosts; keeping 24 h at 1 min would cost
+    // ~32 KB per series (16 MB at 512 cores).
+    static Config compactConfig();
+
+    struct Sample {
+        qint64 timeMs = 0;
+        double value = 0;
+    };
+
+    struct Bucket {
+        qint64 startMs = 0;
+        double min = 0, max = 0, avg = 0;
+        quint32 count = 0;
+    };
+
+    using SeriesId = int;
+
+    // Finds or creates a series; config only applies on creation.
+    SeriesId series(const std::string& name);
+    SeriesId series(const std::string& name, const Config& config);
+    SeriesId find(const std::string& name) const;    // -1 if unknown
+    std::vector<std::string> names() const;
+
+    void append(SeriesId id, qint64 timeMs, double value);
+
+    // Raw samples with fromMs <= t < toMs, oldest first.
+    std::vector<Sample> raw(SeriesId id, qint64 fromMs, qint64 toMs) const;
+
+    // Buckets of one tier overlapping [fromMs, toMs), oldest first.
+    std::vector<Bucket> range(SeriesId id, qint64 fromMs, qint64 toMs, Tier tier) const;
+
+    // Finest tier whose retention covers [fromMs, toMs) as of the last append.
+    std::vector<Bucket> range(SeriesId id, qint64 fromMs, qint64 toMs) const;
+
+    // min/max/avg over [fromMs, toMs) from the chosen tier (count 0 if empty).
+    Bucket summarize(SeriesId id, qint64 fromMs, qint64 toMs) const;
+
+    std::size_t memoryBytes() const;
+
+    static constexpr qint64 tierWidthMs(Tier tier)
+    {
+        return tier == Second ? 1000 : tier == Minute ? 60'000 : 3'600'000;
+    }
+
+private:
+    // 20 bytes; epoch counts tier widths since the series' base time
+    struct Cell {
+        qint32 epoch = -1;
+        quint32 count = 0;
+        float min = 0, max = 0, mean = 0;
+    };
+
+    struct Series {
+        qint64 baseMs = 0;
+        bool hasBase = false;
+        qint64 lastMs = 0;
+        std::vector<Sample> raw;
+        std::size_t rawHead = 0;    // next write position
+        std::size_t rawSize = 0;
+        std::array<std::vector<Cell>, TierCount> tiers;
+    };
+
+    Tier pickTier(const Series& s, qint64 fromMs) const;
+
+    // Calls fn(startMs, cell) for every live bucket of tier in [fromMs, toMs)
+    template <typename F>
+    void forEachBucket(const Series& s, qint64 fromMs, qint64 toMs, Tier tier, F&& fn) const;
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<std::unique_ptr<Series>> m_series;
+    std::unordered_map<std::string, SeriesId> m_ids;
+};
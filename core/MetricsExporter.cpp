@@ -0,0 +1,347 @@
+#include <core/MetricsExporter.h>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+// -------- Rendering --------
+// Values follow the Prometheus base-unit conventions: ratios instead of
+// percent, hertz, bytes, celsius. Formatting into stack buffers keeps a
+// re-render free of allocations once the section strings have grown.
+
+static void appendFamily(std::string& out, const char* name, const char* type, const char* unit, const char* help)
+{
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    if (unit) {
+        out += "# UNIT ";
+        out += name;
+        out += ' ';
+        out += unit;
+        out += '\n';
+    }
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += '\n';
+}
+
+static void appendFamily(std::string& out, const char* name, const char* unit, const char* help)
+{
+    appendFamily(out, name, "gauge", unit, help);
+}
+
+// to_chars ignores LC_NUMERIC (QCoreApplication sets it from the
+// environment, and a decimal comma fails the whole scrape); non-finite
+// values get the spellings OpenMetrics expects rather than nan/inf.
+static void appendValue(std::string& out, double value)
+{
+    if (std::isnan(value)) {
+        out += " NaN\n";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value > 0 ? " +Inf\n" : " -Inf\n";
+        return;
+    }
+    char buf[32];
+    buf[0] = ' ';
+    const std::to_chars_result r = std::to_chars(buf + 1, buf + sizeof(buf) - 1, value,
+                                                 std::chars_format::general, 10);
+    *r.ptr = '\n';
+    out.append(buf, std::size_t(r.ptr + 1 - buf));
+}
+
+static void appendValue(std::string& out, unsigned long long value)
+{
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), " %llu\n", value);
+    out.append(buf, std::size_t(n));
+}
+
+// name{key="index"}
+static void appendIndexed(std::string& out, const char* name, const char* key, long long index)
+{
+    char buf[48];
+    const int n = std::snprintf(buf, sizeof(buf), "{%s=\"%lld\"", key, index);
+    out += name;
+    out.append(buf, std::size_t(n));
+}
+
+static const char* const kModes[] = {"user", "nice", "system", "idle", "iowait", "irq", "softirq", "steal"};
+
+static void renderCpu(std::string& out, const CpuStats& cpu)
+{
+    out.clear();
+
+    appendFamily(out, "sysmon_cpu_usage_ratio", "ratio",
+                 "Share of CPU time spent outside idle and iowait, all CPUs.");
+    out += "sysmon_cpu_usage_ratio";
+    appendValue(out, cpu.cpuUsage / 100.0);
+
+    const CpuTimeShares& t = cpu.cpuTimes;
+    const double shares[] = {t.user, t.nice, t.system, t.idle, t.iowait, t.irq, t.softirq, t.steal};
+    appendFamily(out, "sysmon_cpu_time_ratio", "ratio", "Share of CPU time per mode, all CPUs.");
+    for (int m = 0; m < 8; ++m) {
+        out += "sysmon_cpu_time_ratio{mode=\"";
+        out += kModes[m];
+        out += "\"}";
+        appendValue(out, shares[m] / 100.0);
+    }
+
+    const CpuUtilization& u = cpu.perCore;
+    if (!u.cpuId.empty()) {
+        appendFamily(out, "sysmon_cpu_core_usage_ratio", "ratio",
+                     "Share of CPU time spent outside idle and iowait, per CPU.");
+        for (std::size_t i = 0; i < u.cpuId.size(); ++i) {
+            appendIndexed(out, "sysmon_cpu_core_usage_ratio", "cpu", u.cpuId[i]);
+            out += '}';
+            appendValue(out, u.usage[i] / 100.0);
+        }
+
+        const std::vector<double>* perMode[] = {&u.user, &u.nice, &u.system, &u.idle,
+                                                &u.iowait, &u.irq, &u.softirq, &u.steal};
+        appendFamily(out, "sysmon_cpu_core_time_ratio", "ratio", "Share of CPU time per mode, per CPU.");
+        for (std::size_t i = 0; i < u.cpuId.size(); ++i) {
+            for (int m = 0; m < 8; ++m) {
+                if (i >= perMode[m]->size()) continue;
+                appendIndexed(out, "sysmon_cpu_core_time_ratio", "cpu", u.cpuId[i]);
+                out += ",mode=\"";
+                out += kModes[m];
+                out += "\"}";
+                appendValue(out, (*perMode[m])[i] / 100.0);
+            }
+        }
+    }
+
+    appendFamily(out, "sysmon_cpu_cores", nullptr, "Logical CPUs.");
+    out += "sysmon_cpu_cores";
+    appendValue(out, double(cpu.cores.totalCores));
+
+    appendFamily(out, "sysmon_cpu_average_frequency_hertz", "hertz", "Mean current frequency of the online CPUs.");
+    out += "sysmon_cpu_average_frequency_hertz";
+    appendValue(out, cpu.cores.averageFreq * 1e6);
+
+    const std::vector<double>& freq = cpu.cores.coreFreq;
+    if (!freq.empty()) {
+        appendFamily(out, "sysmon_cpu_frequency_hertz", "hertz", "Current frequency per online CPU.");
+        for (std::size_t i = 0; i < freq.size(); ++i) {
+            if (freq[i] <= 0) continue;     // offline or unknown
+            appendIndexed(out, "sysmon_cpu_frequency_hertz", "cpu", (long long)i);
+            out += '}';
+            appendValue(out, freq[i] * 1e6);
+        }
+    }
+
+    const CpuTemperatures& temps = cpu.temperatures;
+    if (temps.max >= 0) {
+        appendFamily(out, "sysmon_cpu_temperature_max_celsius", "celsius", "Hottest CPU sensor.");
+        out += "sysmon_cpu_temperature_max_celsius";
+        appendValue(out, temps.max);
+    }
+    bool header = false;
+    for (std::size_t p = 0; p < temps.packages.size(); ++p) {
+        if (temps.packages[p] < 0) continue;
+        if (!header) {
+            appendFamily(out, "sysmon_cpu_package_temperature_celsius", "celsius", "CPU package temperature.");
+            header = true;
+        }
+        appendIndexed(out, "sysmon_cpu_package_temperature_celsius", "package", (long long)p);
+        out += '}';
+        appendValue(out, temps.packages[p]);
+    }
+    if (!temps.cores.empty()) {
+        appendFamily(out, "sysmon_cpu_core_temperature_celsius", "celsius", "Physical core temperature.");
+        for (const CoreTemperature& c : temps.cores) {
+            appendIndexed(out, "sysmon_cpu_core_temperature_celsius", "package", c.package);
+            char buf[32];
+            const int n = std::snprintf(buf, sizeof(buf), ",core=\"%d\"}", int(c.core));
+            out.append(buf, std::size_t(n));
+            appendValue(out, c.celsius);
+        }
+    }
+}
+
+static void renderMem(std::string& out, const MemStats& mem)
+{
+    out.clear();
+    const MemInfo& info = mem.info;
+    const struct { const char* name; const char* unit; const char* help; unsigned long long value; } rows[] = {
+        {"sysmon_memory_total_bytes", "bytes", "Physical memory.", mem.total},
+        {"sysmon_memory_used_bytes", "bytes", "Physical memory not available for allocation.", mem.used},
+        {"sysmon_memory_free_bytes", "bytes", "Physical memory not in use at all.", mem.free},
+        {"sysmon_memory_available_bytes", "bytes", "Physical memory allocatable without swapping.", mem.available},
+        {"sysmon_memory_committed_bytes", "bytes", "Commit charge.", mem.committed},
+        {"sysmon_memory_commit_limit_bytes", "bytes", "Commit limit.", mem.commitLimit},
+        {"sysmon_memory_buffers_bytes", "bytes", "Block device buffers.", info.buffers},
+        {"sysmon_memory_cached_bytes", "bytes", "Page cache.", info.cached},
+        {"sysmon_memory_shmem_bytes", "bytes", "Shared memory and tmpfs.", info.shmem},
+        {"sysmon_memory_slab_bytes", "bytes", "Kernel slab allocations.", info.slab},
+        {"sysmon_memory_slab_reclaimable_bytes", "bytes", "Reclaimable part of the slab.", info.sReclaimable},
+        {"sysmon_memory_dirty_bytes", "bytes", "Pages waiting to be written back.", info.dirty},
+        {"sysmon_memory_writeback_bytes", "bytes", "Pages being written back.", info.writeback},
+        {"sysmon_memory_anon_huge_pages_bytes", "bytes", "Anonymous transparent huge pages.", info.anonHugePages},
+        {"sysmon_memory_huge_pages", nullptr, "Preallocated huge pages.", info.hugePagesTotal},
+        {"sysmon_memory_huge_pages_free", nullptr, "Unused preallocated huge pages.", info.hugePagesFree},
+        {"sysmon_swap_total_bytes", "bytes", "Swap space.", mem.swapTotal},
+        {"sysmon_swap_used_bytes", "bytes", "Swap space in use.", mem.swapUsed},
+    };
+    for (const auto& row : rows) {
+        appendFamily(out, row.name, row.unit, row.help);
+        out += row.name;
+        appendValue(out, row.value);
+    }
+}
+
+static void renderProcesses(std::string& out, const ProcessThreadTotals& totals)
+{
+    out.clear();
+    appendFamily(out, "sysmon_processes", nullptr, "Processes.");
+    out += "sysmon_processes";
+    appendValue(out, (unsigned long long)totals.processCount);
+    appendFamily(out, "sysmon_threads", nullptr, "Threads across all processes.");
+    out += "sysmon_threads";
+    appendValue(out, (unsigned long long)totals.threadCount);
+}
+
+// name{collector="<collector>"[,quantile="<quantile>"]}
+static void appendCollector(std::string& out, const char* name, const std::string& collector, const char* quantile = nullptr)
+{
+    out += name;
+    out += "{collector=\"";
+    out += collector;
+    out += '"';
+    if (quantile) {
+        out += ",quantile=\"";
+        out += quantile;
+        out += '"';
+    }
+    out += '}';
+}
+
+// names[i] is collectors[i].name as UTF-8
+static void renderSelf(std::string& out, const SelfStats& self, const std::vector<std::string>& names)
+{
+    out.clear();
+    if (self.collectors.empty()) return;
+
+    appendFamily(out, "sysmon_self_collector_duration_seconds", "summary", "seconds",
+                 "Wall time per call of each of the monitor's own collectors.");
+    for (std::size_t i = 0; i < self.collectors.size(); ++i) {
+        const CollectorStats& c = self.collectors[i];
+        const struct { const char* q; double us; } quantiles[] = {{"0.5", c.p50Us}, {"0.9", c.p90Us}, {"0.99", c.p99Us}};
+        for (const auto& q : quantiles) {
+            appendCollector(out, "sysmon_self_collector_duration_seconds", names[i], q.q);
+            appendValue(out, q.us / 1e6);
+        }
+        appendCollector(out, "sysmon_self_collector_duration_seconds_sum", names[i]);
+        appendValue(out, c.totalSeconds);
+        appendCollector(out, "sysmon_self_collector_duration_seconds_count", names[i]);
+        appendValue(out, (unsigned long long)c.calls);
+    }
+
+    appendFamily(out, "sysmon_self_syscalls", "counter", nullptr, "Syscalls made by each collector.");
+    for (std::size_t i = 0; i < self.collectors.size(); ++i) {
+        appendCollector(out, "sysmon_self_syscalls_total", names[i]);
+        appendValue(out, (unsigned long long)self.collectors[i].syscalls);
+    }
+    appendFamily(out, "sysmon_self_read_bytes", "counter", "bytes", "Bytes read by each collector.");
+    for (std::size_t i = 0; i < self.collectors.size(); ++i) {
+        appendCollector(out, "sysmon_self_read_bytes_total", names[i]);
+        appendValue(out, (unsigned long long)self.collectors[i].bytesRead);
+    }
+
+    appendFamily(out, "sysmon_self_cpu_seconds", "counter", "seconds", "CPU time of the monitor process.");
+    out += "sysmon_self_cpu_seconds_total";
+    appendValue(out, self.cpuSeconds);
+}
+
+// -------- Publishing --------
+void MetricsExporter::updateCpu(const CpuStats& cpu)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    renderCpu(m_cpuSection, cpu);
+    publish();
+}
+
+void MetricsExporter::updateMem(const MemStats& mem)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    renderMem(m_memSection, mem);
+    publish();
+}
+
+void MetricsExporter::updateProcesses(const ProcessThreadTotals& totals)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    renderProcesses(m_processSection, totals);
+    publish();
+}
+
+void MetricsExporter::updateSelf(const SelfStats& self)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // The collector set is fixed once the monitor is up; convert the names
+    // only when it changes
+    bool same = m_collectorKeys.size() == self.collectors.size();
+    for (std::size_t i = 0; same && i < self.collectors.size(); ++i)
+        same = m_collectorKeys[i] == self.collectors[i].name;
+    if (!same) {
+        m_collectorKeys.clear();
+        m_collectorNames.clear();
+        for (const CollectorStats& c : self.collectors) {
+            m_collectorKeys.push_back(c.name);
+            m_collectorNames.push_back(c.name.toStdString());
+        }
+    }
+    renderSelf(m_selfSection, self, m_collectorNames);
+    publish();
+}
+
+std::string MetricsExporter::body(const Response& response)
+{
+    if (!response) return {};
+    const std::size_t headerEnd = response->find("\r\n\r\n");
+    return headerEnd == std::string::npos ? std::string() : response->substr(headerEnd + 4);
+}
+
+void MetricsExporter::publish()
+{
+    static const char kEof[] = "# EOF\n";
+    const std::size_t bodySize = m_cpuSection.size() + m_memSection.size()
+                               + m_processSection.size() + m_selfSection.size() + sizeof(kEof) - 1;
+
+    // The previous response is free once no scraper holds it: it has not
+    // been published since it was replaced, so nobody can pick it up again.
+    // use_count() is a relaxed load; the fence pairs with the release
+    // decrement of the scraper's last reference, so its writev is done
+    // reading before we rewrite the buffer.
+    std::shared_ptr<std::string> next;
+    if (m_spare && m_spare.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next = std::move(m_spare);
+    } else {
+        next = std::make_shared<std::string>();
+    }
+
+    char header[160];
+    const int n = std::snprintf(header, sizeof(header),
+                                "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n",
+                                kContentType, bodySize);
+    next->clear();
+    next->reserve(std::size_t(n) + bodySize);
+    next->append(header, std::size_t(n));
+    *next += m_cpuSection;
+    *next += m_memSection;
+    *next += m_processSection;
+    *next += m_selfSection;
+    next->append(kEof, sizeof(kEof) - 1);
+
+    std::atomic_store_explicit(&m_response, Response(next), std::memory_order_release);
+    m_spare = std::move(m_current);
+    m_current = std::move(next);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <core/MemStats.h>
+#include <core/ProcessStats.h>
+#include <core/SelfStats.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// OpenMetrics text exposition of the latest samples, rendered once per
+// sample instead of once per scrape. Each metric group (cpu, memory,
+// processes) keeps its own section text, re-rendered only when that group
+// gets a new sample; the sections are then joined into a complete HTTP
+// response, headers included, and published by pointer swap. A scrape is
+// a single write of whatever response is current.
+//
+// Buffers are recycled: the response before the current one is reused for
+// the next render unless a scraper still holds it.
+class MetricsExporter {
+public:
+    using Response = std::shared_ptr<const std::string>;
+
+    static constexpr const char* kContentType =
+        "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+    // Called from the sampling thread (or anything else; updates serialize)
+    void updateCpu(const CpuStats& cpu);
+    void updateMem(const MemStats& mem);
+    void updateProcesses(const ProcessThreadTotals& totals);
+    void updateSelf(const SelfStats& self);
+
+    // Complete "HTTP/1.1 200" response for GET /metrics; nullptr until the
+    // first update. Safe to call from any thread.
+    Response response() const { return std::atomic_load_explicit(&m_response, std::memory_order_acquire); }
+
+    // Body only, for callers that do their own transport
+    static std::string body(const Response& response);
+
+private:
+    void publish();
+
+    std::mutex m_mutex;
+    std::string m_cpuSection;
+    std::string m_memSection;
+    std::string m_processSection;
+    std::string m_selfSection;
+    std::vector<QString> m_collectorKeys;       // collector names as last seen
+    std::vector<std::string> m_collectorNames;  // the same, UTF-8 for rendering
+    std::shared_ptr<std::string> m_current;     // what m_response points at
+    std::shared_ptr<std::string> m_spare;       // the previous response
+    Response m_response;
+};
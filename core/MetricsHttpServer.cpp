@@ -0,0 +1,304 @@
+#include <core/MetricsHttpServer.h>
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kMaxRequestBytes = 16 * 1024;
+constexpr std::size_t kMaxConnections = 512;
+
+constexpr char kNotFound[] =
+    "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\n\r\nNot found\n";
+constexpr char kMethodNotAllowed[] =
+    "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\n\r\n";
+constexpr char kUnavailable[] =
+    "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\n\r\n";
+constexpr char kBadRequest[] =
+    "HTTP/1.1 400 Bad Request\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+constexpr char kTooLarge[] =
+    "HTTP/1.1 431 Request Header Fields Too Large\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+
+// Case-insensitive search for a header line "Name: value" within headers
+bool hasHeaderValue(std::string_view headers, std::string_view name, std::string_view value)
+{
+    auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; };
+    auto iequals = [&](std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (lower(a[i]) != lower(b[i])) return false;
+        return true;
+    };
+
+    while (!headers.empty()) {
+        const std::size_t eol = headers.find("\r\n");
+        std::string_view line = headers.substr(0, eol);
+        headers = eol == std::string_view::npos ? std::string_view() : headers.substr(eol + 2);
+
+        const std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos || !iequals(line.substr(0, colon), name)) continue;
+        std::string_view v = line.substr(colon + 1);
+        while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+        while (!v.empty() && (v.back() == ' ' || v.back() == '\t')) v.remove_suffix(1);
+        if (iequals(v, value)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(const MetricsExporter& exporter)
+    : m_exporter(exporter)
+{
+}
+
+MetricsHttpServer::~MetricsHttpServer()
+{
+    stop();
+}
+
+#ifdef _WIN32
+
+bool MetricsHttpServer::start(const std::string&, quint16)
+{
+    return false;
+}
+
+void MetricsHttpServer::stop()
+{
+}
+
+#else
+
+bool MetricsHttpServer::start(const std::string& address, quint16 port)
+{
+    if (isRunning()) return false;
+
+    sockaddr_storage addr{};
+    socklen_t addrLen = 0;
+    auto* v4 = reinterpret_cast<sockaddr_in*>(&addr);
+    auto* v6 = reinterpret_cast<sockaddr_in6*>(&addr);
+    if (::inet_pton(AF_INET, address.c_str(), &v4->sin_addr) == 1) {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(port);
+        addrLen = sizeof(sockaddr_in);
+    } else if (::inet_pton(AF_INET6, address.c_str(), &v6->sin6_addr) == 1) {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(port);
+        addrLen = sizeof(sockaddr_in6);
+    } else {
+        return false;
+    }
+
+    m_listenFd = ::socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) return false;
+    const int one = 1;
+    ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), addrLen) != 0
+        || ::listen(m_listenFd, 128) != 0
+        || ::pipe2(m_wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        stop();
+        return false;
+    }
+
+    sockaddr_storage bound{};
+    socklen_t boundLen = sizeof(bound);
+    ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&bound), &boundLen);
+    m_port = ntohs(bound.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                                               : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+
+    m_thread = std::thread(&MetricsHttpServer::run, this);
+    return true;
+}
+
+void MetricsHttpServer::stop()
+{
+    if (m_thread.joinable()) {
+        const char byte = 1;
+        while (::write(m_wakeFds[1], &byte, 1) < 0 && errno == EINTR) {}
+        m_thread.join();
+    }
+    for (Connection& c : m_connections) ::close(c.fd);
+    m_connections.clear();
+    auto closeFd = [](int& fd) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    };
+    closeFd(m_listenFd);
+    closeFd(m_wakeFds[0]);
+    closeFd(m_wakeFds[1]);
+}
+
+void MetricsHttpServer::run()
+{
+    std::vector<pollfd> fds;
+    for (;;) {
+        fds.clear();
+        fds.push_back({m_wakeFds[0], POLLIN, 0});
+        fds.push_back({m_listenFd, POLLIN, 0});
+        for (const Connection& c : m_connections)
+            fds.push_back({c.fd, short(c.outLeft ? POLLOUT : POLLIN), 0});
+
+        if (::poll(fds.data(), nfds_t(fds.size()), -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[0].revents) return;    // stop()
+
+        for (std::size_t i = 0; i < m_connections.size(); ++i) {
+            Connection& c = m_connections[i];
+            const short revents = fds[i + 2].revents;
+            if (!revents) continue;
+
+            bool keep;
+            if (revents & (POLLERR | POLLNVAL)) keep = false;
+            else if (revents & POLLOUT) keep = onWritable(c);
+            else keep = onReadable(c);  // POLLIN or POLLHUP; read() reports EOF
+
+            if (!keep) {
+                ::close(c.fd);
+                c.fd = -1;
+            }
+        }
+        m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
+                                           [](const Connection& c) { return c.fd < 0; }),
+                            m_connections.end());
+
+        if (fds[1].revents & POLLIN) accept();
+    }
+}
+
+void MetricsHttpServer::accept()
+{
+    for (;;) {
+        const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;     // EAGAIN, or nothing we can do about it now
+        if (m_connections.size() >= kMaxConnections) {
+            ::close(fd);
+            continue;
+        }
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        Connection c;
+        c.fd = fd;
+        m_connections.push_back(std::move(c));
+    }
+}
+
+bool MetricsHttpServer::onReadable(Connection& c)
+{
+    char buf[4096];
+    for (;;) {
+        const ssize_t n = ::read(c.fd, buf, sizeof(buf));
+        if (n > 0) {
+            c.in.append(buf, std::size_t(n));
+            if (c.in.size() > kMaxRequestBytes) break;
+            continue;
+        }
+        if (n == 0) return false;   // peer closed
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        return false;
+    }
+    return handleRequests(c);
+}
+
+// Writes as much of the pending response as the socket takes; false on error
+bool MetricsHttpServer::sendPending(Connection& c)
+{
+    while (c.outLeft > 0) {
+        const ssize_t n = ::send(c.fd, c.out, c.outLeft, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.out += n;
+            c.outLeft -= std::size_t(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return true;
+}
+
+bool MetricsHttpServer::onWritable(Connection& c)
+{
+    if (!sendPending(c)) return false;
+    if (c.outLeft > 0) return true;     // wait for POLLOUT again
+    c.response.reset();
+    if (c.closeAfterWrite) return false;
+    // Pipelined requests may already be buffered
+    return handleRequests(c);
+}
+
+// Answers every complete request in c.in until a response has to wait for
+// the socket to drain
+bool MetricsHttpServer::handleRequests(Connection& c)
+{
+    while (c.outLeft == 0) {
+        const std::size_t end = c.in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (c.in.size() <= kMaxRequestBytes) return true;   // need more bytes
+            c.out = kTooLarge;
+            c.outLeft = sizeof(kTooLarge) - 1;
+            c.closeAfterWrite = true;
+            c.in.clear();
+            return sendPending(c);
+        }
+
+        const std::string_view request(c.in.data(), end);
+        const std::size_t lineEnd = std::min(request.find("\r\n"), request.size());
+        const std::string_view line = request.substr(0, lineEnd);
+        const std::string_view headers = lineEnd < request.size() ? request.substr(lineEnd + 2) : std::string_view();
+
+        // "GET /metrics HTTP/1.1"
+        const std::size_t sp1 = line.find(' ');
+        const std::size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+        if (sp2 == std::string_view::npos) {
+            c.out = kBadRequest;
+            c.outLeft = sizeof(kBadRequest) - 1;
+            c.closeAfterWrite = true;
+        } else {
+            const std::string_view method = line.substr(0, sp1);
+            std::string_view target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+            const std::string_view version = line.substr(sp2 + 1);
+            target = target.substr(0, target.find('?'));
+
+            c.closeAfterWrite = version == "HTTP/1.0" || hasHeaderValue(headers, "Connection", "close");
+
+            if (method != "GET") {
+                c.out = kMethodNotAllowed;
+                c.outLeft = sizeof(kMethodNotAllowed) - 1;
+            } else if (target != "/metrics") {
+                c.out = kNotFound;
+                c.outLeft = sizeof(kNotFound) - 1;
+            } else if ((c.response = m_exporter.response())) {
+                c.out = c.response->data();
+                c.outLeft = c.response->size();
+                m_scrapes.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                c.out = kUnavailable;
+                c.outLeft = sizeof(kUnavailable) - 1;
+            }
+        }
+
+        c.in.erase(0, end + 4);
+        if (!sendPending(c)) return false;
+        if (c.outLeft > 0) return true;     // onWritable() finishes it
+        c.response.reset();
+        if (c.closeAfterWrite) return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <core/MetricsExporter.h>
+#include <QtCore/qtypes.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal HTTP/1.1 server for GET /metrics. One thread multiplexes every
+// connection with poll(); a scrape hands the exporter's pre-rendered
+// response to send() as is, so concurrent scrapers share one buffer and
+// cost a socket write each. Keep-alive and pipelined requests are
+// supported; anything but GET /metrics gets a 404 or 405.
+//
+// POSIX only; start() fails on Windows.
+class MetricsHttpServer {
+public:
+    explicit MetricsHttpServer(const MetricsExporter& exporter);
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    // Binds address (IPv4 or IPv6 literal) and port, then serves on a
+    // background thread. Port 0 picks a free port, see port().
+    bool start(const std::string& address = "127.0.0.1", quint16 port = 9105);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    quint16 port() const { return m_port; }
+    // Successful GET /metrics responses sent so far
+    quint64 scrapes() const { return m_scrapes.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string in;                     // unparsed request bytes
+        MetricsExporter::Response response; // keeps the buffer being sent alive
+        const char* out = nullptr;
+        std::size_t outLeft = 0;
+        bool closeAfterWrite = false;
+    };
+
+    void run();
+    void accept();
+    bool onReadable(Connection& c);
+    bool onWritable(Connection& c);
+    bool sendPending(Connection& c);
+    bool handleRequests(Connection& c);
+
+    const MetricsExporter& m_exporter;
+    int m_listenFd = -1;
+    int m_wakeFds[2] = {-1, -1};
+    quint16 m_port = 0;
+    std::vector<Connection> m_connections;
+    std::atomic<quint64> m_scrapes{0};
+    std::thread m_thread;
+};
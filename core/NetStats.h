@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
+
+// ----- Network interfaces -----
+// Counters are cumulative; rates cover the interval since the previous call
+// and are 0 on the first call and for an interface seen for the first time.
+struct NetInterfaceStats {
+    QString name;                   // "eth0", "veth1a2b3c", ...
+    qint32 index = -1;              // stable for the monitor's lifetime, even if the interface comes back
+
+    quint64 rxBytes = 0;
+    quint64 rxPackets = 0;
+    quint64 rxErrors = 0;
+    quint64 rxDropped = 0;
+    quint64 txBytes = 0;
+    quint64 txPackets = 0;
+    quint64 txErrors = 0;
+    quint64 txDropped = 0;
+
+    double rxBytesPerSec = 0;
+    double txBytesPerSec = 0;
+    double rxPacketsPerSec = 0;
+    double txPacketsPerSec = 0;
+    double rxErrorsPerSec = 0;
+    double txErrorsPerSec = 0;
+};
+
+struct NetStats {
+    std::vector<NetInterfaceStats> interfaces;  // in /proc/net/dev order
+    double intervalSeconds = 0;                 // 0 on the first call
+};
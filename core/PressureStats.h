@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <chrono>
+
+// ----- Pressure stall information -----
+// Share of wall time in which some (or all, "full") runnable tasks were
+// stalled on a resource, as reported by Linux PSI (/proc/pressure/*).
+enum class PressureResource { Cpu, Memory, Io };
+enum class PressureKind { Some, Full };
+
+struct PressureAverages {
+    double avg10 = 0;           // percent over the last 10 s
+    double avg60 = 0;
+    double avg300 = 0;
+    quint64 totalUs = 0;        // cumulative stall time
+};
+
+struct ResourcePressure {
+    bool available = false;     // false without PSI (kernel < 4.20 or psi=0)
+    PressureAverages some;
+    PressureAverages full;      // always zero for CPU outside cgroups
+};
+
+struct PressureStats {
+    ResourcePressure cpu;
+    ResourcePressure memory;
+    ResourcePressure io;
+};
+
+// Delivered when a registered PSI trigger fires (see PressureTriggers)
+struct PressureEvent {
+    int trigger = -1;
+    PressureResource resource = PressureResource::Cpu;
+    PressureKind kind = PressureKind::Some;
+    std::chrono::steady_clock::time_point time{};
+};
@@ -1,8 +1,58 @@
 #pragma once
 
 #include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
 
 struct ProcessThreadTotals {
     qint32 processCount = 0;
     qlonglong threadCount = 0;
 };
+
+// ----- Per-process view -----
+struct ProcessInfo {
+    qint32 pid = 0;
+    qint32 ppid = 0;
+    QString comm;
+    QString cmdline;            // argv joined by spaces; empty for kernel threads
+    char state = '?';           // R, S, D, Z, ...
+    quint64 startTime = 0;      // clock ticks after boot
+    quint64 utime = 0;          // clock ticks
+    quint64 stime = 0;          // clock ticks
+    quint64 rssBytes = 0;
+    qint32 threads = 0;
+    double cpuPercent = 0;      // since the previous table; 100 = one full core
+};
+
+struct ProcessTable {
+    std::vector<ProcessInfo> processes;
+    std::vector<qint32> added;  // PIDs that appeared since the previous table
+    std::vector<qint32> exited; // PIDs that went away since the previous table
+};
+
+// ----- Top-N view -----
+enum class ProcessSortKey { Cpu, Rss, Threads };
+
+// True if a ranks before b: larger key first, lower PID on ties
+inline bool processRanksAbove(const ProcessInfo& a, const ProcessInfo& b, ProcessSortKey key)
+{
+    switch (key) {
+    case ProcessSortKey::Cpu:
+        if (a.cpuPercent != b.cpuPercent) return a.cpuPercent > b.cpuPercent;
+        break;
+    case ProcessSortKey::Rss:
+        if (a.rssBytes != b.rssBytes) return a.rssBytes > b.rssBytes;
+        break;
+    case ProcessSortKey::Threads:
+        if (a.threads != b.threads) return a.threads > b.threads;
+        break;
+    }
+    return a.pid < b.pid;
+}
+
+struct TopProcesses {
+    ProcessSortKey key = ProcessSortKey::Cpu;
+    std::vector<ProcessInfo> processes; // best first, at most n
+    ProcessThreadTotals totals;         // every process walked, not just the top
+    double intervalSeconds = 0;         // window of cpuPercent; 0 on the first call
+};
@@ -0,0 +1,405 @@
+#include <core/Recording.h>
+#include <core/DeltaCodec.h>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'Y', 'S', 'M', 'R', 'E', 'C', '1'};
+constexpr quint32 kVersion = 2;    // 2: mem.available, committed and commitLimit
+constexpr quint32 kChunkMagic = 0x4B4E4843; // "CHNK" read as little-endian
+constexpr std::size_t kFileHeaderBytes = 16;
+constexpr std::size_t kChunkHeaderBytes = 24;
+
+constexpr std::size_t kIntFields = 11;
+constexpr std::size_t kIntFieldsV1 = 8;     // version 1 stops after threadCount
+constexpr std::size_t kFloatFields = 5;
+
+// ----- field table -----
+void extractInts(const RecordedSample& s, qint64* v)
+{
+    v[0] = s.cpu.cores.totalCores;
+    v[1] = qint64(s.mem.total);
+    v[2] = qint64(s.mem.used);
+    v[3] = qint64(s.mem.free);
+    v[4] = qint64(s.mem.swapUsed);
+    v[5] = qint64(s.mem.swapTotal);
+    v[6] = s.processes.processCount;
+    v[7] = s.processes.threadCount;
+    v[8] = qint64(s.mem.available);
+    v[9] = qint64(s.mem.committed);
+    v[10] = qint64(s.mem.commitLimit);
+}
+
+void applyInts(const qint64* v, RecordedSample& s)
+{
+    s.cpu.cores.totalCores = qint32(v[0]);
+    s.mem.total = quint64(v[1]);
+    s.mem.used = quint64(v[2]);
+    s.mem.free = quint64(v[3]);
+    s.mem.swapUsed = quint64(v[4]);
+    s.mem.swapTotal = quint64(v[5]);
+    s.processes.processCount = qint32(v[6]);
+    s.processes.threadCount = v[7];
+    s.mem.available = quint64(v[8]);
+    s.mem.committed = quint64(v[9]);
+    s.mem.commitLimit = quint64(v[10]);
+}
+
+// Version 1 did not record the fields after threadCount; used was already
+// total - available, so available comes back exactly. The commit charge
+// stays 0.
+void upgradeV1(qint64* v)
+{
+    v[8] = deltacodec::wrappingSub(v[1], v[2]);
+    v[9] = 0;
+    v[10] = 0;
+}
+
+void extractFloats(const RecordedSample& s, double* v)
+{
+    v[0] = s.cpu.cpuUsage;
+    v[1] = s.cpu.cpuClock;
+    v[2] = s.cpu.cpuTemperature;
+    v[3] = s.cpu.cores.averageFreq;
+    v[4] = s.cpu.temperatures.max;
+}
+
+void applyFloats(const double* v, RecordedSample& s)
+{
+    s.cpu.cpuUsage = v[0];
+    s.cpu.cpuClock = v[1];
+    s.cpu.cpuTemperature = v[2];
+    s.cpu.cores.averageFreq = v[3];
+    s.cpu.temperatures.max = v[4];
+}
+
+// ----- encoding helpers -----
+using deltacodec::bitsOf;
+using deltacodec::doubleOf;
+using deltacodec::getVarint;
+using deltacodec::getXor;
+using deltacodec::putVarint;
+using deltacodec::putXor;
+using deltacodec::unzigzag;
+using deltacodec::wrappingAdd;
+using deltacodec::wrappingSub;
+using deltacodec::zigzag;
+
+void putLe(unsigned char* p, quint64 v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+quint64 getLe(const unsigned char* p, int bytes)
+{
+    quint64 v = 0;
+    for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+// Version of an in-memory file image, 0 if it is not a recording this
+// build can read
+quint32 fileVersion(const unsigned char* data, std::size_t size)
+{
+    if (size < kFileHeaderBytes || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) return 0;
+    const quint32 version = quint32(getLe(data + 8, 4));
+    return version == 1 || version == kVersion ? version : 0;
+}
+
+// Walks the chunk headers of an in-memory file image; returns the offset
+// just past the last complete chunk (0 if the file header is invalid)
+template <typename F>
+std::size_t walkChunks(const unsigned char* data, std::size_t size, F&& onChunk)
+{
+    if (fileVersion(data, size) == 0) return 0;
+
+    std::size_t off = kFileHeaderBytes;
+    while (size - off >= kChunkHeaderBytes) {
+        const unsigned char* h = data + off;
+        if (getLe(h, 4) != kChunkMagic) break;
+        const std::size_t samples = std::size_t(getLe(h + 4, 4));
+        const std::size_t bytes = std::size_t(getLe(h + 8, 4));
+        if (size - off - kChunkHeaderBytes < bytes) break;
+        onChunk(h + kChunkHeaderBytes, bytes, samples, qint64(getLe(h + 16, 8)));
+        off += kChunkHeaderBytes + bytes;
+    }
+    return off;
+}
+
+} // namespace
+
+// -------- Writer --------
+RecordingWriter::RecordingWriter(std::size_t samplesPerChunk)
+    : m_samplesPerChunk(samplesPerChunk ? samplesPerChunk : 1)
+    , m_prevInts(kIntFields)
+    , m_prevBits(kFloatFields)
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open(const std::string& path)
+{
+    close();
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (!ec && size > 0) {
+        // Validate and find the end of the last complete chunk
+        std::vector<unsigned char> image(size);
+        std::FILE* in = std::fopen(path.c_str(), "rb");
+        if (!in) return false;
+        const bool read = std::fread(image.data(), 1, image.size(), in) == image.size();
+        std::fclose(in);
+        if (!read) return false;
+
+        // Not a recording, or an older version; chunks of this version
+        // cannot be appended to it
+        if (fileVersion(image.data(), image.size()) != kVersion) return false;
+        const std::size_t end = walkChunks(image.data(), image.size(), [](auto&&...) {});
+        if (end == 0) return false;
+        if (end != size) std::filesystem::resize_file(path, end, ec);
+        if (ec) return false;
+
+        m_file = std::fopen(path.c_str(), "ab");
+        return m_file != nullptr;
+    }
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) return false;
+
+    unsigned char header[kFileHeaderBytes] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putLe(header + 8, kVersion, 4);
+    putLe(header + 12, kIntFields + kFloatFields, 4);
+    if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header) || std::fflush(m_file) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool RecordingWriter::append(const RecordedSample& sample)
+{
+    if (!m_file) return false;
+
+    qint64 ints[kIntFields];
+    double floats[kFloatFields];
+    extractInts(sample, ints);
+    extractFloats(sample, floats);
+
+    if (m_pendingSamples == 0) {
+        // Fresh chunk: all deltas are against zero
+        m_firstTimeMs = m_prevTimeMs = sample.timeMs;
+        m_prevDelta = 0;
+        std::fill(m_prevInts.begin(), m_prevInts.end(), 0);
+        std::fill(m_prevBits.begin(), m_prevBits.end(), 0);
+    } else {
+        const qint64 delta = wrappingSub(sample.timeMs, m_prevTimeMs);
+        putVarint(m_payload, zigzag(wrappingSub(delta, m_prevDelta)));
+        m_prevDelta = delta;
+        m_prevTimeMs = sample.timeMs;
+    }
+
+    for (std::size_t i = 0; i < kIntFields; ++i) {
+        putVarint(m_payload, zigzag(wrappingSub(ints[i], m_prevInts[i])));
+        m_prevInts[i] = ints[i];
+    }
+    for (std::size_t i = 0; i < kFloatFields; ++i) {
+        const quint64 bits = bitsOf(floats[i]);
+        putXor(m_payload, bits ^ m_prevBits[i]);
+        m_prevBits[i] = bits;
+    }
+
+    if (++m_pendingSamples >= m_samplesPerChunk) return flush();
+    return true;
+}
+
+bool RecordingWriter::flush()
+{
+    if (!m_file) return false;
+    if (m_pendingSamples == 0) return true;
+
+    unsigned char header[kChunkHeaderBytes] = {};
+    putLe(header, kChunkMagic, 4);
+    putLe(header + 4, m_pendingSamples, 4);
+    putLe(header + 8, m_payload.size(), 4);
+    putLe(header + 16, quint64(m_firstTimeMs), 8);
+
+    const bool ok = std::fwrite(header, 1, sizeof(header), m_file) == sizeof(header)
+        && std::fwrite(m_payload.data(), 1, m_payload.size(), m_file) == m_payload.size()
+        && std::fflush(m_file) == 0;
+
+    m_payload.clear();
+    m_pendingSamples = 0;
+    return ok;
+}
+
+void RecordingWriter::close()
+{
+    if (!m_file) return;
+    flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+// -------- Reader --------
+RecordingReader::~RecordingReader()
+{
+    close();
+}
+
+bool RecordingReader::open(const std::string& path)
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st {};
+    if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* map = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    m_data = static_cast<const unsigned char*>(map);
+    m_size = std::size_t(st.st_size);
+#else
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) return false;
+    std::error_code ec;
+    m_fallback.resize(std::size_t(std::filesystem::file_size(path, ec)));
+    const bool read = !ec && std::fread(m_fallback.data(), 1, m_fallback.size(), in) == m_fallback.size();
+    std::fclose(in);
+    if (!read || m_fallback.empty()) return false;
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+#endif
+
+    const std::size_t end = walkChunks(m_data, m_size,
+        [this](const unsigned char* payload, std::size_t bytes, std::size_t samples, qint64 first) {
+            m_chunks.push_back({payload, bytes, samples, first});
+            m_samples += samples;
+        });
+    if (end == 0) {
+        close();
+        return false;
+    }
+    m_intFields = fileVersion(m_data, m_size) == 1 ? kIntFieldsV1 : kIntFields;
+
+    // Only the last chunk has to be decoded to know where the recording ends
+    if (!m_chunks.empty()) {
+        Cursor c = cursor(m_chunks.back().firstTimeMs);
+        RecordedSample s;
+        while (c.next(s)) m_lastTimeMs = s.timeMs;
+    }
+    return true;
+}
+
+void RecordingReader::close()
+{
+#ifndef _WIN32
+    if (m_data && m_fallback.empty()) ::munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_fallback.clear();
+    m_chunks.clear();
+    m_samples = 0;
+    m_lastTimeMs = 0;
+    m_intFields = 0;
+}
+
+qint64 RecordingReader::firstTimeMs() const
+{
+    return m_chunks.empty() ? 0 : m_chunks.front().firstTimeMs;
+}
+
+RecordingReader::Cursor RecordingReader::cursor(qint64 fromMs) const
+{
+    Cursor c;
+    c.m_reader = this;
+    c.m_prevInts.resize(kIntFields);
+    c.m_prevBits.resize(kFloatFields);
+
+    // Last chunk starting at or before fromMs
+    std::size_t chunk = 0;
+    std::size_t lo = 0, hi = m_chunks.size();
+    while (lo < hi) {
+        const std::size_t mid = (lo + hi) / 2;
+        if (m_chunks[mid].firstTimeMs <= fromMs) { chunk = mid; lo = mid + 1; }
+        else hi = mid;
+    }
+    c.enterChunk(chunk);
+    return c;
+}
+
+bool RecordingReader::Cursor::enterChunk(std::size_t chunk)
+{
+    m_chunk = chunk;
+    if (!m_reader || chunk >= m_reader->m_chunks.size()) {
+        m_left = 0;
+        return false;
+    }
+    const ChunkRef& ref = m_reader->m_chunks[chunk];
+    m_p = ref.payload;
+    m_end = ref.payload + ref.bytes;
+    m_left = ref.samples;
+    m_first = true;
+    m_prevTimeMs = ref.firstTimeMs;
+    m_prevDelta = 0;
+    std::fill(m_prevInts.begin(), m_prevInts.end(), 0);
+    std::fill(m_prevBits.begin(), m_prevBits.end(), 0);
+    return true;
+}
+
+bool RecordingReader::Cursor::next(RecordedSample& out)
+{
+    while (m_left == 0) {
+        if (!m_reader || !enterChunk(m_chunk + 1)) return false;
+    }
+
+    if (!m_first) {
+        quint64 dod = 0;
+        if (!getVarint(m_p, m_end, dod)) return false;
+        m_prevDelta = wrappingAdd(m_prevDelta, unzigzag(dod));
+        m_prevTimeMs = wrappingAdd(m_prevTimeMs, m_prevDelta);
+    }
+    m_first = false;
+    out.timeMs = m_prevTimeMs;
+
+    qint64 ints[kIntFields];
+    const std::size_t intFields = m_reader->m_intFields;
+    for (std::size_t i = 0; i < intFields; ++i) {
+        quint64 zz = 0;
+        if (!getVarint(m_p, m_end, zz)) return false;
+        m_prevInts[i] = wrappingAdd(m_prevInts[i], unzigzag(zz));
+        ints[i] = m_prevInts[i];
+    }
+    if (intFields == kIntFieldsV1) upgradeV1(ints);
+    double floats[kFloatFields];
+    for (std::size_t i = 0; i < kFloatFields; ++i) {
+        quint64 x = 0;
+        if (!getXor(m_p, m_end, x)) return false;
+        m_prevBits[i] ^= x;
+        floats[i] = doubleOf(m_prevBits[i]);
+    }
+
+    applyInts(ints, out);
+    applyFloats(floats, out);
+    --m_left;
+    return true;
+}
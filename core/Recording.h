@@ -0,0 +1,128 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <core/MemStats.h>
+#include <core/ProcessStats.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Compact, append-only recording of monitor samples.
+//
+// File:   "SYSMREC1" | u32 version | u32 fieldCount | chunk*
+// Chunk:  u32 "CHNK" | u32 sampleCount | u32 payloadBytes | u32 reserved
+//         | i64 firstTimeMs | payload
+//
+// Inside a chunk every sample is byte-aligned: the timestamp as a zigzag
+// varint delta-of-delta (one byte for a steady cadence), integer fields as
+// zigzag varint deltas, floating-point fields XORed with their previous value
+// and stored as (leading zero bytes, meaningful bytes). Each chunk starts
+// from zero state, so a reader can start at any chunk header.
+//
+// Only the scalar fields are recorded (see RecordedSample); per-core vectors
+// and sensor lists would multiply the size by the core count.
+//
+// Version 2 added mem.available, committed and commitLimit. Version 1 files
+// still read (available derived from total - used, the commit charge 0) but
+// are not appended to.
+
+struct RecordedSample {
+    qint64 timeMs = 0;
+    CpuStats cpu;               // cpuUsage, cpuClock, cpuTemperature, cores.totalCores,
+                                // cores.averageFreq, temperatures.max
+    MemStats mem;               // all but info
+    ProcessThreadTotals processes;
+};
+
+class RecordingWriter {
+public:
+    explicit RecordingWriter(std::size_t samplesPerChunk = 600);
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    // Creates the file, or appends to an existing recording after dropping
+    // a trailing chunk that was cut short by a crash. Fails on anything that
+    // is not a recording of the current version.
+    bool open(const std::string& path);
+    bool isOpen() const { return m_file != nullptr; }
+
+    bool append(const RecordedSample& sample);
+
+    // Writes the pending (partial) chunk; it is lost on a crash otherwise.
+    bool flush();
+    void close();
+
+private:
+    std::size_t m_samplesPerChunk;
+    std::FILE* m_file = nullptr;
+
+    std::vector<unsigned char> m_payload;
+    std::size_t m_pendingSamples = 0;
+    qint64 m_firstTimeMs = 0;
+    qint64 m_prevTimeMs = 0;
+    qint64 m_prevDelta = 0;
+    std::vector<qint64> m_prevInts;
+    std::vector<quint64> m_prevBits;
+};
+
+// Reads a recording in place from a read-only mapping. open() only walks the
+// chunk headers; samples are decoded while a Cursor steps over them.
+class RecordingReader {
+public:
+    RecordingReader() = default;
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    std::size_t chunkCount() const { return m_chunks.size(); }
+    std::size_t sampleCount() const { return m_samples; }
+    qint64 firstTimeMs() const;
+    qint64 lastTimeMs() const { return m_lastTimeMs; }
+
+    class Cursor {
+    public:
+        // Decodes the next sample; false at the end of the recording.
+        bool next(RecordedSample& out);
+
+    private:
+        friend class RecordingReader;
+        const RecordingReader* m_reader = nullptr;
+        std::size_t m_chunk = 0;
+        std::size_t m_left = 0;     // samples left in the current chunk
+        const unsigned char* m_p = nullptr;
+        const unsigned char* m_end = nullptr;
+        qint64 m_prevTimeMs = 0;
+        qint64 m_prevDelta = 0;
+        bool m_first = true;
+        std::vector<qint64> m_prevInts;
+        std::vector<quint64> m_prevBits;
+
+        bool enterChunk(std::size_t chunk);
+    };
+
+    // Cursor at the first chunk that can contain fromMs (earlier samples of
+    // that chunk are still returned; skip them by timestamp).
+    Cursor cursor(qint64 fromMs = 0) const;
+
+private:
+    struct ChunkRef {
+        const unsigned char* payload;
+        std::size_t bytes;
+        std::size_t samples;
+        qint64 firstTimeMs;
+    };
+
+    const unsigned char* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::vector<unsigned char> m_fallback;  // platforms without mmap
+    std::vector<ChunkRef> m_chunks;
+    std::size_t m_samples = 0;
+    qint64 m_lastTimeMs = 0;
+    std::size_t m_intFields = 0;            // per sample in this file's version
+};
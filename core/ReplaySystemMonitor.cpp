@@ -0,0 +1,58 @@
+#include <core/ReplaySystemMonitor.h>
+
+ReplaySystemMonitor::ReplaySystemMonitor(const std::string& path, Pace pace, double speed)
+    : m_pace(pace)
+    , m_speed(speed > 0 ? speed : 1.0)
+{
+    if (!m_reader.open(path)) {
+        m_atEnd = true;
+        return;
+    }
+    m_cursor = m_reader.cursor();
+    m_haveNext = m_cursor.next(m_next);
+    m_atEnd = !m_haveNext;
+}
+
+void ReplaySystemMonitor::advance()
+{
+    if (!m_haveNext) {
+        m_atEnd = true;
+        return;
+    }
+    m_current = m_next;
+    m_haveNext = m_cursor.next(m_next);
+}
+
+void ReplaySystemMonitor::advanceTo(qint64 timeMs)
+{
+    // Latest sample not after timeMs (at least the first one)
+    if (!m_started) advance();
+    while (m_haveNext && m_next.timeMs <= timeMs) advance();
+    if (!m_haveNext) m_atEnd = true;
+}
+
+CpuStats ReplaySystemMonitor::getCpuStats()
+{
+    if (m_pace == Pace::AsFastAsPossible) {
+        advance();
+    } else {
+        const auto now = std::chrono::steady_clock::now();
+        if (!m_started) m_wallStart = now;
+        const double elapsedMs = std::chrono::duration<double, std::milli>(now - m_wallStart).count();
+        advanceTo(m_reader.firstTimeMs() + qint64(elapsedMs * m_speed));
+    }
+    m_started = true;
+    return m_current.cpu;
+}
+
+MemStats ReplaySystemMonitor::getMemStats()
+{
+    if (!m_started) getCpuStats();
+    return m_current.mem;
+}
+
+ProcessThreadTotals ReplaySystemMonitor::getProcessThreadCount()
+{
+    if (!m_started) getCpuStats();
+    return m_current.processes;
+}
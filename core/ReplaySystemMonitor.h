@@ -0,0 +1,45 @@
+#pragma once
+
+#include <core/ISystemMonitor.h>
+#include <core/Recording.h>
+#include <chrono>
+#include <string>
+
+// Serves a recording made with RecordingWriter through ISystemMonitor.
+//
+// RealTime follows the wall clock from the first call (scaled by speed).
+// AsFastAsPossible steps one sample per getCpuStats(); the memory and
+// process getters return the sample the last getCpuStats() landed on.
+// Past the end, the last sample is repeated.
+class ReplaySystemMonitor : public ISystemMonitor {
+public:
+    enum class Pace { RealTime, AsFastAsPossible };
+
+    explicit ReplaySystemMonitor(const std::string& path, Pace pace = Pace::RealTime, double speed = 1.0);
+    ~ReplaySystemMonitor() override = default;
+
+    bool isOpen() const { return m_reader.sampleCount() > 0; }
+    bool atEnd() const { return m_atEnd; }
+    const RecordedSample& current() const { return m_current; }
+
+    using ISystemMonitor::getCpuStats;
+    CpuStats getCpuStats() override;
+    MemStats getMemStats() override;
+    ProcessThreadTotals getProcessThreadCount() override;
+
+private:
+    void advance();
+    void advanceTo(qint64 timeMs);
+
+    RecordingReader m_reader;
+    RecordingReader::Cursor m_cursor;
+    Pace m_pace;
+    double m_speed;
+
+    RecordedSample m_current;
+    RecordedSample m_next;
+    bool m_haveNext = false;
+    bool m_started = false;
+    bool m_atEnd = false;
+    std::chrono::steady_clock::time_point m_wallStart{};
+};
@@ -0,0 +1,601 @@
+#include <core/RuleEngine.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string_view>
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Deepest evaluation stack a rule may need
+constexpr int kMaxDepth = 16;
+
+// Sample kinds; a field belongs to exactly one
+enum GroupIndex : quint8 { CpuGroup = 0, MemGroup = 1, ProcessGroup = 2 };
+
+enum Field : quint16 {
+    CpuUsage, CpuUser, CpuSystem, CpuIowait, CpuSteal, CpuClock, CpuTemperature, CpuTemperatureMax,
+    MemUsed, MemFree, MemAvailable, MemTotal, MemUsedPercent, MemCommitted,
+    SwapUsed, SwapTotal, SwapPercent,
+    ProcCount, ProcThreads,
+    FieldCount
+};
+
+struct FieldInfo {
+    const char* name;
+    GroupIndex group;
+};
+
+// Names match the MetricHistory series where both exist
+constexpr FieldInfo kFields[FieldCount] = {
+    {"cpu.usage", CpuGroup},
+    {"cpu.user", CpuGroup},
+    {"cpu.system", CpuGroup},
+    {"cpu.iowait", CpuGroup},
+    {"cpu.steal", CpuGroup},
+    {"cpu.clock", CpuGroup},
+    {"cpu.temperature", CpuGroup},
+    {"cpu.temperature.max", CpuGroup},
+    {"mem.used", MemGroup},
+    {"mem.free", MemGroup},
+    {"mem.available", MemGroup},
+    {"mem.total", MemGroup},
+    {"mem.usedPercent", MemGroup},
+    {"mem.committed", MemGroup},
+    {"mem.swapUsed", MemGroup},
+    {"mem.swapTotal", MemGroup},
+    {"mem.swapPercent", MemGroup},
+    {"proc.count", ProcessGroup},
+    {"proc.threads", ProcessGroup},
+};
+
+int findField(std::string_view name)
+{
+    for (int i = 0; i < FieldCount; ++i)
+        if (name == kFields[i].name) return i;
+    return -1;
+}
+
+bool isIdentChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-';
+}
+
+double percent(double part, double whole)
+{
+    return whole > 0 ? part / whole * 100.0 : kNaN;
+}
+
+} // namespace
+
+// -------- Parsing --------
+// Recursive descent over one rule line, emitting postfix into program
+class RuleEngine::Parser {
+public:
+    Parser(std::string_view line, std::vector<Instr>& program, std::vector<Window>& windows)
+        : m_s(line), m_program(program), m_windows(windows)
+    {
+    }
+
+    bool parse(Rule& rule)
+    {
+        const std::string_view name = identifier();
+        if (name.empty()) return fail("expected a rule name");
+        rule.name = std::string(name);
+        if (!consume(':')) return fail("expected ':' after the rule name");
+
+        rule.cond = quint32(m_program.size());
+        if (!expr()) return false;
+        rule.condSize = quint32(m_program.size()) - rule.cond;
+        const Instr first = m_program[rule.cond];
+
+        for (;;) {
+            skipSpace();
+            if (atEnd()) break;
+            const std::string_view word = identifier();
+            if (word == "for") {
+                if (!duration(rule.forMs)) return false;
+            } else if (word == "clear") {
+                rule.clear = quint32(m_program.size());
+                m_depth = 0;
+                Op op;
+                if (compareOp(op)) {
+                    // "clear < 80": against the condition's first operand
+                    emit(first);
+                    if (!operand()) return false;
+                    emit({op});
+                } else if (!expr()) {
+                    return false;
+                }
+                rule.clearSize = quint32(m_program.size()) - rule.clear;
+            } else {
+                return fail("unexpected '" + std::string(word.empty() ? m_s.substr(m_pos, 1) : word) + "'");
+            }
+        }
+        if (m_maxDepth > kMaxDepth) return fail("rule too deeply nested");
+        rule.groups = m_groups;
+        return true;
+    }
+
+    const std::string& error() const { return m_error; }
+
+private:
+    bool expr()
+    {
+        if (!andExpr()) return false;
+        while (keyword("or")) {
+            if (!andExpr()) return false;
+            emit({Op::Or});
+        }
+        return true;
+    }
+
+    bool andExpr()
+    {
+        if (!cmp()) return false;
+        while (keyword("and")) {
+            if (!cmp()) return false;
+            emit({Op::And});
+        }
+        return true;
+    }
+
+    bool cmp()
+    {
+        if (consume('(')) {
+            if (!expr()) return false;
+            return consume(')') || fail("expected ')'");
+        }
+        if (!operand()) return false;
+        Op op;
+        if (!compareOp(op)) return fail("expected a comparison (> >= < <= == !=)");
+        if (!operand()) return false;
+        emit({op});
+        return true;
+    }
+
+    bool operand()
+    {
+        skipSpace();
+        if (atEnd()) return fail("expected a value");
+        const char c = m_s[m_pos];
+        if ((c >= '0' && c <= '9') || c == '-' || c == '.') {
+            double v = 0;
+            if (!number(v)) return false;
+            Instr in{Op::Const};
+            in.constant = v;
+            emit(in);
+            return true;
+        }
+
+        const std::string_view word = identifier();
+        if (consume('(')) {
+            Agg agg;
+            if (word == "avg") agg = Agg::Avg;
+            else if (word == "min") agg = Agg::Min;
+            else if (word == "max") agg = Agg::Max;
+            else if (word == "delta") agg = Agg::Delta;
+            else if (word == "rate") agg = Agg::Rate;
+            else return fail("unknown aggregate '" + std::string(word) + "'");
+
+            const int field = fieldOperand();
+            if (field < 0) return false;
+            qint64 spanMs = 0;
+            if (!consume(',')) return fail("expected ',' before the window");
+            if (!duration(spanMs)) return false;
+            if (spanMs <= 0) return fail("window must be longer than 0");
+            if (!consume(')')) return fail("expected ')'");
+
+            Instr in{Op::Window};
+            in.index = window(quint16(field), agg, spanMs);
+            emit(in);
+            return true;
+        }
+
+        const int field = findField(word);
+        if (field < 0) return fail("unknown field '" + std::string(word) + "'");
+        m_groups |= quint8(1u << kFields[field].group);
+        Instr in{Op::Field};
+        in.index = quint16(field);
+        emit(in);
+        return true;
+    }
+
+    int fieldOperand()
+    {
+        const std::string_view word = identifier();
+        const int field = findField(word);
+        if (field < 0) {
+            fail("unknown field '" + std::string(word) + "'");
+            return -1;
+        }
+        m_groups |= quint8(1u << kFields[field].group);
+        return field;
+    }
+
+    // Shared between rules: one window per (field, aggregate, span)
+    quint16 window(quint16 field, Agg agg, qint64 spanMs)
+    {
+        for (std::size_t i = 0; i < m_windows.size(); ++i) {
+            const Window& w = m_windows[i];
+            if (w.field == field && w.agg == agg && w.spanMs == spanMs) return quint16(i);
+        }
+        Window w;
+        w.field = field;
+        w.agg = agg;
+        w.spanMs = spanMs;
+        w.value = kNaN;
+        m_windows.push_back(std::move(w));
+        return quint16(m_windows.size() - 1);
+    }
+
+    // Decimal number at m_pos. from_chars, unlike strtod, ignores LC_NUMERIC,
+    // which QCoreApplication takes from the environment: "90.5" must not
+    // depend on the host's decimal separator.
+    bool decimal(double& out)
+    {
+        const char* begin = m_s.data() + m_pos;
+        const std::from_chars_result r = std::from_chars(begin, m_s.data() + m_s.size(), out);
+        if (r.ec != std::errc()) return false;
+        m_pos += std::size_t(r.ptr - begin);
+        return true;
+    }
+
+    bool number(double& out)
+    {
+        skipSpace();
+        if (!decimal(out)) return fail("expected a number");
+
+        if (m_pos < m_s.size()) {
+            double scale = 1;
+            switch (m_s[m_pos]) {
+            case 'K': scale = 1024.0; break;
+            case 'M': scale = 1024.0 * 1024; break;
+            case 'G': scale = 1024.0 * 1024 * 1024; break;
+            case 'T': scale = 1024.0 * 1024 * 1024 * 1024; break;
+            default: break;
+            }
+            if (scale != 1) {
+                out *= scale;
+                ++m_pos;
+            }
+        }
+        if (m_pos < m_s.size() && isIdentChar(m_s[m_pos])) return fail("bad number suffix");
+        return true;
+    }
+
+    bool duration(qint64& ms)
+    {
+        skipSpace();
+        double v = 0;
+        if (!decimal(v) || v < 0) return fail("expected a duration");
+
+        const std::string_view unit = identifier();
+        double scale;
+        if (unit == "ms") scale = 1;
+        else if (unit == "s") scale = 1000;
+        else if (unit == "m") scale = 60'000;
+        else if (unit == "h") scale = 3'600'000;
+        else return fail("duration needs a unit (ms, s, m, h)");
+        ms = qint64(std::llround(v * scale));
+        return true;
+    }
+
+    bool compareOp(Op& op)
+    {
+        skipSpace();
+        const std::string_view rest = m_s.substr(m_pos);
+        const struct { const char* text; Op op; } ops[] = {
+            {">=", Op::Ge}, {"<=", Op::Le}, {"==", Op::Eq}, {"!=", Op::Ne}, {">", Op::Gt}, {"<", Op::Lt},
+        };
+        for (const auto& o : ops) {
+            const std::size_t n = std::char_traits<char>::length(o.text);
+            if (rest.substr(0, n) == o.text) {
+                op = o.op;
+                m_pos += n;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view identifier()
+    {
+        skipSpace();
+        const std::size_t start = m_pos;
+        while (m_pos < m_s.size() && isIdentChar(m_s[m_pos])) ++m_pos;
+        return m_s.substr(start, m_pos - start);
+    }
+
+    bool keyword(const char* word)
+    {
+        skipSpace();
+        const std::size_t save = m_pos;
+        if (identifier() == word) return true;
+        m_pos = save;
+        return false;
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (m_pos < m_s.size() && m_s[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    void emit(Instr in)
+    {
+        if (in.op == Op::Field || in.op == Op::Window || in.op == Op::Const) m_maxDepth = std::max(m_maxDepth, ++m_depth);
+        else --m_depth;
+        m_program.push_back(in);
+    }
+
+    void skipSpace()
+    {
+        while (m_pos < m_s.size() && (m_s[m_pos] == ' ' || m_s[m_pos] == '\t')) ++m_pos;
+    }
+
+    bool atEnd() const { return m_pos >= m_s.size(); }
+
+    bool fail(std::string message)
+    {
+        if (m_error.empty()) m_error = std::move(message);
+        return false;
+    }
+
+    std::string_view m_s;
+    std::size_t m_pos = 0;
+    std::vector<Instr>& m_program;
+    std::vector<Window>& m_windows;
+    std::string m_error;
+    quint8 m_groups = 0;
+    int m_depth = 0;
+    int m_maxDepth = 0;
+};
+
+std::vector<std::string> RuleEngine::fieldNames()
+{
+    std::vector<std::string> names;
+    for (const FieldInfo& f : kFields) names.emplace_back(f.name);
+    return names;
+}
+
+bool RuleEngine::compile(const std::string& text, std::string* error)
+{
+    std::vector<Instr> program;
+    std::vector<Rule> rules;
+    std::vector<Window> windows;
+
+    std::istringstream in(text);
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.pop_back();
+
+        Rule rule;
+        Parser parser(line, program, windows);
+        std::string problem;
+        if (!parser.parse(rule)) problem = parser.error();
+        for (const Rule& r : rules)
+            if (problem.empty() && r.name == rule.name) problem = "duplicate rule '" + rule.name + "'";
+        if (!problem.empty()) {
+            if (error) *error = "line " + std::to_string(lineNo) + ": " + problem;
+            return false;
+        }
+        rules.push_back(std::move(rule));
+    }
+
+    m_program = std::move(program);
+    m_rules = std::move(rules);
+    m_windows = std::move(windows);
+    m_values.assign(FieldCount, kNaN);
+    for (auto& list : m_groupWindows) list.clear();
+    for (auto& list : m_groupRules) list.clear();
+    for (std::size_t i = 0; i < m_windows.size(); ++i)
+        m_groupWindows[kFields[m_windows[i].field].group].push_back(quint16(i));
+    for (std::size_t i = 0; i < m_rules.size(); ++i) {
+        for (int g = 0; g < 3; ++g)
+            if (m_rules[i].groups & (1u << g)) m_groupRules[std::size_t(g)].push_back(int(i));
+    }
+    return true;
+}
+
+bool RuleEngine::load(const std::string& path, std::string* error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return compile(text.str(), error);
+}
+
+const char* RuleEngine::stateName(State state)
+{
+    switch (state) {
+    case State::Inactive: return "inactive";
+    case State::Pending: return "pending";
+    case State::Firing: return "firing";
+    }
+    return "?";
+}
+
+// -------- Evaluation --------
+void RuleEngine::Ring::pushBack(qint64 t, double v)
+{
+    if (count == buf.size()) {
+        // Grow to the next power of two, oldest first
+        std::vector<Item> grown(std::max<std::size_t>(8, buf.size() * 2));
+        for (std::size_t i = 0; i < count; ++i) grown[i] = buf[(head + i) & (buf.size() - 1)];
+        buf.swap(grown);
+        head = 0;
+    }
+    buf[(head + count) & (buf.size() - 1)] = {t, v};
+    ++count;
+}
+
+void RuleEngine::updateCpu(const CpuStats& cpu, qint64 timeMs)
+{
+    if (m_groupRules[CpuGroup].empty()) return;
+    double* v = m_values.data();
+    v[CpuUsage] = cpu.cpuUsage;
+    v[CpuUser] = cpu.cpuTimes.user;
+    v[CpuSystem] = cpu.cpuTimes.system;
+    v[CpuIowait] = cpu.cpuTimes.iowait;
+    v[CpuSteal] = cpu.cpuTimes.steal;
+    v[CpuClock] = cpu.cpuClock > 0 ? cpu.cpuClock : kNaN;
+    v[CpuTemperature] = cpu.cpuTemperature >= 0 ? cpu.cpuTemperature : kNaN;
+    v[CpuTemperatureMax] = cpu.temperatures.max >= 0 ? cpu.temperatures.max : kNaN;
+    sampled(CpuGroup, timeMs);
+}
+
+void RuleEngine::updateMem(const MemStats& mem, qint64 timeMs)
+{
+    if (m_groupRules[MemGroup].empty()) return;
+    double* v = m_values.data();
+    v[MemUsed] = double(mem.used);
+    v[MemFree] = double(mem.free);
+    v[MemAvailable] = double(mem.available);
+    v[MemTotal] = double(mem.total);
+    v[MemUsedPercent] = percent(double(mem.used), double(mem.total));
+    v[MemCommitted] = double(mem.committed);
+    v[SwapUsed] = double(mem.swapUsed);
+    v[SwapTotal] = double(mem.swapTotal);
+    v[SwapPercent] = mem.swapTotal ? percent(double(mem.swapUsed), double(mem.swapTotal)) : 0.0;
+    sampled(MemGroup, timeMs);
+}
+
+void RuleEngine::updateProcesses(const ProcessThreadTotals& totals, qint64 timeMs)
+{
+    if (m_groupRules[ProcessGroup].empty()) return;
+    m_values[ProcCount] = double(totals.processCount);
+    m_values[ProcThreads] = double(totals.threadCount);
+    sampled(ProcessGroup, timeMs);
+}
+
+void RuleEngine::advance(Window& w, qint64 timeMs)
+{
+    const double v = m_values[w.field];
+    const bool minMax = w.agg == Agg::Min || w.agg == Agg::Max;
+    if (!std::isnan(v)) {
+        if (w.agg == Agg::Min) {
+            while (!w.extremes.empty() && w.extremes.back().v >= v) w.extremes.popBack();
+            w.extremes.pushBack(timeMs, v);
+        } else if (w.agg == Agg::Max) {
+            while (!w.extremes.empty() && w.extremes.back().v <= v) w.extremes.popBack();
+            w.extremes.pushBack(timeMs, v);
+        } else {
+            w.samples.pushBack(timeMs, v);
+            w.sum += v;
+        }
+    }
+
+    const qint64 cutoff = timeMs - w.spanMs;
+    while (!w.samples.empty() && w.samples.front().t <= cutoff) {
+        w.sum -= w.samples.front().v;
+        w.samples.popFront();
+    }
+    while (!w.extremes.empty() && w.extremes.front().t <= cutoff) w.extremes.popFront();
+    if (w.samples.empty()) w.sum = 0;   // drops accumulated rounding
+
+    const Ring& r = minMax ? w.extremes : w.samples;
+    if (r.empty()) {
+        w.value = kNaN;
+        return;
+    }
+    switch (w.agg) {
+    case Agg::Avg: w.value = w.sum / double(r.count); break;
+    case Agg::Min:
+    case Agg::Max: w.value = r.front().v; break;
+    case Agg::Delta: w.value = r.back().v - r.front().v; break;
+    case Agg::Rate: {
+        const qint64 ms = r.back().t - r.front().t;
+        w.value = ms > 0 ? (r.back().v - r.front().v) * 1000.0 / double(ms) : 0.0;
+        break;
+    }
+    }
+}
+
+double RuleEngine::run(quint32 first, quint32 size) const
+{
+    double stack[kMaxDepth];
+    int top = 0;
+    for (quint32 i = first, end = first + size; i < end; ++i) {
+        const Instr& in = m_program[i];
+        switch (in.op) {
+        case Op::Field: stack[top++] = m_values[in.index]; continue;
+        case Op::Window: stack[top++] = m_windows[in.index].value; continue;
+        case Op::Const: stack[top++] = in.constant; continue;
+        default: break;
+        }
+
+        // Comparisons yield 0/1 and are false whenever a side is unknown
+        const double b = stack[--top];
+        double& a = stack[top - 1];
+        const bool known = !std::isnan(a) && !std::isnan(b);
+        switch (in.op) {
+        case Op::Gt: a = a > b; break;
+        case Op::Ge: a = a >= b; break;
+        case Op::Lt: a = a < b; break;
+        case Op::Le: a = a <= b; break;
+        case Op::Eq: a = a == b; break;
+        case Op::Ne: a = known && a != b; break;
+        case Op::And: a = a != 0 && b != 0; break;
+        case Op::Or: a = a != 0 || b != 0; break;
+        default: break;
+        }
+    }
+    return top > 0 ? stack[top - 1] : 0.0;
+}
+
+void RuleEngine::sampled(quint8 group, qint64 timeMs)
+{
+    for (quint16 w : m_groupWindows[group]) advance(m_windows[w], timeMs);
+
+    for (int i : m_groupRules[group]) {
+        Rule& r = m_rules[std::size_t(i)];
+        r.value = run(r.cond, 1);
+        const bool holds = run(r.cond, r.condSize) != 0;
+
+        switch (r.state) {
+        case State::Inactive:
+            if (!holds) break;
+            r.since = timeMs;
+            transition(i, r.forMs > 0 ? State::Pending : State::Firing, timeMs);
+            break;
+        case State::Pending:
+            if (!holds) transition(i, State::Inactive, timeMs);
+            else if (timeMs - r.since >= r.forMs) transition(i, State::Firing, timeMs);
+            break;
+        case State::Firing: {
+            const bool cleared = r.clearSize ? run(r.clear, r.clearSize) != 0 : !holds;
+            if (cleared) transition(i, State::Inactive, timeMs);
+            break;
+        }
+        }
+    }
+}
+
+void RuleEngine::transition(int rule, State to, qint64 timeMs)
+{
+    Rule& r = m_rules[std::size_t(rule)];
+    Event e;
+    e.rule = rule;
+    e.from = r.state;
+    e.to = to;
+    e.value = r.value;
+    e.timeMs = timeMs;
+    r.state = to;
+    for (const auto& fn : m_listeners) fn(e);
+}
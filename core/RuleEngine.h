@@ -0,0 +1,135 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <core/MemStats.h>
+#include <core/ProcessStats.h>
+#include <QtCore/qtypes.h>
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Threshold/alert rules evaluated in process against every new sample.
+//
+// Rules are compiled once into one flat postfix program; a sample writes
+// the fields the rules read into a value table, advances the windowed
+// aggregates over those fields, and runs the programs of the rules that
+// read them. Windows keep running sums and monotonic queues, so each
+// aggregate costs O(1) amortized per sample and nothing is allocated once
+// the windows have grown to their span.
+//
+// One rule per line, '#' starts a comment:
+//
+//   cpu_hot:     cpu.usage > 90 for 30s clear < 80
+//   swap_rising: delta(mem.swapUsed, 5m) > 0 for 1m
+//   too_hot:     max(cpu.temperature, 10s) > 85 clear cpu.temperature < 80
+//   low_mem:     mem.available < 512M and mem.swapPercent > 50
+//
+//   rule     := name ':' expr ['for' duration] ['clear' (cmp-op operand | expr)]
+//   expr     := and-expr ('or' and-expr)*
+//   and-expr := cmp ('and' cmp)*
+//   cmp      := operand cmp-op operand | '(' expr ')'
+//   operand  := number | field | agg '(' field ',' duration ')'
+//   agg      := avg | min | max | delta | rate      (rate is per second)
+//
+// Numbers take K/M/G/T (powers of 1024) suffixes, durations ms/s/m/h.
+// "for" keeps a rule Pending until its condition held that long. "clear"
+// adds hysteresis: a Firing rule resolves only once the clear condition
+// holds ("clear < 80" compares the condition's first operand). Fields
+// without a sample yet, and temperatures without a sensor, compare false.
+class RuleEngine {
+public:
+    enum class State : quint8 { Inactive, Pending, Firing };
+
+    struct Event {
+        int rule = -1;
+        State from = State::Inactive;
+        State to = State::Inactive;
+        double value = 0;           // the condition's first operand
+        qint64 timeMs = 0;          // sample time
+    };
+
+    // Every field a rule can read, e.g. "cpu.usage" or "mem.swapPercent"
+    static std::vector<std::string> fieldNames();
+
+    // Replaces all rules. On error nothing changes and error (if given)
+    // names the line and the problem.
+    bool compile(const std::string& text, std::string* error = nullptr);
+    bool load(const std::string& path, std::string* error = nullptr);
+
+    // Runs on the thread feeding samples, for every state change
+    void onEvent(std::function<void(const Event&)> fn) { m_listeners.push_back(std::move(fn)); }
+
+    // Feed samples (any order, any cadence); each evaluates the rules that
+    // read one of its fields
+    void updateCpu(const CpuStats& cpu, qint64 timeMs);
+    void updateMem(const MemStats& mem, qint64 timeMs);
+    void updateProcesses(const ProcessThreadTotals& totals, qint64 timeMs);
+
+    std::size_t ruleCount() const { return m_rules.size(); }
+    const std::string& ruleName(int rule) const { return m_rules[std::size_t(rule)].name; }
+    State state(int rule) const { return m_rules[std::size_t(rule)].state; }
+    double value(int rule) const { return m_rules[std::size_t(rule)].value; }
+
+    static const char* stateName(State state);
+
+private:
+    enum class Agg : quint8 { Avg, Min, Max, Delta, Rate };
+    enum class Op : quint8 { Field, Window, Const, Gt, Ge, Lt, Le, Eq, Ne, And, Or };
+
+    struct Instr {
+        Op op;
+        quint16 index = 0;          // Field: field id, Window: window id
+        double constant = 0;        // Const
+    };
+
+    // FIFO of (time, value) growing by doubling; never shrinks
+    struct Ring {
+        struct Item { qint64 t; double v; };
+        std::vector<Item> buf;
+        std::size_t head = 0, count = 0;
+
+        bool empty() const { return count == 0; }
+        const Item& front() const { return buf[head]; }
+        const Item& back() const { return buf[(head + count - 1) & (buf.size() - 1)]; }
+        void pushBack(qint64 t, double v);
+        void popFront() { head = (head + 1) & (buf.size() - 1); --count; }
+        void popBack() { --count; }
+    };
+
+    struct Window {
+        quint16 field = 0;
+        Agg agg = Agg::Avg;
+        qint64 spanMs = 0;
+        Ring samples;               // avg, delta, rate
+        Ring extremes;              // min, max: monotonic queue
+        double sum = 0;
+        double value = 0;
+    };
+
+    struct Rule {
+        std::string name;
+        quint32 cond = 0, condSize = 0;     // slice of m_program
+        quint32 clear = 0, clearSize = 0;   // empty: resolve when cond is false
+        qint64 forMs = 0;
+        quint8 groups = 0;                  // bit per sample kind the rule reads
+        State state = State::Inactive;
+        qint64 since = 0;                   // when the condition started to hold
+        double value = 0;
+    };
+
+    class Parser;
+
+    void sampled(quint8 group, qint64 timeMs);
+    void advance(Window& w, qint64 timeMs);
+    double run(quint32 first, quint32 size) const;
+    void transition(int rule, State to, qint64 timeMs);
+
+    std::vector<Instr> m_program;
+    std::vector<Rule> m_rules;
+    std::vector<Window> m_windows;
+    std::array<std::vector<quint16>, 3> m_groupWindows;     // per group bit
+    std::array<std::vector<int>, 3> m_groupRules;
+    std::vector<double> m_values;                           // per field, NaN until sampled
+    std::vector<std::function<void(const Event&)>> m_listeners;
+};
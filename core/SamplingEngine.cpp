@@ -0,0 +1,225 @@
+#include <core/SamplingEngine.h>
+#include <algorithm>
+
+SamplingEngine::SamplingEngine(std::unique_ptr<ISystemMonitor> monitor)
+    : SamplingEngine(std::move(monitor), Cadence{})
+{
+}
+
+SamplingEngine::SamplingEngine(std::unique_ptr<ISystemMonitor> monitor, Cadence cadence)
+    : m_monitor(std::move(monitor))
+    , m_cadence(cadence)
+{
+    ISystemMonitor* mon = m_monitor.get();
+    m_tasks.push_back({m_cadence.cpu, {}, [this, mon] {
+        if (!(m_fields & Metric::Cpu)) return;
+        auto snap = m_cpu.publish(mon->getCpuStats(m_fields & Metric::Cpu), std::chrono::system_clock::now());
+        for (const auto& fn : m_cpuListeners) fn(*snap);
+    }});
+    m_tasks.push_back({m_cadence.mem, {}, [this, mon] {
+        if (!(m_fields & Metric::Memory)) return;
+        auto snap = m_mem.publish(mon->getMemStats(), std::chrono::system_clock::now());
+        for (const auto& fn : m_memListeners) fn(*snap);
+    }});
+    m_tasks.push_back({m_cadence.processes, {}, [this, mon] {
+        if (!(m_fields & Metric::Processes)) return;
+        const auto now = std::chrono::system_clock::now();
+        if (m_topCount <= 0) {
+            auto snap = m_processes.publish(mon->getProcessThreadCount(), now);
+            for (const auto& fn : m_processListeners) fn(*snap);
+            return;
+        }
+        TopProcesses top = mon->getTopProcesses(m_topCount, m_topKey);
+        auto snap = m_processes.publish(top.totals, now);
+        for (const auto& fn : m_processListeners) fn(*snap);
+        auto topSnap = m_top.publish(std::move(top), now);
+        for (const auto& fn : m_topListeners) fn(*topSnap);
+    }});
+    m_tasks.push_back({m_cadence.pressure, {}, [this, mon] {
+        if (!(m_fields & Metric::Pressure)) return;
+        auto snap = m_pressure.publish(mon->getPressureStats(), std::chrono::system_clock::now());
+        for (const auto& fn : m_pressureListeners) fn(*snap);
+    }});
+    m_tasks.push_back({m_cadence.self, {}, [this, mon] {
+        auto snap = m_self.publish(mon->getSelfStats(), std::chrono::system_clock::now());
+        for (const auto& fn : m_selfListeners) fn(*snap);
+    }});
+    m_tasks.push_back({m_cadence.threads, {}, [this, mon] {
+        if (!m_watching) return;
+        ThreadTable table = mon->getThreadTable();
+        // Once the watch list is empty, publish the empty table only once
+        const auto prev = m_threads.load();
+        if (table.processes.empty() && (!prev || prev->value.processes.empty())) return;
+        auto snap = m_threads.publish(std::move(table), std::chrono::system_clock::now());
+        for (const auto& fn : m_threadListeners) fn(*snap);
+    }});
+}
+
+bool SamplingEngine::watchProcess(qint32 pid)
+{
+    if (!m_monitor->watchProcess(pid)) return false;
+    m_watching = true;
+    return true;
+}
+
+static qint64 toMs(std::chrono::system_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+}
+
+void SamplingEngine::recordInto(MetricHistory& history)
+{
+    MetricHistory* h = &history;
+
+    const auto cpuUsage = h->series("cpu.usage");
+    const auto cpuClock = h->series("cpu.clock");
+    const auto cpuTemp = h->series("cpu.temperature.max");
+    auto coreIds = std::make_shared<std::vector<MetricHistory::SeriesId>>();
+    onCpu([=](const Snapshot<CpuStats>& s) {
+        const qint64 t = toMs(s.timestamp);
+        h->append(cpuUsage, t, s.value.cpuUsage);
+        h->append(cpuClock, t, s.value.cpuClock);
+        if (s.value.temperatures.max >= 0) h->append(cpuTemp, t, s.value.temperatures.max);
+
+        const CpuUtilization& u = s.value.perCore;
+        for (std::size_t i = 0; i < u.cpuId.size(); ++i) {
+            const std::size_t cpu = std::size_t(u.cpuId[i]);
+            if (cpu >= coreIds->size()) coreIds->resize(cpu + 1, -1);
+            MetricHistory::SeriesId& id = (*coreIds)[cpu];
+            if (id < 0)
+                id = h->series("cpu.core" + std::to_string(cpu) + ".usage", MetricHistory::compactConfig());
+            h->append(id, t, u.usage[i]);
+        }
+    });
+
+    const auto memUsed = h->series("mem.used");
+    const auto swapUsed = h->series("mem.swapUsed");
+    onMem([=](const Snapshot<MemStats>& s) {
+        const qint64 t = toMs(s.timestamp);
+        h->append(memUsed, t, double(s.value.used));
+        h->append(swapUsed, t, double(s.value.swapUsed));
+    });
+
+    const auto procCount = h->series("proc.count");
+    const auto threadCount = h->series("proc.threads");
+    onProcesses([=](const Snapshot<ProcessThreadTotals>& s) {
+        const qint64 t = toMs(s.timestamp);
+        h->append(procCount, t, s.value.processCount);
+        h->append(threadCount, t, double(s.value.threadCount));
+    });
+}
+
+void SamplingEngine::recordTo(RecordingWriter& writer, std::chrono::milliseconds interval)
+{
+    RecordingWriter* w = &writer;
+    m_tasks.push_back({interval, {}, [this, w] {
+        const auto cpu = m_cpu.load();
+        const auto mem = m_mem.load();
+        const auto processes = m_processes.load();
+        if (!cpu || !mem || !processes) return; // not every metric sampled yet
+
+        RecordedSample sample;
+        sample.timeMs = toMs(std::chrono::system_clock::now());
+        sample.cpu = cpu->value;
+        sample.mem = mem->value;
+        sample.processes = processes->value;
+        w->append(sample);
+    }});
+}
+
+void SamplingEngine::streamTo(StreamAgent& agent, std::chrono::milliseconds interval)
+{
+    StreamAgent* a = &agent;
+    m_tasks.push_back({interval, {}, [this, a] {
+        const auto cpu = m_cpu.load();
+        const auto mem = m_mem.load();
+        const auto processes = m_processes.load();
+        if (!cpu || !mem || !processes) return; // not every metric sampled yet
+
+        RecordedSample sample;
+        sample.timeMs = toMs(std::chrono::system_clock::now());
+        sample.cpu = cpu->value;
+        sample.mem = mem->value;
+        sample.processes = processes->value;
+        a->send(sample);
+    }});
+}
+
+void SamplingEngine::exportTo(MetricsExporter& exporter)
+{
+    MetricsExporter* e = &exporter;
+    onCpu([e](const Snapshot<CpuStats>& s) { e->updateCpu(s.value); });
+    onMem([e](const Snapshot<MemStats>& s) { e->updateMem(s.value); });
+    onProcesses([e](const Snapshot<ProcessThreadTotals>& s) { e->updateProcesses(s.value); });
+    onSelf([e](const Snapshot<SelfStats>& s) { e->updateSelf(s.value); });
+}
+
+void SamplingEngine::publishTo(SharedSnapshotPublisher& publisher, std::chrono::milliseconds historyInterval)
+{
+    SharedSnapshotPublisher* p = &publisher;
+    onCpu([p](const Snapshot<CpuStats>& s) { p->publishCpu(s.value, toMs(s.timestamp)); });
+    onMem([p](const Snapshot<MemStats>& s) { p->publishMem(s.value, toMs(s.timestamp)); });
+    onProcesses([p](const Snapshot<ProcessThreadTotals>& s) { p->publishProcesses(s.value, toMs(s.timestamp)); });
+    m_tasks.push_back({historyInterval, {}, [p] {
+        p->appendHistory(toMs(std::chrono::system_clock::now()));
+    }});
+}
+
+void SamplingEngine::evaluateRules(RuleEngine& rules)
+{
+    RuleEngine* r = &rules;
+    onCpu([r](const Snapshot<CpuStats>& s) { r->updateCpu(s.value, toMs(s.timestamp)); });
+    onMem([r](const Snapshot<MemStats>& s) { r->updateMem(s.value, toMs(s.timestamp)); });
+    onProcesses([r](const Snapshot<ProcessThreadTotals>& s) { r->updateProcesses(s.value, toMs(s.timestamp)); });
+}
+
+SamplingEngine::~SamplingEngine()
+{
+    stop();
+}
+
+void SamplingEngine::start()
+{
+    if (m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+    }
+    const auto now = Clock::now();
+    for (Task& t : m_tasks) t.due = now;
+    m_thread = std::thread([this] { run(); });
+}
+
+void SamplingEngine::stop()
+{
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void SamplingEngine::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        auto next = Clock::time_point::max();
+        for (const Task& t : m_tasks) next = std::min(next, t.due);
+
+        if (m_wake.wait_until(lock, next, [this] { return m_stop; })) break;
+
+        // Collect outside the lock so stop() is never held up by /proc I/O
+        lock.unlock();
+        const auto now = Clock::now();
+        for (Task& t : m_tasks) {
+            if (t.due > now) continue;
+            t.collect();
+            t.due += t.interval;
+            // Fell behind (slow scan, suspend): skip the missed ticks
+            if (t.due <= now) t.due = now + t.interval;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <core/ISystemMonitor.h>
+#include <core/MetricHistory.h>
+#include <core/MetricsExporter.h>
+#include <core/Recording.h>
+#include <core/RuleEngine.h>
+#include <core/SharedSnapshot.h>
+#include <core/StreamAgent.h>
+#include <core/Snapshot.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the ISystemMonitor collectors on a dedicated thread, each metric on
+// its own cadence, and publishes every result as an immutable snapshot.
+// Readers on any thread fetch the latest snapshot without touching /proc or
+// waiting for a collector to finish.
+class SamplingEngine {
+public:
+    struct Cadence {
+        std::chrono::milliseconds cpu{250};
+        std::chrono::milliseconds mem{1000};
+        std::chrono::milliseconds processes{5000};
+        std::chrono::milliseconds pressure{2000};   // the kernel updates PSI averages every 2 s
+        std::chrono::milliseconds self{10000};      // getSelfStats(), the collectors' own cost
+        std::chrono::milliseconds threads{100};     // getThreadTable(), once something is watched
+    };
+
+    // The engine owns the monitor and calls into it from the sampling thread,
+    // except watchProcess()/unwatchProcess(), which forward on the caller's
+    // thread while getThreadTable() may be running: implementations must
+    // make those two thread-safe (see ISystemMonitor).
+    explicit SamplingEngine(std::unique_ptr<ISystemMonitor> monitor);
+    SamplingEngine(std::unique_ptr<ISystemMonitor> monitor, Cadence cadence);
+    ~SamplingEngine();
+
+    SamplingEngine(const SamplingEngine&) = delete;
+    SamplingEngine& operator=(const SamplingEngine&) = delete;
+
+    // Metrics to collect (Metric::* bits), default everything. CPU fields
+    // outside the mask keep their defaults; without Metric::Memory,
+    // Metric::Processes or Metric::Pressure those snapshots are never
+    // published. Set before start().
+    void setFields(MetricMask fields) { m_fields = fields; }
+
+    // Also rank the n heaviest processes by key on the processes cadence.
+    // The ranking and the process/thread totals then come from one walk of
+    // /proc (getTopProcesses()). Set before start().
+    void setTopProcesses(int n, ProcessSortKey key) { m_topCount = n; m_topKey = key; }
+
+    // Listeners run on the sampling thread right after each publish.
+    // Register them before start().
+    void onCpu(std::function<void(const Snapshot<CpuStats>&)> fn) { m_cpuListeners.push_back(std::move(fn)); }
+    void onMem(std::function<void(const Snapshot<MemStats>&)> fn) { m_memListeners.push_back(std::move(fn)); }
+    void onProcesses(std::function<void(const Snapshot<ProcessThreadTotals>&)> fn) { m_processListeners.push_back(std::move(fn)); }
+    void onPressure(std::function<void(const Snapshot<PressureStats>&)> fn) { m_pressureListeners.push_back(std::move(fn)); }
+    void onTopProcesses(std::function<void(const Snapshot<TopProcesses>&)> fn) { m_topListeners.push_back(std::move(fn)); }
+    void onSelf(std::function<void(const Snapshot<SelfStats>&)> fn) { m_selfListeners.push_back(std::move(fn)); }
+    void onThreads(std::function<void(const Snapshot<ThreadTable>&)> fn) { m_threadListeners.push_back(std::move(fn)); }
+
+    // Adds or removes a process on the monitor's thread watch list; safe
+    // from any thread, before or after start(). Thread tables are collected
+    // on the threads cadence from the first successful watchProcess().
+    bool watchProcess(qint32 pid);
+    void unwatchProcess(qint32 pid) { m_monitor->unwatchProcess(pid); }
+
+    // Appends every published sample to history (cpu.usage, cpu.core<N>.usage,
+    // cpu.clock, cpu.temperature.max, mem.used, mem.swapUsed, proc.count,
+    // proc.threads). Per-core series use MetricHistory::compactConfig().
+    void recordInto(MetricHistory& history);
+
+    // Every interval, appends the latest cpu/mem/process snapshots to writer
+    // as one sample. The writer must outlive the engine's thread.
+    void recordTo(RecordingWriter& writer, std::chrono::milliseconds interval = std::chrono::seconds(1));
+
+    // Every interval, sends the latest cpu/mem/process snapshots to an
+    // aggregator as one sample. The agent must outlive the engine's thread.
+    void streamTo(StreamAgent& agent, std::chrono::milliseconds interval = std::chrono::seconds(1));
+
+    // Re-renders the exporter's /metrics response whenever a metric is
+    // published. The exporter must outlive the engine's thread.
+    void exportTo(MetricsExporter& exporter);
+
+    // Publishes every sample into a shared-memory segment for
+    // SharedMemorySystemMonitor clients, and appends to its history ring
+    // every historyInterval. The publisher must outlive the engine's thread.
+    void publishTo(SharedSnapshotPublisher& publisher,
+                   std::chrono::milliseconds historyInterval = std::chrono::seconds(1));
+
+    // Evaluates rules against every cpu/mem/process sample as it is
+    // published; events fire on the engine's thread. The rule engine must
+    // outlive the engine's thread.
+    void evaluateRules(RuleEngine& rules);
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    SnapshotSlot<CpuStats>::Ptr cpu() const { return m_cpu.load(); }
+    SnapshotSlot<MemStats>::Ptr mem() const { return m_mem.load(); }
+    SnapshotSlot<ProcessThreadTotals>::Ptr processes() const { return m_processes.load(); }
+    SnapshotSlot<PressureStats>::Ptr pressure() const { return m_pressure.load(); }
+    SnapshotSlot<TopProcesses>::Ptr topProcesses() const { return m_top.load(); }
+    SnapshotSlot<SelfStats>::Ptr self() const { return m_self.load(); }
+    SnapshotSlot<ThreadTable>::Ptr threads() const { return m_threads.load(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::chrono::milliseconds interval;
+        Clock::time_point due;
+        std::function<void()> collect;
+    };
+
+    void run();
+
+    std::unique_ptr<ISystemMonitor> m_monitor;
+    Cadence m_cadence;
+    MetricMask m_fields = Metric::All;
+    int m_topCount = 0;
+    ProcessSortKey m_topKey = ProcessSortKey::Cpu;
+    std::vector<Task> m_tasks;
+
+    SnapshotSlot<CpuStats> m_cpu;
+    SnapshotSlot<MemStats> m_mem;
+    SnapshotSlot<ProcessThreadTotals> m_processes;
+    SnapshotSlot<PressureStats> m_pressure;
+    SnapshotSlot<TopProcesses> m_top;
+    SnapshotSlot<SelfStats> m_self;
+    SnapshotSlot<ThreadTable> m_threads;
+
+    std::vector<std::function<void(const Snapshot<CpuStats>&)>> m_cpuListeners;
+    std::vector<std::function<void(const Snapshot<MemStats>&)>> m_memListeners;
+    std::vector<std::function<void(const Snapshot<ProcessThreadTotals>&)>> m_processListeners;
+    std::vector<std::function<void(const Snapshot<PressureStats>&)>> m_pressureListeners;
+    std::vector<std::function<void(const Snapshot<TopProcesses>&)>> m_topListeners;
+    std::vector<std::function<void(const Snapshot<SelfStats>&)>> m_selfListeners;
+    std::vector<std::function<void(const Snapshot<ThreadTable>&)>> m_threadListeners;
+    std::atomic<bool> m_watching{false};
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
@@ -0,0 +1,80 @@
+#include <core/SelfInstrumentation.h>
+#include <algorithm>
+#include <cmath>
+
+// -------- LatencyHistogram --------
+int LatencyHistogram::bucketOf(quint64 ns)
+{
+    if (ns < quint64(kSub)) return int(ns);
+    const quint64 clamped = std::min(ns, (quint64(2) << kMaxExponent) - 1);
+#if defined(__GNUC__) || defined(__clang__)
+    const int exponent = 63 - __builtin_clzll(clamped);
+#else
+    int exponent = kSubBits;
+    while (clamped >> (exponent + 1)) ++exponent;
+#endif
+    // Top kSubBits + 1 bits: kSub..2*kSub-1
+    const int mantissa = int(clamped >> (exponent - kSubBits));
+    return (exponent - kSubBits) * kSub + mantissa;
+}
+
+double LatencyHistogram::midpointOf(int bucket)
+{
+    if (bucket < kSub) return double(bucket);
+    const int exponent = bucket / kSub + kSubBits - 1;
+    const int mantissa = bucket % kSub + kSub;
+    const double width = std::ldexp(1.0, exponent - kSubBits);
+    return double(mantissa) * width + (width - 1.0) / 2.0;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+    const quint64 ns = duration.count() > 0 ? quint64(duration.count()) : 0;
+    m_buckets[std::size_t(bucketOf(ns))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    quint64 max = m_maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !m_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::quantilesNs(const double* qs, double* out, int count) const
+{
+    // Copy first so every quantile is taken from the same counts
+    std::array<quint64, kBuckets> counts;
+    quint64 total = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        counts[std::size_t(i)] = m_buckets[std::size_t(i)].load(std::memory_order_relaxed);
+        total += counts[std::size_t(i)];
+    }
+    const double max = double(maxNs());
+
+    int bucket = 0;
+    quint64 seen = counts[0];
+    for (int k = 0; k < count; ++k) {
+        if (total == 0) { out[k] = 0.0; continue; }
+        const quint64 rank = std::max<quint64>(1, quint64(std::ceil(std::clamp(qs[k], 0.0, 1.0) * double(total))));
+        while (seen < rank && bucket + 1 < kBuckets) seen += counts[std::size_t(++bucket)];
+        out[k] = std::min(midpointOf(bucket), max);
+    }
+}
+
+// -------- CollectorProbe --------
+CollectorStats CollectorProbe::stats() const
+{
+    CollectorStats s;
+    s.name = QString::fromUtf8(m_name);
+    s.calls = m_latency.count();
+    s.syscalls = m_syscalls.load(std::memory_order_relaxed);
+    s.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+    s.totalSeconds = double(m_latency.sumNs()) / 1e9;
+    s.meanUs = s.calls ? double(m_latency.sumNs()) / double(s.calls) / 1000.0 : 0.0;
+    const double qs[] = {0.50, 0.90, 0.99};
+    double ns[3];
+    m_latency.quantilesNs(qs, ns, 3);
+    s.p50Us = ns[0] / 1000.0;
+    s.p90Us = ns[1] / 1000.0;
+    s.p99Us = ns[2] / 1000.0;
+    s.maxUs = double(m_latency.maxNs()) / 1000.0;
+    return s;
+}
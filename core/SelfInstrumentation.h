@@ -0,0 +1,121 @@
+#pragma once
+
+#include <core/SelfStats.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+// Latency histogram that any number of threads record into without locks.
+// Buckets are log-linear as in HdrHistogram: values below 32 ns are exact,
+// above that every power of two is split into 32 buckets, so a bucket is
+// never wider than ~3% of its value. Values are clamped at 2^41 ns (~36 min).
+// Recording is a handful of relaxed atomic adds; reading walks the buckets
+// and may see a recording half-applied, which only skews the estimate.
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds duration);
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    quint64 sumNs() const { return m_sumNs.load(std::memory_order_relaxed); }
+    quint64 maxNs() const { return m_maxNs.load(std::memory_order_relaxed); }
+
+    // Value at quantile q in [0, 1], the midpoint of its bucket; 0 when empty
+    double quantileNs(double q) const { double v = 0; quantilesNs(&q, &v, 1); return v; }
+    // Several quantiles (ascending) in one walk over the buckets
+    void quantilesNs(const double* qs, double* out, int count) const;
+
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSub = 1 << kSubBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBuckets = (kMaxExponent - kSubBits + 2) * kSub;
+
+    static int bucketOf(quint64 ns);
+    static double midpointOf(int bucket);
+
+    std::array<std::atomic<quint64>, kBuckets> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumNs{0};
+    std::atomic<quint64> m_maxNs{0};
+};
+
+// Duration histogram plus syscall and byte counters of one collector
+class CollectorProbe {
+public:
+    explicit CollectorProbe(const char* name) : m_name(name) {}
+
+    CollectorProbe(const CollectorProbe&) = delete;
+    CollectorProbe& operator=(const CollectorProbe&) = delete;
+
+    void record(std::chrono::nanoseconds duration) { m_latency.record(duration); }
+    void countSyscalls(quint64 calls, quint64 bytes)
+    {
+        m_syscalls.fetch_add(calls, std::memory_order_relaxed);
+        if (bytes) m_bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    CollectorStats stats() const;
+
+private:
+    const char* m_name;
+    LatencyHistogram m_latency;
+    std::atomic<quint64> m_syscalls{0};
+    std::atomic<quint64> m_bytesRead{0};
+};
+
+namespace selfprobe {
+
+// Collector the calling thread is working for; nullptr outside any ProbeScope
+inline thread_local CollectorProbe* t_current = nullptr;
+
+// Charges syscalls (and the bytes they read) to the current collector.
+// Readers call this next to every hot-path syscall; outside a collector it
+// is a thread-local load and a branch.
+inline void countSyscalls(quint64 calls, quint64 bytes = 0)
+{
+    if (CollectorProbe* p = t_current) p->countSyscalls(calls, bytes);
+}
+
+} // namespace selfprobe
+
+// Times the enclosing block into probe and makes it the thread's current
+// collector, so syscalls made inside are charged to it. Scopes nest; the
+// innermost one gets the syscalls, every one gets its own duration.
+class ProbeScope {
+public:
+    explicit ProbeScope(CollectorProbe& probe)
+        : m_probe(probe)
+        , m_outer(selfprobe::t_current)
+        , m_start(std::chrono::steady_clock::now())
+    {
+        selfprobe::t_current = &probe;
+    }
+
+    ~ProbeScope()
+    {
+        m_probe.record(std::chrono::steady_clock::now() - m_start);
+        selfprobe::t_current = m_outer;
+    }
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+
+private:
+    CollectorProbe& m_probe;
+    CollectorProbe* m_outer;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Makes probe current on a helper thread without timing anything, so work
+// handed to a pool is charged to the collector that handed it out
+class ProbeAttach {
+public:
+    explicit ProbeAttach(CollectorProbe* probe) : m_outer(selfprobe::t_current) { selfprobe::t_current = probe; }
+    ~ProbeAttach() { selfprobe::t_current = m_outer; }
+
+    ProbeAttach(const ProbeAttach&) = delete;
+    ProbeAttach& operator=(const ProbeAttach&) = delete;
+
+private:
+    CollectorProbe* m_outer;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
+
+// ----- The monitor's own cost -----
+// Cumulative since the monitor was created. Latencies are wall time per
+// call, from a log-linear histogram (about 3% resolution).
+struct CollectorStats {
+    QString name;               // "cpu.usage", "memory", "processes", ...
+    quint64 calls = 0;
+    quint64 syscalls = 0;       // reads, opens, closes and directory reads on the hot path
+    quint64 bytesRead = 0;
+    double totalSeconds = 0;    // summed over every call
+    double meanUs = 0;
+    double p50Us = 0;
+    double p90Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+};
+
+struct SelfStats {
+    std::vector<CollectorStats> collectors;
+    double cpuSeconds = 0;      // user + system time of the whole process; 0 if unknown
+};
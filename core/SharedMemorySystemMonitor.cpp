@@ -0,0 +1,163 @@
+#include <core/SharedMemorySystemMonitor.h>
+#include <algorithm>
+#include <chrono>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SharedMemorySystemMonitor::SharedMemorySystemMonitor(std::string name)
+    : m_name(std::move(name))
+{
+    attach();
+}
+
+SharedMemorySystemMonitor::~SharedMemorySystemMonitor()
+{
+#ifndef _WIN32
+    if (m_segment) ::munmap(const_cast<shm::Segment*>(m_segment), sizeof(shm::Segment));
+#endif
+}
+
+bool SharedMemorySystemMonitor::attach()
+{
+    if (m_segment) return true;
+#ifdef _WIN32
+    return false;
+#else
+    const int fd = ::shm_open(m_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) != sizeof(shm::Segment)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = ::mmap(nullptr, sizeof(shm::Segment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const auto* segment = static_cast<const shm::Segment*>(p);
+    // The publisher stores magic last; its acquire load orders the header after it
+    if (segment->magic.load(std::memory_order_acquire) != shm::kMagic
+        || segment->version != shm::kVersion || segment->size != sizeof(shm::Segment)) {
+        ::munmap(p, sizeof(shm::Segment));
+        return false;
+    }
+    m_segment = segment;
+    return true;
+#endif
+}
+
+qint64 SharedMemorySystemMonitor::publisherAgeMs() const
+{
+    if (!m_segment) return -1;
+    const qint64 now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return now - m_segment->heartbeatMs.load(std::memory_order_relaxed);
+}
+
+CpuStats SharedMemorySystemMonitor::getCpuStats()
+{
+    return getCpuStats(Metric::Cpu);
+}
+
+CpuStats SharedMemorySystemMonitor::getCpuStats(MetricMask fields)
+{
+    if (!attach()) return {};
+
+    CpuStats out;
+    const shm::CpuData& d = m_segment->cpu.data;
+    // Counts are re-read and clamped inside the retry loop: a torn read of
+    // them must not index past the arrays
+    const bool ok = shm::readSection(m_segment->cpu.seq, [&] {
+        out.cpuUsage = d.usage;
+        CpuTimeShares& t = out.cpuTimes;
+        double* times[8] = {&t.user, &t.nice, &t.system, &t.idle, &t.iowait, &t.irq, &t.softirq, &t.steal};
+        for (int i = 0; i < 8; ++i) *times[i] = d.times[i];
+        out.cpuClock = d.clock;
+        out.cpuTemperature = d.temperature;
+        out.temperatures.max = d.temperatureMax;
+        out.cores.averageFreq = d.averageFreq;
+        out.cores.totalCores = d.totalCores;
+
+        if (fields & Metric::CpuPerCore) {
+            const std::size_t rows = std::size_t(std::clamp(d.perCoreCount, 0, shm::kMaxCpus));
+            CpuUtilization& u = out.perCore;
+            u.cpuId.assign(d.cpuId, d.cpuId + rows);
+            std::vector<double>* columns[9] = {&u.usage, &u.user, &u.nice, &u.system, &u.idle,
+                                               &u.iowait, &u.irq, &u.softirq, &u.steal};
+            for (int c = 0; c < 9; ++c) columns[c]->assign(d.perCore[c], d.perCore[c] + rows);
+        }
+
+        if (fields & Metric::CpuFrequency) {
+            const std::size_t freqs = std::size_t(std::clamp(d.freqCount, 0, shm::kMaxCpus));
+            out.cores.coreFreq.assign(d.coreFreq, d.coreFreq + freqs);
+        }
+
+        if (fields & Metric::CpuTemperature) {
+            const std::size_t packages = std::size_t(std::clamp(d.packageCount, 0, shm::kMaxPackages));
+            out.temperatures.packages.assign(d.packages, d.packages + packages);
+
+            const std::size_t cores = std::size_t(std::clamp(d.coreTempCount, 0, shm::kMaxCpus));
+            out.temperatures.cores.resize(cores);
+            for (std::size_t i = 0; i < cores; ++i) {
+                out.temperatures.cores[i].package = d.coreTemps[i].package;
+                out.temperatures.cores[i].core = d.coreTemps[i].core;
+                out.temperatures.cores[i].celsius = d.coreTemps[i].celsius;
+            }
+        }
+    });
+    if (!ok) return m_lastCpu;
+    m_lastCpu = out;
+    return out;
+}
+
+MemStats SharedMemorySystemMonitor::getMemStats()
+{
+    if (!attach()) return {};
+    MemStats out;
+    if (!shm::readSection(m_segment->mem.seq, [&] { out = m_segment->mem.data.mem; })) return m_lastMem;
+    m_lastMem = out;
+    return out;
+}
+
+ProcessThreadTotals SharedMemorySystemMonitor::getProcessThreadCount()
+{
+    if (!attach()) return {};
+    ProcessThreadTotals out;
+    const shm::ProcessData& d = m_segment->processes.data;
+    if (!shm::readSection(m_segment->processes.seq, [&] {
+            out.processCount = d.processCount;
+            out.threadCount = d.threadCount;
+        }))
+        return m_lastProcesses;
+    m_lastProcesses = out;
+    return out;
+}
+
+std::vector<RecordedSample> SharedMemorySystemMonitor::history()
+{
+    std::vector<RecordedSample> out;
+    if (!attach()) return out;
+
+    std::vector<shm::HistorySample> ring;
+    const shm::HistoryData& d = m_segment->history.data;
+    const bool ok = shm::readSection(m_segment->history.seq, [&] {
+        const quint32 count = std::min(d.count, quint32(shm::kHistoryCapacity));
+        const quint32 head = d.head % quint32(shm::kHistoryCapacity);
+        ring.resize(count);
+        // Oldest sample sits at head once the ring has wrapped
+        const quint32 first = (head + quint32(shm::kHistoryCapacity) - count) % quint32(shm::kHistoryCapacity);
+        for (quint32 i = 0; i < count; ++i)
+            ring[i] = d.ring[(first + i) % quint32(shm::kHistoryCapacity)];
+    });
+    if (!ok) return out;
+
+    out.reserve(ring.size());
+    for (const shm::HistorySample& h : ring) out.push_back(shm::toRecordedSample(h));
+    return out;
+}
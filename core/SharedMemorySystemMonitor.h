@@ -0,0 +1,45 @@
+#pragma once
+
+#include <core/ISystemMonitor.h>
+#include <core/SharedSnapshot.h>
+#include <string>
+#include <vector>
+
+// Serves the samples a SharedSnapshotPublisher keeps in shared memory
+// (statsTest --publish) instead of scanning /proc and /sys itself. Once
+// attached, every getter is a seqlock-checked copy out of a read-only
+// mapping, with no syscalls. Until the segment exists, each getter retries
+// attaching and returns empty stats.
+class SharedMemorySystemMonitor : public ISystemMonitor {
+public:
+    explicit SharedMemorySystemMonitor(std::string name = "/sysmon");
+    ~SharedMemorySystemMonitor() override;
+
+    SharedMemorySystemMonitor(const SharedMemorySystemMonitor&) = delete;
+    SharedMemorySystemMonitor& operator=(const SharedMemorySystemMonitor&) = delete;
+
+    bool isAttached() const { return m_segment != nullptr; }
+    // Milliseconds since the publisher last wrote, -1 if not attached. A
+    // large value means the daemon is gone and the data is stale.
+    qint64 publisherAgeMs() const;
+
+    CpuStats getCpuStats() override;
+    // Skips copying the per-core, frequency and temperature arrays unless asked
+    CpuStats getCpuStats(MetricMask fields) override;
+    MemStats getMemStats() override;
+    ProcessThreadTotals getProcessThreadCount() override;
+
+    // The shared history ring, oldest first (scalar fields only)
+    std::vector<RecordedSample> history();
+
+private:
+    bool attach();
+
+    std::string m_name;
+    const shm::Segment* m_segment = nullptr;
+
+    // Served when the writer keeps a section busy past the retry budget
+    CpuStats m_lastCpu;
+    MemStats m_lastMem;
+    ProcessThreadTotals m_lastProcesses;
+};
@@ -0,0 +1,203 @@
+#include <core/SharedSnapshot.h>
+#include <algorithm>
+#include <chrono>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RecordedSample shm::toRecordedSample(const HistorySample& h)
+{
+    RecordedSample s;
+    s.timeMs = h.timeMs;
+    s.cpu.cpuUsage = h.cpuUsage;
+    s.cpu.cpuClock = h.cpuClock;
+    s.cpu.cpuTemperature = h.cpuTemperature;
+    s.cpu.cores.totalCores = h.totalCores;
+    s.cpu.cores.averageFreq = h.averageFreq;
+    s.cpu.temperatures.max = h.temperatureMax;
+    s.mem = h.mem;
+    s.processes.processCount = h.processCount;
+    s.processes.threadCount = h.threadCount;
+    return s;
+}
+
+SharedSnapshotPublisher::~SharedSnapshotPublisher()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool SharedSnapshotPublisher::open(const std::string&)
+{
+    return false;
+}
+
+void SharedSnapshotPublisher::close(bool)
+{
+}
+
+#else
+
+bool SharedSnapshotPublisher::open(const std::string& name)
+{
+    close();
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    // A segment from an older layout cannot be shared; start a fresh one
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size != 0 && std::size_t(st.st_size) != sizeof(shm::Segment)) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+    }
+    if (::ftruncate(fd, sizeof(shm::Segment)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* p = ::mmap(nullptr, sizeof(shm::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    m_segment = static_cast<shm::Segment*>(p);
+    m_name = name;
+
+    // Clients attaching while the header is rewritten wait for the new magic
+    m_segment->magic.store(0, std::memory_order_relaxed);
+
+    // A previous publisher may have died mid-write; even out every sequence
+    for (std::atomic<quint32>* seq : {&m_segment->cpu.seq, &m_segment->mem.seq,
+                                      &m_segment->processes.seq, &m_segment->history.seq}) {
+        const quint32 s = seq->load(std::memory_order_relaxed);
+        if (s & 1) seq->store(s + 1, std::memory_order_release);
+    }
+
+    m_segment->version = shm::kVersion;
+    m_segment->size = sizeof(shm::Segment);
+    m_segment->writerPid = qint32(::getpid());
+    m_segment->magic.store(shm::kMagic, std::memory_order_release);
+    return true;
+}
+
+void SharedSnapshotPublisher::close(bool unlink)
+{
+    if (m_segment) {
+        ::munmap(m_segment, sizeof(shm::Segment));
+        m_segment = nullptr;
+    }
+    if (unlink && !m_name.empty()) ::shm_unlink(m_name.c_str());
+    m_name.clear();
+}
+
+#endif
+
+template <typename T, typename Write>
+void SharedSnapshotPublisher::writeSection(shm::Section<T>& section, Write&& write)
+{
+    const quint32 s = section.seq.load(std::memory_order_relaxed);
+    section.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    write(section.data);
+    section.seq.store(s + 2, std::memory_order_release);
+
+    const qint64 now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_segment->heartbeatMs.store(now, std::memory_order_relaxed);
+}
+
+void SharedSnapshotPublisher::publishCpu(const CpuStats& cpu, qint64 timeMs)
+{
+    m_latest.cpuUsage = cpu.cpuUsage;
+    m_latest.cpuClock = cpu.cpuClock;
+    m_latest.cpuTemperature = cpu.cpuTemperature;
+    m_latest.averageFreq = cpu.cores.averageFreq;
+    m_latest.temperatureMax = cpu.temperatures.max;
+    m_latest.totalCores = cpu.cores.totalCores;
+    if (!m_segment) return;
+
+    writeSection(m_segment->cpu, [&](shm::CpuData& d) {
+        d.timeMs = timeMs;
+        ++d.sequence;
+        d.usage = cpu.cpuUsage;
+        const CpuTimeShares& t = cpu.cpuTimes;
+        const double times[8] = {t.user, t.nice, t.system, t.idle, t.iowait, t.irq, t.softirq, t.steal};
+        std::copy(times, times + 8, d.times);
+        d.clock = cpu.cpuClock;
+        d.temperature = cpu.cpuTemperature;
+        d.temperatureMax = cpu.temperatures.max;
+        d.averageFreq = cpu.cores.averageFreq;
+        d.totalCores = cpu.cores.totalCores;
+
+        const CpuUtilization& u = cpu.perCore;
+        const std::size_t rows = std::min<std::size_t>(u.cpuId.size(), shm::kMaxCpus);
+        d.perCoreCount = qint32(rows);
+        std::copy_n(u.cpuId.begin(), rows, d.cpuId);
+        const std::vector<double>* columns[9] = {&u.usage, &u.user, &u.nice, &u.system, &u.idle,
+                                                 &u.iowait, &u.irq, &u.softirq, &u.steal};
+        for (int c = 0; c < 9; ++c) {
+            const std::size_t n = std::min(rows, columns[c]->size());
+            std::copy_n(columns[c]->begin(), n, d.perCore[c]);
+            std::fill(d.perCore[c] + n, d.perCore[c] + rows, 0.0);
+        }
+
+        const std::vector<double>& freq = cpu.cores.coreFreq;
+        d.freqCount = qint32(std::min<std::size_t>(freq.size(), shm::kMaxCpus));
+        std::copy_n(freq.begin(), d.freqCount, d.coreFreq);
+
+        const std::vector<double>& packages = cpu.temperatures.packages;
+        d.packageCount = qint32(std::min<std::size_t>(packages.size(), shm::kMaxPackages));
+        std::copy_n(packages.begin(), d.packageCount, d.packages);
+
+        const std::vector<CoreTemperature>& cores = cpu.temperatures.cores;
+        d.coreTempCount = qint32(std::min<std::size_t>(cores.size(), shm::kMaxCpus));
+        for (qint32 i = 0; i < d.coreTempCount; ++i) {
+            d.coreTemps[i].package = cores[std::size_t(i)].package;
+            d.coreTemps[i].core = cores[std::size_t(i)].core;
+            d.coreTemps[i].celsius = cores[std::size_t(i)].celsius;
+        }
+    });
+}
+
+void SharedSnapshotPublisher::publishMem(const MemStats& mem, qint64 timeMs)
+{
+    m_latest.mem = mem;
+    if (!m_segment) return;
+    writeSection(m_segment->mem, [&](shm::MemData& d) {
+        d.timeMs = timeMs;
+        ++d.sequence;
+        d.mem = mem;
+    });
+}
+
+void SharedSnapshotPublisher::publishProcesses(const ProcessThreadTotals& totals, qint64 timeMs)
+{
+    m_latest.processCount = totals.processCount;
+    m_latest.threadCount = totals.threadCount;
+    if (!m_segment) return;
+    writeSection(m_segment->processes, [&](shm::ProcessData& d) {
+        d.timeMs = timeMs;
+        ++d.sequence;
+        d.processCount = totals.processCount;
+        d.threadCount = totals.threadCount;
+    });
+}
+
+void SharedSnapshotPublisher::appendHistory(qint64 timeMs)
+{
+    if (!m_segment) return;
+    m_latest.timeMs = timeMs;
+    writeSection(m_segment->history, [&](shm::HistoryData& d) {
+        if (d.head >= quint32(shm::kHistoryCapacity)) d.head = 0;
+        d.ring[d.head] = m_latest;
+        d.head = (d.head + 1) % quint32(shm::kHistoryCapacity);
+        if (d.count < quint32(shm::kHistoryCapacity)) ++d.count;
+    });
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <core/MemStats.h>
+#include <core/ProcessStats.h>
+#include <core/Recording.h>
+#include <atomic>
+#include <string>
+
+// Latest samples plus a short history ring in a POSIX shared-memory segment,
+// so one sampler can serve many local clients (SharedMemorySystemMonitor).
+//
+// The segment is a fixed-size POD layout. Each section (cpu, memory,
+// processes, history) has its own seqlock: the single writer makes the
+// sequence odd, writes, and makes it even again; a reader copies the section
+// and retries if the sequence was odd or moved meanwhile. Readers never
+// write to the segment and never make a syscall.
+//
+// Per-core arrays are capped at kMaxCpus, packages at kMaxPackages. Sensor
+// names (CpuTemperatures::sensors) are not shared.
+namespace shm {
+
+constexpr quint64 kMagic = 0x314D48534D535953;    // "SYSMSHM1" read as little-endian
+constexpr quint32 kVersion = 2;    // 2: MemStats carries the full meminfo
+constexpr int kMaxCpus = 1024;
+constexpr int kMaxPackages = 16;
+constexpr int kHistoryCapacity = 600;   // 10 minutes at the default 1 s
+
+static_assert(std::atomic<quint32>::is_always_lock_free, "seqlock needs address-free atomics");
+static_assert(std::atomic<qint64>::is_always_lock_free, "heartbeat needs address-free atomics");
+static_assert(std::atomic<quint64>::is_always_lock_free, "magic needs address-free atomics");
+
+struct CpuData {
+    qint64 timeMs;
+    quint64 sequence;
+    double usage;
+    double times[8];                // CpuTimeShares order: user .. steal
+    double clock;
+    double temperature;
+    double temperatureMax;
+    double averageFreq;
+    qint32 totalCores;
+    qint32 perCoreCount;            // rows in cpuId/perCore
+    qint32 freqCount;               // entries in coreFreq
+    qint32 packageCount;
+    qint32 coreTempCount;
+    qint32 cpuId[kMaxCpus];
+    double perCore[9][kMaxCpus];    // usage, then the eight CpuTimeShares modes
+    double coreFreq[kMaxCpus];
+    double packages[kMaxPackages];
+    struct { qint16 package; qint16 core; double celsius; } coreTemps[kMaxCpus];
+};
+
+struct MemData {
+    qint64 timeMs;
+    quint64 sequence;
+    MemStats mem;
+};
+
+struct ProcessData {
+    qint64 timeMs;
+    quint64 sequence;
+    qint32 processCount;
+    qint64 threadCount;
+};
+
+// The scalar fields of RecordedSample
+struct HistorySample {
+    qint64 timeMs;
+    double cpuUsage;
+    double cpuClock;
+    double cpuTemperature;
+    double averageFreq;
+    double temperatureMax;
+    qint32 totalCores;
+    qint32 processCount;
+    qint64 threadCount;
+    MemStats mem;
+};
+
+struct HistoryData {
+    quint32 head;                   // next slot to write
+    quint32 count;
+    HistorySample ring[kHistoryCapacity];
+};
+
+template <typename T>
+struct alignas(64) Section {
+    std::atomic<quint32> seq;
+    T data;
+};
+
+struct Segment {
+    // Stored last with release once the header is filled in; readers load
+    // it with acquire before touching anything else
+    std::atomic<quint64> magic;
+    quint32 version;
+    quint32 size;                   // sizeof(Segment)
+    qint32 writerPid;
+    std::atomic<qint64> heartbeatMs;    // wall clock of the last publish
+    Section<CpuData> cpu;
+    Section<MemData> mem;
+    Section<ProcessData> processes;
+    Section<HistoryData> history;
+};
+
+// Copies a section consistently; false if the writer kept it busy for all
+// attempts (or died mid-write).
+template <typename Copy>
+bool readSection(const std::atomic<quint32>& seq, Copy&& copy)
+{
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const quint32 before = seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        copy();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == before) return true;
+    }
+    return false;
+}
+
+RecordedSample toRecordedSample(const HistorySample& h);
+
+} // namespace shm
+
+// Writer side: creates (or reuses) the segment and publishes into it. One
+// publisher per segment name.
+class SharedSnapshotPublisher {
+public:
+    SharedSnapshotPublisher() = default;
+    ~SharedSnapshotPublisher();
+
+    SharedSnapshotPublisher(const SharedSnapshotPublisher&) = delete;
+    SharedSnapshotPublisher& operator=(const SharedSnapshotPublisher&) = delete;
+
+    // name is a shm_open() name such as "/sysmon". A segment of the same
+    // layout is reused so attached clients keep their mapping; one with a
+    // different layout is replaced. POSIX only; fails on Windows.
+    bool open(const std::string& name);
+    // Unmaps; unlink also removes the name so new clients cannot attach.
+    void close(bool unlink = false);
+    bool isOpen() const { return m_segment != nullptr; }
+
+    void publishCpu(const CpuStats& cpu, qint64 timeMs);
+    void publishMem(const MemStats& mem, qint64 timeMs);
+    void publishProcesses(const ProcessThreadTotals& totals, qint64 timeMs);
+    // Appends the latest published values to the history ring
+    void appendHistory(qint64 timeMs);
+
+private:
+    template <typename T, typename Write>
+    void writeSection(shm::Section<T>& section, Write&& write);
+
+    shm::Segment* m_segment = nullptr;
+    std::string m_name;
+    shm::HistorySample m_latest{};
+};
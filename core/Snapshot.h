@@ -0,0 +1,151 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// One immutable, timestamped sample of a metric.
+template <typename T>
+struct Snapshot {
+    std::chrono::system_clock::time_point timestamp{};
+    quint64 sequence = 0;   // 1 for the first sample, +1 per publish
+    T value{};
+};
+
+template <typename T>
+class SnapshotSlot;
+
+// Counted reference to a published snapshot; the snapshot lives until its
+// slot moved on and the last SnapshotPtr to it is gone. Copying, releasing
+// and dereferencing never lock or allocate.
+template <typename T>
+class SnapshotPtr {
+public:
+    SnapshotPtr() = default;
+    SnapshotPtr(const SnapshotPtr& other) : m_node(other.m_node) { retain(); }
+    SnapshotPtr(SnapshotPtr&& other) noexcept : m_node(std::exchange(other.m_node, nullptr)) {}
+    ~SnapshotPtr() { release(); }
+
+    SnapshotPtr& operator=(SnapshotPtr other) noexcept
+    {
+        std::swap(m_node, other.m_node);
+        return *this;
+    }
+
+    const Snapshot<T>* get() const { return m_node; }
+    const Snapshot<T>& operator*() const { return *m_node; }
+    const Snapshot<T>* operator->() const { return m_node; }
+    explicit operator bool() const { return m_node != nullptr; }
+
+private:
+    friend class SnapshotSlot<T>;
+
+    struct Node : Snapshot<T> {
+        std::atomic<long> refs{1};
+    };
+
+    // Adopts a reference the caller already took
+    explicit SnapshotPtr(Node* node) : m_node(node) {}
+
+    void retain() const
+    {
+        if (m_node) m_node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release()
+    {
+        if (m_node && m_node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete m_node;
+        m_node = nullptr;
+    }
+
+    Node* m_node = nullptr;
+};
+
+// Latest snapshot of one metric, RCU-style: the single writer builds a new
+// Snapshot and swaps an atomic pointer to it in; readers take a counted
+// reference to whatever is current and keep it alive for as long as they
+// hold it.
+//
+// load() is wait-free: a few atomic RMWs and loads, no retry loop, no lock
+// and no allocation, so a reader never waits for the collector or for other
+// readers. The slot's own reference to a replaced snapshot is dropped later
+// (deferred reclamation), once no load() can still be between reading the
+// pointer and counting its reference. Readers count themselves in one of two
+// counters picked by the parity of the publish count, so the other one drains
+// and a replaced snapshot is reclaimed within a publish or two even under a
+// steady stream of readers.
+template <typename T>
+class SnapshotSlot {
+public:
+    using Ptr = SnapshotPtr<T>;
+    using Node = typename SnapshotPtr<T>::Node;
+
+    SnapshotSlot() = default;
+    SnapshotSlot(const SnapshotSlot&) = delete;
+    SnapshotSlot& operator=(const SnapshotSlot&) = delete;
+
+    ~SnapshotSlot()
+    {
+        // No reader may run any more; held references keep their snapshots
+        if (Node* n = m_current.exchange(nullptr)) drop(n);
+        for (const Retired& r : m_retired) drop(r.node);
+    }
+
+    // Empty until the first publish
+    Ptr load() const
+    {
+        std::atomic<std::size_t>& readers = m_readers[m_epoch.load(std::memory_order_relaxed) & 1];
+        readers.fetch_add(1);
+        Node* n = m_current.load();
+        if (n) n->refs.fetch_add(1, std::memory_order_relaxed);
+        readers.fetch_sub(1, std::memory_order_release);
+        return Ptr(n);
+    }
+
+    Ptr publish(T value, std::chrono::system_clock::time_point timestamp)
+    {
+        Node* next = new Node;
+        next->timestamp = timestamp;
+        next->sequence = ++m_sequence;  // single writer
+        next->value = std::move(value);
+        next->refs.store(2, std::memory_order_relaxed);     // the slot's and the returned one
+        if (Node* old = m_current.exchange(next)) m_retired.push_back({old, m_sequence});
+        m_epoch.fetch_add(1);
+        reclaim();
+        return Ptr(next);
+    }
+
+private:
+    struct Retired {
+        Node* node;
+        quint64 replacedBy;     // sequence of the publish that swapped it out
+    };
+
+    // A counter seen at zero after publish s admits no reader that could
+    // still pick up what s replaced: anyone counted later loads the pointer
+    // after the swap. Every seq_cst op orders these checks after it.
+    void reclaim()
+    {
+        for (int p = 0; p < 2; ++p)
+            if (m_readers[p].load() == 0) m_quiet[p] = m_sequence;
+        const quint64 safe = std::min(m_quiet[0], m_quiet[1]);
+        std::size_t kept = 0;
+        for (const Retired& r : m_retired) {
+            if (r.replacedBy <= safe) drop(r.node);
+            else m_retired[kept++] = r;
+        }
+        m_retired.resize(kept);
+    }
+
+    static void drop(Node* n) { Ptr adopted(n); }
+
+    std::atomic<Node*> m_current{nullptr};
+    std::atomic<unsigned> m_epoch{0};
+    mutable std::atomic<std::size_t> m_readers[2] = {};     // load() calls in progress, by epoch parity
+    std::vector<Retired> m_retired;                         // writer only
+    quint64 m_quiet[2] = {0, 0};                            // last publish each counter was seen idle after
+    quint64 m_sequence = 0;
+};
@@ -0,0 +1,149 @@
+#include <core/StreamAgent.h>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::chrono::milliseconds kMinBackoff{1000};
+constexpr std::chrono::milliseconds kMaxBackoff{30000};
+
+} // namespace
+
+StreamAgent::StreamAgent(std::string node)
+    : m_node(std::move(node))
+{
+}
+
+StreamAgent::~StreamAgent()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool StreamAgent::open(const std::string&)
+{
+    return false;
+}
+
+void StreamAgent::close()
+{
+}
+
+bool StreamAgent::send(const RecordedSample&)
+{
+    ++m_dropped;
+    return false;
+}
+
+#else
+
+bool StreamAgent::open(const std::string& target)
+{
+    close();
+    if (!StreamEndpoint::parse(target, m_endpoint)) return false;
+    m_open = true;
+    m_retryAt = Clock::time_point{};
+    m_backoff = kMinBackoff;
+    return true;
+}
+
+void StreamAgent::close()
+{
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_connecting = false;
+    m_open = false;
+    m_out.clear();
+    m_outOffset = 0;
+}
+
+void StreamAgent::disconnect(Clock::time_point now)
+{
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_connecting = false;
+    m_out.clear();
+    m_outOffset = 0;
+    m_retryAt = now + m_backoff;
+    m_backoff = std::min(m_backoff * 2, kMaxBackoff);
+}
+
+// Starts or finishes connecting; true once the stream can take frames
+bool StreamAgent::connected(Clock::time_point now)
+{
+    if (!m_open) return false;
+    if (m_fd < 0) {
+        if (now < m_retryAt) return false;
+        m_fd = m_endpoint.connect();
+        if (m_fd < 0) {
+            disconnect(now);
+            return false;
+        }
+        m_connecting = true;
+    }
+    if (m_connecting) {
+        pollfd p{m_fd, POLLOUT, 0};
+        if (::poll(&p, 1, 0) == 0) return false;   // still in progress
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (::getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0) {
+            disconnect(now);
+            return false;
+        }
+        m_connecting = false;
+        m_backoff = kMinBackoff;
+        ++m_connects;
+        m_encoder.reset();
+        m_encoder.hello(m_node, m_out);
+    }
+    return true;
+}
+
+// Writes as much of the queue as the socket takes; false on error
+bool StreamAgent::flush()
+{
+    while (m_outOffset < m_out.size()) {
+        const ssize_t n = ::send(m_fd, m_out.data() + m_outOffset, m_out.size() - m_outOffset,
+                                 MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            m_outOffset += std::size_t(n);
+            m_bytes += quint64(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    if (m_outOffset == m_out.size()) {
+        m_out.clear();
+        m_outOffset = 0;
+    }
+    return true;
+}
+
+bool StreamAgent::send(const RecordedSample& sample)
+{
+    const Clock::time_point now = Clock::now();
+    if (!connected(now)) {
+        ++m_dropped;
+        return false;
+    }
+
+    m_encoder.sample(sample, m_out);
+    if (!flush() || m_out.size() - m_outOffset > kMaxBacklogBytes) {
+        disconnect(now);
+        ++m_dropped;
+        return false;
+    }
+    ++m_sent;
+    return true;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <core/StreamProtocol.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Agent side of the aggregator stream (see StreamProtocol.h). Never blocks
+// the caller: the socket is non-blocking, a connect in progress is checked
+// on the next send, and frames the socket cannot take yet are queued. A
+// sample is dropped while there is no connection; a connection whose queue
+// outgrows kMaxBacklogBytes is dropped, since the stream cannot skip a
+// frame. Reconnects back off from 1 s to 30 s and start a new stream.
+//
+// Not thread-safe; POSIX only (open() fails on Windows).
+class StreamAgent {
+public:
+    static constexpr std::size_t kMaxBacklogBytes = 64 * 1024;
+
+    explicit StreamAgent(std::string node);
+    ~StreamAgent();
+
+    StreamAgent(const StreamAgent&) = delete;
+    StreamAgent& operator=(const StreamAgent&) = delete;
+
+    // "host:port" or "unix:/path"; connects on the first send()
+    bool open(const std::string& target);
+    void close();
+
+    // False if the sample was dropped
+    bool send(const RecordedSample& sample);
+
+    bool isConnected() const { return m_fd >= 0 && !m_connecting; }
+    quint64 samplesSent() const { return m_sent; }
+    quint64 samplesDropped() const { return m_dropped; }
+    quint64 bytesSent() const { return m_bytes; }
+    quint64 connects() const { return m_connects; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool connected(Clock::time_point now);
+    bool flush();
+    void disconnect(Clock::time_point now);
+
+    std::string m_node;
+    StreamEndpoint m_endpoint;
+    bool m_open = false;
+    int m_fd = -1;
+    bool m_connecting = false;
+    Clock::time_point m_retryAt{};
+    std::chrono::milliseconds m_backoff{1000};
+
+    StreamEncoder m_encoder;
+    std::vector<unsigned char> m_out;       // queued bytes, from m_outOffset
+    std::size_t m_outOffset = 0;
+
+    quint64 m_sent = 0;
+    quint64 m_dropped = 0;
+    quint64 m_bytes = 0;
+    quint64 m_connects = 0;
+};
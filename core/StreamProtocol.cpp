@@ -0,0 +1,352 @@
+#include <core/StreamProtocol.h>
+#include <core/DeltaCodec.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using deltacodec::bitsOf;
+using deltacodec::doubleOf;
+using deltacodec::getVarint;
+using deltacodec::getXor;
+using deltacodec::putVarint;
+using deltacodec::putXor;
+using deltacodec::unzigzag;
+using deltacodec::wrappingAdd;
+using deltacodec::wrappingSub;
+using deltacodec::zigzag;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'Y', 'S', 'M', 'S', 'T', 'R', '1'};
+constexpr unsigned char kHello = 1;
+constexpr unsigned char kSample = 2;
+
+constexpr std::size_t kIntFields = 10;
+constexpr std::size_t kFloatFields = 9;
+constexpr std::size_t kMaxNodeName = 255;
+
+// ----- field table -----
+void extractInts(const RecordedSample& s, qint64* v)
+{
+    v[0] = s.cpu.cores.totalCores;
+    v[1] = qint64(s.mem.total);
+    v[2] = qint64(s.mem.used);
+    v[3] = qint64(s.mem.free);
+    v[4] = qint64(s.mem.available);
+    v[5] = qint64(s.mem.committed);
+    v[6] = qint64(s.mem.swapUsed);
+    v[7] = qint64(s.mem.swapTotal);
+    v[8] = s.processes.processCount;
+    v[9] = s.processes.threadCount;
+}
+
+void applyInts(const qint64* v, RecordedSample& s)
+{
+    s.cpu.cores.totalCores = qint32(v[0]);
+    s.mem.total = quint64(v[1]);
+    s.mem.used = quint64(v[2]);
+    s.mem.free = quint64(v[3]);
+    s.mem.available = quint64(v[4]);
+    s.mem.committed = quint64(v[5]);
+    s.mem.swapUsed = quint64(v[6]);
+    s.mem.swapTotal = quint64(v[7]);
+    s.processes.processCount = qint32(v[8]);
+    s.processes.threadCount = v[9];
+}
+
+void extractFloats(const RecordedSample& s, double* v)
+{
+    v[0] = s.cpu.cpuUsage;
+    v[1] = s.cpu.cpuClock;
+    v[2] = s.cpu.cpuTemperature;
+    v[3] = s.cpu.cores.averageFreq;
+    v[4] = s.cpu.temperatures.max;
+    v[5] = s.cpu.cpuTimes.user;
+    v[6] = s.cpu.cpuTimes.system;
+    v[7] = s.cpu.cpuTimes.iowait;
+    v[8] = s.cpu.cpuTimes.steal;
+}
+
+void applyFloats(const double* v, RecordedSample& s)
+{
+    s.cpu.cpuUsage = v[0];
+    s.cpu.cpuClock = v[1];
+    s.cpu.cpuTemperature = v[2];
+    s.cpu.cores.averageFreq = v[3];
+    s.cpu.temperatures.max = v[4];
+    s.cpu.cpuTimes.user = v[5];
+    s.cpu.cpuTimes.system = v[6];
+    s.cpu.cpuTimes.iowait = v[7];
+    s.cpu.cpuTimes.steal = v[8];
+}
+
+void putFrame(std::vector<unsigned char>& out, unsigned char type, const std::vector<unsigned char>& payload)
+{
+    out.push_back(type);
+    putVarint(out, payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+} // namespace
+
+// -------- Encoder --------
+void StreamEncoder::hello(const std::string& node, std::vector<unsigned char>& out)
+{
+    if (!m_headerSent) {
+        out.insert(out.end(), kMagic, kMagic + sizeof(kMagic));
+        m_headerSent = true;
+    }
+    const std::string name = node.substr(0, kMaxNodeName);
+    m_payload.clear();
+    putVarint(m_payload, kIntFields);
+    putVarint(m_payload, kFloatFields);
+    putVarint(m_payload, name.size());
+    m_payload.insert(m_payload.end(), name.begin(), name.end());
+    putFrame(out, kHello, m_payload);
+
+    m_first = true;
+    m_prevTimeMs = m_prevDelta = 0;
+    m_prevInts.assign(kIntFields, 0);
+    m_prevBits.assign(kFloatFields, 0);
+}
+
+void StreamEncoder::sample(const RecordedSample& s, std::vector<unsigned char>& out)
+{
+    qint64 ints[kIntFields];
+    double floats[kFloatFields];
+    extractInts(s, ints);
+    extractFloats(s, floats);
+
+    m_payload.clear();
+    if (m_first) {
+        putVarint(m_payload, zigzag(s.timeMs));
+        m_prevDelta = 0;
+        m_first = false;
+    } else {
+        const qint64 delta = wrappingSub(s.timeMs, m_prevTimeMs);
+        putVarint(m_payload, zigzag(wrappingSub(delta, m_prevDelta)));
+        m_prevDelta = delta;
+    }
+    m_prevTimeMs = s.timeMs;
+
+    for (std::size_t i = 0; i < kIntFields; ++i) {
+        putVarint(m_payload, zigzag(wrappingSub(ints[i], m_prevInts[i])));
+        m_prevInts[i] = ints[i];
+    }
+    for (std::size_t i = 0; i < kFloatFields; ++i) {
+        const quint64 bits = bitsOf(floats[i]);
+        putXor(m_payload, bits ^ m_prevBits[i]);
+        m_prevBits[i] = bits;
+    }
+    putFrame(out, kSample, m_payload);
+}
+
+void StreamEncoder::reset()
+{
+    m_headerSent = false;
+    m_first = true;
+}
+
+// -------- Decoder --------
+StreamDecoder::Result StreamDecoder::next(const unsigned char* data, std::size_t size, std::size_t& used,
+                                          RecordedSample& out)
+{
+    used = 0;
+    const unsigned char* p = data;
+    const unsigned char* end = data + size;
+
+    if (!m_headerSeen) {
+        const std::size_t n = std::min(size, sizeof(kMagic));
+        if (std::memcmp(p, kMagic, n) != 0) return Result::Error;
+        if (n < sizeof(kMagic)) return Result::NeedMore;
+        p += sizeof(kMagic);
+    }
+
+    if (p == end) return Result::NeedMore;
+    const unsigned char type = *p++;
+    quint64 bytes = 0;
+    const unsigned char* lenStart = p;
+    if (!getVarint(p, end, bytes)) {
+        // Truncated length, unless it is already too long to be valid
+        return (end - lenStart >= 10) ? Result::Error : Result::NeedMore;
+    }
+    if (bytes > kStreamMaxFrameBytes) return Result::Error;
+    if (quint64(end - p) < bytes) return Result::NeedMore;
+    const unsigned char* frameEnd = p + bytes;
+
+    if (type == kHello) {
+        quint64 ints = 0, floats = 0, nameBytes = 0;
+        if (!getVarint(p, frameEnd, ints) || !getVarint(p, frameEnd, floats)
+            || !getVarint(p, frameEnd, nameBytes) || nameBytes > quint64(frameEnd - p))
+            return Result::Error;
+        if (ints != kIntFields || floats != kFloatFields) return Result::Error;
+        m_node.assign(reinterpret_cast<const char*>(p), std::size_t(nameBytes));
+        m_helloSeen = true;
+        m_first = true;
+        m_prevTimeMs = m_prevDelta = 0;
+        m_prevInts.assign(kIntFields, 0);
+        m_prevBits.assign(kFloatFields, 0);
+        m_headerSeen = true;
+        used = std::size_t(frameEnd - data);
+        return Result::Hello;
+    }
+    if (type != kSample || !m_helloSeen) return Result::Error;
+
+    quint64 zz = 0;
+    if (!getVarint(p, frameEnd, zz)) return Result::Error;
+    if (m_first) {
+        m_prevTimeMs = unzigzag(zz);
+        m_prevDelta = 0;
+        m_first = false;
+    } else {
+        m_prevDelta = wrappingAdd(m_prevDelta, unzigzag(zz));
+        m_prevTimeMs = wrappingAdd(m_prevTimeMs, m_prevDelta);
+    }
+    out.timeMs = m_prevTimeMs;
+
+    qint64 ints[kIntFields];
+    for (std::size_t i = 0; i < kIntFields; ++i) {
+        if (!getVarint(p, frameEnd, zz)) return Result::Error;
+        m_prevInts[i] = wrappingAdd(m_prevInts[i], unzigzag(zz));
+        ints[i] = m_prevInts[i];
+    }
+    double floats[kFloatFields];
+    for (std::size_t i = 0; i < kFloatFields; ++i) {
+        quint64 x = 0;
+        if (!getXor(p, frameEnd, x)) return Result::Error;
+        m_prevBits[i] ^= x;
+        floats[i] = doubleOf(m_prevBits[i]);
+    }
+    if (p != frameEnd) return Result::Error;
+
+    applyInts(ints, out);
+    applyFloats(floats, out);
+    used = std::size_t(frameEnd - data);
+    return Result::Sample;
+}
+
+// -------- Endpoint --------
+bool StreamEndpoint::parse(const std::string& spec, StreamEndpoint& out)
+{
+    out = StreamEndpoint();
+    if (spec.rfind("unix:", 0) == 0) {
+        out.unixPath = spec.substr(5);
+        return !out.unixPath.empty();
+    }
+
+    const std::size_t colon = spec.rfind(':');
+    if (colon == std::string::npos) return false;
+    std::string host = spec.substr(0, colon);
+    const std::string portText = spec.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+    if (host.empty()) host = "127.0.0.1";
+
+    char* end = nullptr;
+    const unsigned long p = std::strtoul(portText.c_str(), &end, 10);
+    if (portText.empty() || *end || p > 65535) return false;
+    out.host = host;
+    out.port = quint16(p);
+    return true;
+}
+
+#ifdef _WIN32
+
+int StreamEndpoint::connect() const
+{
+    return -1;
+}
+
+int StreamEndpoint::listen(int) const
+{
+    return -1;
+}
+
+#else
+
+namespace {
+
+bool toSockaddr(const StreamEndpoint& e, sockaddr_storage& addr, socklen_t& len)
+{
+    addr = sockaddr_storage();
+    if (!e.unixPath.empty()) {
+        auto* un = reinterpret_cast<sockaddr_un*>(&addr);
+        if (e.unixPath.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        std::memcpy(un->sun_path, e.unixPath.c_str(), e.unixPath.size() + 1);
+        len = socklen_t(offsetof(sockaddr_un, sun_path) + e.unixPath.size() + 1);
+        return true;
+    }
+    auto* v4 = reinterpret_cast<sockaddr_in*>(&addr);
+    auto* v6 = reinterpret_cast<sockaddr_in6*>(&addr);
+    if (::inet_pton(AF_INET, e.host.c_str(), &v4->sin_addr) == 1) {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(e.port);
+        len = sizeof(sockaddr_in);
+        return true;
+    }
+    if (::inet_pton(AF_INET6, e.host.c_str(), &v6->sin6_addr) == 1) {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(e.port);
+        len = sizeof(sockaddr_in6);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int StreamEndpoint::connect() const
+{
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    if (!toSockaddr(*this, addr, len)) return -1;
+
+    const int fd = ::socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (addr.ss_family != AF_UNIX) {
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 && errno != EINPROGRESS) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int StreamEndpoint::listen(int backlog) const
+{
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    if (!toSockaddr(*this, addr, len)) return -1;
+
+    const int fd = ::socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (addr.ss_family == AF_UNIX) {
+        // Replace a socket left behind by an earlier run, never a regular file
+        struct stat st {};
+        if (::lstat(unixPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) ::unlink(unixPath.c_str());
+    } else {
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || ::listen(fd, backlog) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#endif
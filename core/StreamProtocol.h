@@ -0,0 +1,83 @@
+#pragma once
+
+#include <core/Recording.h>
+#include <QtCore/qtypes.h>
+#include <string>
+#include <vector>
+
+// Binary agent -> aggregator stream, over TCP or a Unix stream socket.
+//
+// Stream:  "SYSMSTR1" | frame*
+// Frame:   u8 type | varint payloadBytes | payload
+//   Hello  (1): varint intFields | varint floatFields | varint nameBytes | name
+//   Sample (2): timestamp (absolute zigzag varint after a Hello, then a
+//               zigzag varint delta-of-delta), integer fields as zigzag
+//               varint deltas, doubles XORed with their previous value; see
+//               DeltaCodec.h
+//
+// Every Hello resets the delta state, so an agent that reconnects starts a
+// new stream. An unchanged field costs one byte: a frame is 23 bytes when
+// nothing moved and 50-65 when every field did.
+//
+// Samples carry the scalar CpuStats, MemStats and ProcessThreadTotals fields:
+// those of a recording plus mem.available, mem.committed and the CPU time
+// shares (user, system, iowait, steal).
+
+constexpr std::size_t kStreamMaxFrameBytes = 1024;
+
+class StreamEncoder {
+public:
+    // Appends the stream header (first call only) and a Hello frame
+    void hello(const std::string& node, std::vector<unsigned char>& out);
+    // Appends one Sample frame
+    void sample(const RecordedSample& s, std::vector<unsigned char>& out);
+
+    // Forget everything; the next hello() starts a new stream
+    void reset();
+
+private:
+    bool m_headerSent = false;
+    bool m_first = true;
+    qint64 m_prevTimeMs = 0;
+    qint64 m_prevDelta = 0;
+    std::vector<qint64> m_prevInts;
+    std::vector<quint64> m_prevBits;
+    std::vector<unsigned char> m_payload;
+};
+
+class StreamDecoder {
+public:
+    enum class Result { NeedMore, Hello, Sample, Error };
+
+    // Decodes the next frame of [data, data + size) and sets used to the
+    // bytes it took; NeedMore (used = 0) until a whole frame is there. After
+    // Error the stream is unusable.
+    Result next(const unsigned char* data, std::size_t size, std::size_t& used, RecordedSample& out);
+
+    // Name from the last Hello
+    const std::string& node() const { return m_node; }
+
+private:
+    bool m_headerSeen = false;
+    bool m_helloSeen = false;
+    bool m_first = true;
+    qint64 m_prevTimeMs = 0;
+    qint64 m_prevDelta = 0;
+    std::vector<qint64> m_prevInts;
+    std::vector<quint64> m_prevBits;
+    std::string m_node;
+};
+
+// "host:port" (IPv4/IPv6 literal, "[::1]:port") or "unix:/path"
+struct StreamEndpoint {
+    std::string host;
+    quint16 port = 0;
+    std::string unixPath;           // set for Unix sockets
+
+    static bool parse(const std::string& spec, StreamEndpoint& out);
+
+    // Non-blocking, close-on-exec sockets; -1 on failure. connect() may
+    // return a socket whose connect is still in progress.
+    int connect() const;
+    int listen(int backlog) const;
+};
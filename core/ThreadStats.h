@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QtCore/qtypes.h>
+#include <QString>
+#include <vector>
+
+// ----- Per-thread view of watched processes -----
+// Counters are cumulative; rates cover the interval since the previous
+// table and are 0 for a thread seen for the first time.
+struct ThreadStats {
+    qint32 tid = 0;
+    QString comm;
+    char state = '?';               // R, S, D, ...
+    qint32 processor = -1;          // CPU it last ran on
+
+    // stat
+    quint64 utime = 0;              // clock ticks
+    quint64 stime = 0;              // clock ticks
+    // schedstat; all 0 on kernels without CONFIG_SCHED_INFO
+    quint64 runNs = 0;              // on a CPU
+    quint64 waitNs = 0;             // runnable, waiting on a run queue
+    quint64 timeslices = 0;
+    // status
+    quint64 voluntarySwitches = 0;
+    quint64 involuntarySwitches = 0;
+
+    double cpuPercent = 0;          // 100 = one full core; from runNs where available
+    double userPercent = 0;         // from utime/stime, tick resolution
+    double systemPercent = 0;
+    double runDelayPercent = 0;     // share of the interval spent waiting for a CPU
+    double voluntaryPerSec = 0;
+    double involuntaryPerSec = 0;
+};
+
+struct WatchedProcess {
+    qint32 pid = 0;
+    QString comm;
+    bool alive = true;              // false in the table where it exited; it is then unwatched
+    std::vector<ThreadStats> threads;   // ascending tid
+    std::vector<qint32> added;      // tids that appeared since the previous table; empty in the first
+    std::vector<qint32> exited;     // tids that went away since the previous table
+};
+
+struct ThreadTable {
+    std::vector<WatchedProcess> processes;
+    double intervalSeconds = 0;     // 0 on the first table
+};
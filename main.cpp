@@ -1,7 +1,11 @@
 // main.cpp
 #include <QCoreApplication>
+#include <QCommandLineParser>
 #include <QTimer>
 #include <QDebug>
+#include <QSysInfo>
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 
 // Core API (your domain types + interface)
@@ -9,6 +13,16 @@
 #include <core/CpuStats.h>
 #include <core/MemStats.h>
 #include <core/ProcessStats.h>
+#include <core/SamplingEngine.h>
+#include <core/MetricHistory.h>
+#include <core/Recording.h>
+#include <core/ReplaySystemMonitor.h>
+#include <core/MetricsExporter.h>
+#include <core/MetricsHttpServer.h>
+#include <core/SharedSnapshot.h>
+#include <core/SharedMemorySystemMonitor.h>
+#include <core/RuleEngine.h>
+#include <core/StreamAgent.h>
 
 // Pick the concrete implementation for this platform
 #if defined(Q_OS_MAC)
@@ -16,6 +30,7 @@
 using MonitorImpl = MacSystemMonitor;
 #elif defined(Q_OS_LINUX)
 #include <platform/linux/LinuxSystemMonitor.h>
+#include <platform/linux/PressureTriggers.h>
 using MonitorImpl = LinuxSystemMonitor;
 #elif defined(Q_OS_WIN)
 #include <platform/win/WinSystemMonitor.h>
@@ -24,23 +39,94 @@ using MonitorImpl = WindowsSystemMonitor;
 #error "Unsupported platform"
 #endif
 
-static std::unique_ptr<ISystemMonitor> g_monitor;
+static std::unique_ptr<SamplingEngine> g_engine;
+static MetricHistory g_history;
+static RecordingWriter g_recorder;
+static MetricsExporter g_exporter;
+static std::unique_ptr<MetricsHttpServer> g_metricsServer;
+static SharedSnapshotPublisher g_publisher;
+static RuleEngine g_rules;
+static std::unique_ptr<StreamAgent> g_agent;
+
+// "9105", "0.0.0.0:9105" or "[::1]:9105"; the address defaults to loopback
+static bool parseListen(const QString& spec, std::string& address, quint16& port)
+{
+    const std::string s = spec.toStdString();
+    const std::size_t colon = s.rfind(':');
+    std::string host = colon == std::string::npos ? "127.0.0.1" : s.substr(0, colon);
+    const std::string portText = colon == std::string::npos ? s : s.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+
+    char* end = nullptr;
+    const unsigned long p = std::strtoul(portText.c_str(), &end, 10);
+    if (portText.empty() || *end || p > 65535) return false;
+    address = host;
+    port = quint16(p);
+    return true;
+}
+
+#if defined(Q_OS_LINUX)
+// "memory:some:150:1000" = memory, some tasks stalled 150 ms within 1000 ms
+static bool addPressureTrigger(PressureTriggers& triggers, const QString& spec)
+{
+    const QStringList parts = spec.split(':');
+    if (parts.size() != 4) return false;
+
+    PressureResource resource;
+    if (parts[0] == "cpu") resource = PressureResource::Cpu;
+    else if (parts[0] == "memory") resource = PressureResource::Memory;
+    else if (parts[0] == "io") resource = PressureResource::Io;
+    else return false;
+
+    PressureKind kind;
+    if (parts[1] == "some") kind = PressureKind::Some;
+    else if (parts[1] == "full") kind = PressureKind::Full;
+    else return false;
+
+    bool stallOk = false, windowOk = false;
+    const qlonglong stallMs = parts[2].toLongLong(&stallOk);
+    const qlonglong windowMs = parts[3].toLongLong(&windowOk);
+    if (!stallOk || !windowOk) return false;
+
+    return triggers.add(resource, kind, std::chrono::milliseconds(stallMs), std::chrono::milliseconds(windowMs),
+                        [spec](const PressureEvent&) {
+                            qWarning().noquote() << "Pressure stall:" << spec;
+                        }) >= 0;
+}
+#endif
 
 static void printOnce()
 {
-    const CpuStats cpu = g_monitor->getCpuStats();
-    const MemStats mem = g_monitor->getMemStats();
-    const ProcessThreadTotals pt = g_monitor->getProcessThreadCount();
+    // Latest published samples; nothing to show until each metric ran once
+    const auto cpuSnap = g_engine->cpu();
+    const auto memSnap = g_engine->mem();
+    const auto ptSnap = g_engine->processes();
+    if (!cpuSnap || !memSnap || !ptSnap) return;
+
+    const CpuStats& cpu = cpuSnap->value;
+    const MemStats& mem = memSnap->value;
+    const ProcessThreadTotals& pt = ptSnap->value;
 
     // CPU headline
     qDebug().noquote()
         << "CPU Usage:" << QString::number(cpu.cpuUsage, 'f', 1) + "%"
         << "| Avg Freq:" << QString::number(cpu.cores.averageFreq, 'f', 0) + " MHz";
 
+    // Trend over the last minute from the history store
+    const qint64 nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        cpuSnap->timestamp.time_since_epoch()).count();
+    const MetricHistory::Bucket lastMinute =
+        g_history.summarize(g_history.find("cpu.usage"), nowMs - 60'000, nowMs + 1);
+    if (lastMinute.count > 0)
+        qDebug().noquote() << "CPU 1m avg:" << QString::number(lastMinute.avg, 'f', 1) + "%"
+                           << "| 1m max:" << QString::number(lastMinute.max, 'f', 1) + "%";
+
     // Per-core (if available)
-    if (!cpu.cores.coresMap.empty()) {
+    if (!cpu.cores.coreFreq.empty()) {
         QStringList lines;
-        for (const auto& [coreId, mhz] : cpu.cores.coresMap) {
+        for (int coreId = 0; coreId < int(cpu.cores.coreFreq.size()); ++coreId) {
+            const double mhz = cpu.cores.coreFreq[coreId];
+            if (mhz <= 0) continue; // offline or unknown
             lines << QString("Core %1: %2 MHz").arg(coreId).arg(mhz, 0, 'f', 0);
         }
         qDebug().noquote() << "Per-core:" << lines.join(", ");
@@ -48,7 +134,8 @@ static void printOnce()
 
     // Temperature (if your struct uses -1 for N/A)
     if (cpu.cpuTemperature >= 0.0)
-        qDebug().noquote() << "Temp:" << QString::number(cpu.cpuTemperature, 'f', 1) + " °C";
+        qDebug().noquote() << "Temp:" << QString::number(cpu.cpuTemperature, 'f', 1) + " °C"
+                           << "| Max:" << QString::number(cpu.temperatures.max, 'f', 1) + " °C";
     else
         qDebug().noquote() << "Temp: N/A";
 
@@ -60,10 +147,51 @@ static void printOnce()
                        << (mem.swapUsed / (1024*1024)) << "MB /"
                        << (mem.swapTotal / (1024*1024)) << "MB";
 
+    // Stall averages over the last 10 s (Linux PSI)
+    if (const auto psSnap = g_engine->pressure(); psSnap && psSnap->value.cpu.available) {
+        const PressureStats& ps = psSnap->value;
+        qDebug().noquote() << "Pressure avg10 some:"
+                           << "cpu" << QString::number(ps.cpu.some.avg10, 'f', 2) + "%"
+                           << "| memory" << QString::number(ps.memory.some.avg10, 'f', 2) + "%"
+                           << "| io" << QString::number(ps.io.some.avg10, 'f', 2) + "%";
+    }
+
     // Processes / threads
     qDebug().noquote() << "Processes:" << pt.processCount
                        << "| Threads:" << pt.threadCount;
 
+    // Heaviest processes (--top)
+    if (const auto topSnap = g_engine->topProcesses()) {
+        for (const ProcessInfo& p : topSnap->value.processes)
+            qDebug().noquote() << QString("%1").arg(p.pid, 7)
+                               << QString::number(p.cpuPercent, 'f', 1).rightJustified(6) + "%"
+                               << QString::number(p.rssBytes / (1024 * 1024)).rightJustified(6) + " MB"
+                               << QString::number(p.threads).rightJustified(4) + " thr"
+                               << (p.cmdline.isEmpty() ? "[" + p.comm + "]" : p.cmdline.left(60));
+    }
+
+    // Busiest threads of every watched process (--watch-pid)
+    if (const auto thrSnap = g_engine->threads()) {
+        for (const WatchedProcess& w : thrSnap->value.processes) {
+            qDebug().noquote() << "Watched" << w.pid << "[" + w.comm + "]"
+                               << (w.alive ? QString("%1 threads").arg(w.threads.size()) : QString("exited"))
+                               << "| +" + QString::number(w.added.size()) << "-" + QString::number(w.exited.size());
+            std::vector<const ThreadStats*> busiest;
+            for (const ThreadStats& t : w.threads) busiest.push_back(&t);
+            const std::size_t keep = std::min<std::size_t>(busiest.size(), 5);
+            std::partial_sort(busiest.begin(), busiest.begin() + std::ptrdiff_t(keep), busiest.end(),
+                              [](const ThreadStats* a, const ThreadStats* b) { return a->cpuPercent > b->cpuPercent; });
+            for (std::size_t i = 0; i < keep; ++i) {
+                const ThreadStats& t = *busiest[i];
+                qDebug().noquote() << QString("%1").arg(t.tid, 9)
+                                   << QString::number(t.cpuPercent, 'f', 1).rightJustified(6) + "%"
+                                   << "wait" << QString::number(t.runDelayPercent, 'f', 1).rightJustified(5) + "%"
+                                   << "cs/s" << QString::number(t.voluntaryPerSec + t.involuntaryPerSec, 'f', 0).rightJustified(6)
+                                   << "cpu" << t.processor << QString::fromLatin1(&t.state, 1) << t.comm;
+            }
+        }
+    }
+
     qDebug().noquote() << "Core count:" << (cpu.cores.totalCores) << "Cores";
 
     qDebug() << "-----------------------------";
@@ -73,14 +201,154 @@ int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
 
-    g_monitor = std::make_unique<MonitorImpl>();
+    QCommandLineParser parser;
+    parser.setApplicationDescription("System monitor");
+    parser.addHelpOption();
+    const QCommandLineOption recordOpt("record", "Append 1 s samples to <file>.", "file");
+    const QCommandLineOption replayOpt("replay", "Show a recording instead of this host.", "file");
+    const QCommandLineOption fastOpt("replay-fast", "Replay as fast as possible instead of in real time.");
+    parser.addOption(recordOpt);
+    parser.addOption(replayOpt);
+    parser.addOption(fastOpt);
+    const QCommandLineOption metricsOpt("metrics", "Serve OpenMetrics on http://<[address:]port>/metrics.", "listen");
+    parser.addOption(metricsOpt);
+    const QCommandLineOption publishOpt("publish", "Share samples with local clients through shared memory <name>.", "name");
+    const QCommandLineOption attachOpt("attach", "Read samples published by another instance under <name>.", "name");
+    parser.addOption(publishOpt);
+    parser.addOption(attachOpt);
+    const QCommandLineOption topOpt("top", "List the <n> heaviest processes.", "n");
+    const QCommandLineOption topByOpt("top-by", "Rank --top by <cpu|rss|threads> (default cpu).", "key");
+    parser.addOption(topOpt);
+    parser.addOption(topByOpt);
+    const QCommandLineOption rulesOpt("rules", "Evaluate the alert rules in <file> on every sample.", "file");
+    parser.addOption(rulesOpt);
+    const QCommandLineOption streamOpt("stream-to", "Stream 1 s samples to an aggregator at <host:port|unix:path>.", "target");
+    const QCommandLineOption nodeOpt("node", "Name this host <name> when streaming (default: host name).", "name");
+    parser.addOption(streamOpt);
+    parser.addOption(nodeOpt);
+    const QCommandLineOption watchOpt("watch-pid", "Show per-thread CPU and scheduling stats of <pid>. Repeatable.", "pid");
+    parser.addOption(watchOpt);
+#if defined(Q_OS_LINUX)
+    // For load tests against a synthetic tree (see bench/sysmon_loadgen)
+    const QCommandLineOption procRootOpt("proc-root", "Read procfs from <dir> instead of /proc.", "dir");
+    const QCommandLineOption sysRootOpt("sys-root", "Read sysfs from <dir> instead of /sys.", "dir");
+    parser.addOption(procRootOpt);
+    parser.addOption(sysRootOpt);
+    const QCommandLineOption psiOpt("psi-trigger",
+        "Report as soon as <resource:some|full:stall-ms:window-ms> is exceeded, e.g. memory:some:150:1000. Repeatable.",
+        "trigger");
+    parser.addOption(psiOpt);
+    const QCommandLineOption ioUringOpt("io-uring", "Scan /proc/<pid>/stat in io_uring batches where available.");
+    parser.addOption(ioUringOpt);
+#endif
+    parser.process(app);
+
+    std::unique_ptr<ISystemMonitor> monitor;
+    if (parser.isSet(replayOpt)) {
+        monitor = std::make_unique<ReplaySystemMonitor>(
+            parser.value(replayOpt).toStdString(),
+            parser.isSet(fastOpt) ? ReplaySystemMonitor::Pace::AsFastAsPossible
+                                  : ReplaySystemMonitor::Pace::RealTime);
+    } else if (parser.isSet(attachOpt)) {
+        monitor = std::make_unique<SharedMemorySystemMonitor>(parser.value(attachOpt).toStdString());
+    } else {
+#if defined(Q_OS_LINUX)
+        LinuxMonitorOptions options;
+        if (parser.isSet(procRootOpt)) options.procRoot = parser.value(procRootOpt).toStdString();
+        if (parser.isSet(sysRootOpt)) options.sysRoot = parser.value(sysRootOpt).toStdString();
+        options.ioUring = parser.isSet(ioUringOpt);
+        monitor = std::make_unique<MonitorImpl>(options);
+#else
+        monitor = std::make_unique<MonitorImpl>();
+#endif
+    }
+
+    // Collectors run on the engine's thread at their own cadence;
+    // the UI timer only reads the latest snapshots
+    g_engine = std::make_unique<SamplingEngine>(std::move(monitor));
+    g_engine->recordInto(g_history);
+    if (parser.isSet(topOpt)) {
+        bool ok = false;
+        const int n = parser.value(topOpt).toInt(&ok);
+        const QString by = parser.isSet(topByOpt) ? parser.value(topByOpt) : QString("cpu");
+        ProcessSortKey key = ProcessSortKey::Cpu;
+        if (by == "rss") key = ProcessSortKey::Rss;
+        else if (by == "threads") key = ProcessSortKey::Threads;
+        else if (by != "cpu") ok = false;
+        if (ok && n > 0)
+            g_engine->setTopProcesses(n, key);
+        else
+            qWarning().noquote() << "Cannot list top" << parser.value(topOpt) << "by" << by;
+    }
+    if (parser.isSet(recordOpt)) {
+        if (g_recorder.open(parser.value(recordOpt).toStdString()))
+            g_engine->recordTo(g_recorder);
+        else
+            qWarning().noquote() << "Cannot record to" << parser.value(recordOpt);
+    }
+    if (parser.isSet(publishOpt)) {
+        if (g_publisher.open(parser.value(publishOpt).toStdString()))
+            g_engine->publishTo(g_publisher);
+        else
+            qWarning().noquote() << "Cannot publish to shared memory" << parser.value(publishOpt);
+    }
+    if (parser.isSet(metricsOpt)) {
+        std::string address;
+        quint16 port = 0;
+        g_metricsServer = std::make_unique<MetricsHttpServer>(g_exporter);
+        if (parseListen(parser.value(metricsOpt), address, port) && g_metricsServer->start(address, port))
+            g_engine->exportTo(g_exporter);
+        else
+            qWarning().noquote() << "Cannot serve metrics on" << parser.value(metricsOpt);
+    }
+    if (parser.isSet(streamOpt)) {
+        const QString node = parser.isSet(nodeOpt) ? parser.value(nodeOpt) : QSysInfo::machineHostName();
+        g_agent = std::make_unique<StreamAgent>(node.toStdString());
+        if (g_agent->open(parser.value(streamOpt).toStdString()))
+            g_engine->streamTo(*g_agent);
+        else
+            qWarning().noquote() << "Cannot stream to" << parser.value(streamOpt);
+    }
+    if (parser.isSet(rulesOpt)) {
+        std::string error;
+        if (g_rules.load(parser.value(rulesOpt).toStdString(), &error)) {
+            g_rules.onEvent([](const RuleEngine::Event& e) {
+                qWarning().noquote() << "Alert" << QString::fromStdString(g_rules.ruleName(e.rule)) + ":"
+                                     << RuleEngine::stateName(e.from) << "->" << RuleEngine::stateName(e.to)
+                                     << e.value;
+            });
+            g_engine->evaluateRules(g_rules);
+        } else {
+            qWarning().noquote() << "Cannot load rules from" << parser.value(rulesOpt) + ":"
+                                 << QString::fromStdString(error);
+        }
+    }
+    for (const QString& pid : parser.values(watchOpt)) {
+        bool ok = false;
+        const int n = pid.toInt(&ok);
+        if (!ok || !g_engine->watchProcess(n))
+            qWarning().noquote() << "Cannot watch process" << pid;
+    }
+    g_engine->start();
+
+#if defined(Q_OS_LINUX)
+    PressureTriggers pressureTriggers(parser.isSet(procRootOpt) ? parser.value(procRootOpt).toStdString() : "/proc");
+    for (const QString& spec : parser.values(psiOpt)) {
+        if (!addPressureTrigger(pressureTriggers, spec))
+            qWarning().noquote() << "Cannot add pressure trigger" << spec;
+    }
+    if (!parser.values(psiOpt).isEmpty()) pressureTriggers.start();
+#endif
 
     QTimer timer;
     QObject::connect(&timer, &QTimer::timeout, &printOnce);
     timer.start(3000); // every 3 seconds
 
-    // print immediately once at start
-    QTimer::singleShot(0, &printOnce);
+    // print once the first samples are in
+    QTimer::singleShot(300, &printOnce);
 
-    return app.exec();
+    const int rc = app.exec();
+    g_engine->stop();     // no more appends before the recorder closes
+    if (g_metricsServer) g_metricsServer->stop();
+    return rc;
 }
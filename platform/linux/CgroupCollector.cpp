@@ -0,0 +1,401 @@
+#include <platform/linux/CgroupCollector.h>
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ProcParse.h>
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace procparse;
+
+namespace {
+
+constexpr const char* kFileNames[] = {"cpu.stat", "memory.current", "memory.stat", "io.stat", "pids.current"};
+constexpr std::size_t kBatch = 64;          // groups per WorkerPool task
+constexpr std::size_t kReadBuffer = 8192;   // stack buffer per file; larger ones spill to t_spill
+
+constexpr std::uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+// Files that outgrow the stack buffer (io.stat with hundreds of devices);
+// kept per worker thread so the next tick reads them without allocating
+thread_local std::vector<char> t_spill;
+
+ssize_t readAt0(int fd, char* buf, std::size_t size)
+{
+    ssize_t n;
+    do {
+        n = ::pread(fd, buf, size, 0);
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+// Reads fd from offset 0 into buf, or into t_spill, doubled until the file
+// fits, when buf fills up; an empty view if fd is closed. The view stays
+// valid until the next call. false on a read error, which for cgroupfs
+// means the group is gone.
+bool readFile(int fd, char* buf, std::string_view& out)
+{
+    out = {};
+    if (fd < 0) return true;
+    ssize_t n = readAt0(fd, buf, kReadBuffer);
+    if (n < 0) return false;
+    if (std::size_t(n) < kReadBuffer) {
+        out = std::string_view(buf, std::size_t(n));
+        return true;
+    }
+    if (t_spill.size() < 2 * kReadBuffer) t_spill.resize(2 * kReadBuffer);
+    for (;;) {
+        n = readAt0(fd, t_spill.data(), t_spill.size());
+        if (n < 0) return false;
+        if (std::size_t(n) < t_spill.size()) break;
+        t_spill.resize(t_spill.size() * 2);
+    }
+    out = std::string_view(t_spill.data(), std::size_t(n));
+    return true;
+}
+
+// Calls fn(key, value) for every "key value" line
+template <typename Fn>
+void forEachKeyValue(std::string_view text, Fn&& fn)
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* key = p;
+        p = skipToken(p, end);
+        const std::string_view name(key, std::size_t(p - key));
+        unsigned long long v = 0;
+        if (parseU64(p, end, v)) fn(name, v);
+        p = nextLine(p, end);
+    }
+}
+
+quint64 delta(quint64 now, quint64 before)
+{
+    return now > before ? now - before : 0;
+}
+
+std::string joinRel(const std::string& parent, const char* name)
+{
+    return parent.empty() ? std::string(name) : parent + '/' + name;
+}
+
+bool isWithin(const std::string& rel, const std::string& tree)
+{
+    return rel == tree || (rel.size() > tree.size() && rel.compare(0, tree.size(), tree) == 0 && rel[tree.size()] == '/');
+}
+
+} // namespace
+
+CgroupCollector::CgroupCollector(std::string root, unsigned helpers, std::chrono::seconds rescanInterval)
+    : m_root(std::move(root))
+    , m_pool(helpers)
+    , m_rescanInterval(rescanInterval)
+{
+}
+
+CgroupCollector::~CgroupCollector()
+{
+    for (Group& g : m_groups) closeGroup(g);
+    if (m_inotifyFd >= 0) ::close(m_inotifyFd);
+}
+
+bool CgroupCollector::isAvailable() const
+{
+    return ::access((m_root + "/cgroup.controllers").c_str(), F_OK) == 0;
+}
+
+// -------- hierarchy --------
+void CgroupCollector::discover()
+{
+    if (m_inotifyFd < 0 && !m_discovered)
+        m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    // Reconcile with a fresh walk: keep groups that still exist (with their
+    // fds and previous counters), drop the rest, add the new ones
+    std::vector<std::string> dirs{std::string()};
+    for (std::size_t i = 0; i < dirs.size(); ++i) {
+        const std::string path = dirs[i].empty() ? m_root : m_root + '/' + dirs[i];
+        DIR* dir = ::opendir(path.c_str());
+        if (!dir) continue;
+        while (const dirent* e = ::readdir(dir)) {
+            if (e->d_type != DT_DIR || e->d_name[0] == '.') continue;
+            dirs.push_back(joinRel(dirs[i], e->d_name));
+        }
+        ::closedir(dir);
+    }
+
+    const std::unordered_set<std::string> present(dirs.begin(), dirs.end());
+    std::vector<std::string> gone;
+    for (const Group& g : m_groups)
+        if (!present.count(g.rel)) gone.push_back(g.rel);
+    for (const std::string& rel : gone) removeTree(rel);
+
+    // dirs is breadth-first, so parents are added before their children
+    for (const std::string& rel : dirs) addGroup(rel);
+
+    m_discovered = true;
+    m_rescan = false;
+    m_lastScan = std::chrono::steady_clock::now();
+}
+
+void CgroupCollector::addTree(const std::string& rel)
+{
+    if (!addGroup(rel)) return;
+    // Children created before the watch on rel was in place raised no event
+    DIR* dir = ::opendir((m_root + '/' + rel).c_str());
+    if (!dir) return;
+    std::vector<std::string> children;
+    while (const dirent* e = ::readdir(dir)) {
+        if (e->d_type == DT_DIR && e->d_name[0] != '.') children.push_back(joinRel(rel, e->d_name));
+    }
+    ::closedir(dir);
+    for (const std::string& child : children) addTree(child);
+}
+
+// false if rel is already tracked or cannot be opened
+bool CgroupCollector::addGroup(const std::string& rel)
+{
+    if (m_known.count(rel)) return false;
+
+    const std::string dirPath = rel.empty() ? m_root : m_root + '/' + rel;
+    const int dirFd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) return false;
+
+    Group g;
+    g.rel = rel;
+    g.path = QString::fromStdString('/' + rel);
+    struct stat st{};
+    if (::fstat(dirFd, &st) == 0) g.id = quint64(st.st_ino);
+    // Files of controllers not enabled for this group are simply absent
+    for (int f = 0; f < FileCount; ++f)
+        g.fds[f] = ::openat(dirFd, kFileNames[f], O_RDONLY | O_CLOEXEC);
+    ::close(dirFd);
+
+    if (m_inotifyFd >= 0) {
+        g.wd = ::inotify_add_watch(m_inotifyFd, dirPath.c_str(), kWatchMask);
+        if (g.wd >= 0) {
+            m_watches[g.wd] = rel;
+        } else {
+            // Out of watches (fs.inotify.max_user_watches): fall back to
+            // periodic walks for the whole hierarchy
+            for (Group& other : m_groups) other.wd = -1;
+            m_watches.clear();
+            ::close(m_inotifyFd);
+            m_inotifyFd = -1;
+        }
+    }
+
+    if (m_discovered) m_added.push_back(g.path);
+    m_known.insert(rel);
+    m_groups.push_back(std::move(g));
+    return true;
+}
+
+void CgroupCollector::removeTree(const std::string& rel)
+{
+    auto it = std::stable_partition(m_groups.begin(), m_groups.end(),
+                                    [&](const Group& g) { return !isWithin(g.rel, rel); });
+    for (auto g = it; g != m_groups.end(); ++g) {
+        m_removed.push_back(g->path);
+        closeGroup(*g);
+    }
+    m_groups.erase(it, m_groups.end());
+}
+
+void CgroupCollector::closeGroup(Group& g)
+{
+    m_known.erase(g.rel);
+    for (int& fd : g.fds) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    if (g.wd >= 0) {
+        // Already gone if the directory was removed; harmless then
+        if (m_inotifyFd >= 0) ::inotify_rm_watch(m_inotifyFd, g.wd);
+        m_watches.erase(g.wd);
+        g.wd = -1;
+    }
+}
+
+// Applies pending inotify events; false if the queue overflowed and the
+// hierarchy has to be walked again
+bool CgroupCollector::drainEvents()
+{
+    if (m_inotifyFd < 0) return true;
+
+    alignas(inotify_event) char buf[16384];
+    for (;;) {
+        const ssize_t n = ::read(m_inotifyFd, buf, sizeof(buf));
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+        if (n <= 0) return true;
+
+        for (const char* p = buf; p < buf + n;) {
+            const auto* e = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + e->len;
+
+            if (e->mask & IN_Q_OVERFLOW) return false;
+            if (e->mask & IN_IGNORED) {
+                m_watches.erase(e->wd);
+                continue;
+            }
+            if (!(e->mask & IN_ISDIR) || e->len == 0) continue;
+
+            const auto parent = m_watches.find(e->wd);
+            if (parent == m_watches.end()) continue;
+            const std::string rel = joinRel(parent->second, e->name);
+            if (e->mask & (IN_CREATE | IN_MOVED_TO)) addTree(rel);
+            else if (e->mask & (IN_DELETE | IN_MOVED_FROM)) removeTree(rel);
+        }
+    }
+}
+
+// -------- sampling --------
+void CgroupCollector::sample(Group& g, CgroupStats& out, double seconds)
+{
+    char buf[kReadBuffer];
+    std::string_view text;
+    Counters now;
+
+    out.path = g.path;
+    out.id = g.id;
+
+    if (!readFile(g.fds[CpuStat], buf, text)) { g.failed = true; return; }
+    forEachKeyValue(text, [&](std::string_view key, unsigned long long v) {
+        if (key == "usage_usec") out.cpuUsageUs = v;
+        else if (key == "user_usec") out.cpuUserUs = v;
+        else if (key == "system_usec") out.cpuSystemUs = v;
+        else if (key == "nr_throttled") out.nrThrottled = v;
+        else if (key == "throttled_usec") out.throttledUs = v;
+    });
+
+    if (!readFile(g.fds[MemoryCurrent], buf, text)) { g.failed = true; return; }
+    {
+        const char* p = text.data();
+        unsigned long long v = 0;
+        if (parseU64(p, p + text.size(), v)) out.memoryCurrent = v;
+    }
+
+    if (!readFile(g.fds[MemoryStat], buf, text)) { g.failed = true; return; }
+    forEachKeyValue(text, [&](std::string_view key, unsigned long long v) {
+        if (key == "anon") out.memoryAnon = v;
+        else if (key == "file") out.memoryFile = v;
+        else if (key == "kernel") out.memoryKernel = v;
+        else if (key == "shmem") out.memoryShmem = v;
+        else if (key == "sock") out.memorySock = v;
+        else if (key == "pgmajfault") out.pgMajFault = v;
+    });
+
+    if (!readFile(g.fds[IoStat], buf, text)) { g.failed = true; return; }
+    {
+        // "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0"
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* lineEnd = nextLine(p, end);
+            p = skipToken(p, lineEnd);
+            for (;;) {
+                p = skipSpaces(p, lineEnd);
+                const char* key = p;
+                while (p < lineEnd && *p != '=' && *p != ' ' && *p != '\n') ++p;
+                if (p >= lineEnd || *p != '=') break;
+                const std::string_view name(key, std::size_t(p - key));
+                ++p;
+                unsigned long long v = 0;
+                if (!parseU64(p, lineEnd, v)) break;
+                if (name == "rbytes") out.ioReadBytes += v;
+                else if (name == "wbytes") out.ioWriteBytes += v;
+                else if (name == "rios") out.ioReadOps += v;
+                else if (name == "wios") out.ioWriteOps += v;
+            }
+            p = lineEnd;
+        }
+    }
+
+    if (!readFile(g.fds[PidsCurrent], buf, text)) { g.failed = true; return; }
+    {
+        const char* p = text.data();
+        unsigned long long v = 0;
+        if (parseU64(p, p + text.size(), v)) out.pids = v;
+    }
+
+    now.cpuUsageUs = out.cpuUsageUs;
+    now.throttledUs = out.throttledUs;
+    now.pgMajFault = out.pgMajFault;
+    now.ioReadBytes = out.ioReadBytes;
+    now.ioWriteBytes = out.ioWriteBytes;
+    now.ioReadOps = out.ioReadOps;
+    now.ioWriteOps = out.ioWriteOps;
+
+    if (!g.fresh && seconds > 0) {
+        const Counters& b = g.prev;
+        out.cpuPercent = double(delta(now.cpuUsageUs, b.cpuUsageUs)) / (seconds * 1e6) * 100.0;
+        out.throttledPercent = std::min(100.0, double(delta(now.throttledUs, b.throttledUs)) / (seconds * 1e6) * 100.0);
+        out.pgMajFaultPerSec = double(delta(now.pgMajFault, b.pgMajFault)) / seconds;
+        out.ioReadBytesPerSec = double(delta(now.ioReadBytes, b.ioReadBytes)) / seconds;
+        out.ioWriteBytesPerSec = double(delta(now.ioWriteBytes, b.ioWriteBytes)) / seconds;
+        out.ioReadOpsPerSec = double(delta(now.ioReadOps, b.ioReadOps)) / seconds;
+        out.ioWriteOpsPerSec = double(delta(now.ioWriteOps, b.ioWriteOps)) / seconds;
+    }
+    g.prev = now;
+    g.fresh = false;
+}
+
+CgroupTable CgroupCollector::read()
+{
+    // A v1 or hybrid hierarchy has per-controller trees with other files
+    if (!m_discovered && !isAvailable()) return {};
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!m_discovered) {
+        discover();
+    } else {
+        if (!drainEvents()) m_rescan = true;
+        if (m_inotifyFd < 0 && now - m_lastScan >= m_rescanInterval) m_rescan = true;
+        if (m_rescan) discover();
+    }
+
+    CgroupTable table;
+    table.intervalSeconds = m_lastRead == std::chrono::steady_clock::time_point{}
+        ? 0.0 : std::chrono::duration<double>(now - m_lastRead).count();
+    m_lastRead = now;
+
+    const std::size_t n = m_groups.size();
+    table.groups.resize(n);
+    const double seconds = table.intervalSeconds;
+    m_pool.run((n + kBatch - 1) / kBatch, [&](std::size_t batch) {
+        const std::size_t end = std::min(n, (batch + 1) * kBatch);
+        for (std::size_t i = batch * kBatch; i < end; ++i) sample(m_groups[i], table.groups[i], seconds);
+    });
+
+    // Groups removed between the last event and the read
+    bool anyFailed = false;
+    for (Group& g : m_groups) anyFailed |= g.failed;
+    if (anyFailed) {
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (m_groups[i].failed) {
+                m_removed.push_back(m_groups[i].path);
+                closeGroup(m_groups[i]);
+                continue;
+            }
+            if (out != i) {
+                m_groups[out] = std::move(m_groups[i]);
+                table.groups[out] = std::move(table.groups[i]);
+            }
+            ++out;
+        }
+        m_groups.resize(out);
+        table.groups.resize(out);
+    }
+
+    table.added.swap(m_added);
+    table.removed.swap(m_removed);
+    return table;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <core/CgroupStats.h>
+#include <platform/linux/WorkerPool.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Per-cgroup CPU, memory, IO and pid counters from a cgroup v2 hierarchy.
+//
+// The hierarchy is walked once; afterwards inotify reports groups being
+// created or removed (one watch per group directory), so a tick never lists
+// directories. Every group keeps cpu.stat, memory.current, memory.stat,
+// io.stat and pids.current open and a tick is one pread per file into a
+// stack buffer (a per-thread heap buffer for files larger than 8 KiB),
+// parsed in place. Groups are read in batches, spread over a
+// WorkerPool when it has helpers.
+//
+// Without inotify (or after its queue overflowed) the hierarchy is walked
+// again every rescanInterval. A group whose files fail to read is dropped.
+class CgroupCollector {
+public:
+    explicit CgroupCollector(std::string root = "/sys/fs/cgroup", unsigned helpers = 0,
+                             std::chrono::seconds rescanInterval = std::chrono::seconds(30));
+    ~CgroupCollector();
+
+    CgroupCollector(const CgroupCollector&) = delete;
+    CgroupCollector& operator=(const CgroupCollector&) = delete;
+
+    // False if root is not a cgroup v2 mount (no cgroup.controllers)
+    bool isAvailable() const;
+
+    CgroupTable read();
+
+    std::size_t groupCount() const { return m_groups.size(); }
+    bool usingInotify() const { return m_inotifyFd >= 0; }
+
+private:
+    enum File { CpuStat, MemoryCurrent, MemoryStat, IoStat, PidsCurrent, FileCount };
+
+    struct Counters {
+        quint64 cpuUsageUs = 0, throttledUs = 0, pgMajFault = 0;
+        quint64 ioReadBytes = 0, ioWriteBytes = 0, ioReadOps = 0, ioWriteOps = 0;
+    };
+
+    struct Group {
+        std::string rel;                // "" for the root, else "a/b"
+        QString path;
+        quint64 id = 0;
+        int wd = -1;
+        int fds[FileCount] = {-1, -1, -1, -1, -1};
+        Counters prev;
+        bool fresh = true;              // no previous sample yet
+        bool failed = false;
+    };
+
+    void discover();
+    void addTree(const std::string& rel);
+    bool addGroup(const std::string& rel);
+    void removeTree(const std::string& rel);
+    void closeGroup(Group& g);
+    bool drainEvents();
+    static void sample(Group& g, CgroupStats& out, double seconds);
+
+    std::string m_root;
+    std::vector<Group> m_groups;
+    std::unordered_set<std::string> m_known;            // rel of every group
+    std::unordered_map<int, std::string> m_watches;     // wd -> rel
+    std::vector<QString> m_added;
+    std::vector<QString> m_removed;
+    WorkerPool m_pool;
+    std::chrono::seconds m_rescanInterval;
+    std::chrono::steady_clock::time_point m_lastScan{};
+    std::chrono::steady_clock::time_point m_lastRead{};
+    int m_inotifyFd = -1;
+    bool m_discovered = false;
+    bool m_rescan = false;
+};
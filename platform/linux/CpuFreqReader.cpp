@@ -0,0 +1,116 @@
+#include <platform/linux/CpuFreqReader.h>
+#include <platform/linux/ProcParse.h>
+#include <platform/linux/ProcReaders.h>
+#include <thread>
+
+using namespace procparse;
+
+CpuFreqReader::CpuFreqReader(std::string cpuRoot, std::string cpuinfoPath)
+    : m_root(std::move(cpuRoot))
+    , m_cpuinfoPath(std::move(cpuinfoPath))
+    , m_online(m_root + "/online", 4096)
+{
+}
+
+void CpuFreqReader::refreshOnline()
+{
+    std::string_view text = m_online.read();
+    if (!m_cpus.empty() && text == m_onlineText) return;
+
+    m_onlineText.assign(text.data(), text.size());
+    if (!parseCpuList(text, m_cpus)) {
+        // No online mask (very old kernel or stripped sysfs)
+        const unsigned n = std::thread::hardware_concurrency();
+        m_cpus.clear();
+        for (unsigned cpu = 0; cpu < n; ++cpu) m_cpus.push_back(int(cpu));
+    }
+    reopen();
+}
+
+void CpuFreqReader::reopen()
+{
+    m_freq.clear();
+    m_freq.reserve(m_cpus.size());
+    m_haveCpufreq = false;
+
+    std::string path;
+    for (int cpu : m_cpus) {
+        path = m_root + "/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq";
+        ProcFile f(32);
+        if (f.open(path)) m_haveCpufreq = true;
+        m_freq.push_back(std::move(f));
+    }
+}
+
+void CpuFreqReader::readCpuinfo(CpuCoresStats& stats)
+{
+    // Roughly 1.5 KB per CPU on x86; readAll() grows the buffer to fit
+    if (!m_cpuinfo.isOpen()) m_cpuinfo = ProcFile(m_cpuinfoPath, 64 * 1024);
+
+    std::string_view text = m_cpuinfo.readAll();
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    int coreId = -1;
+    while (p < end) {
+        if (startsWith(p, end, "processor")) {
+            const char* colon = p;
+            while (colon < end && *colon != ':' && *colon != '\n') ++colon;
+            unsigned long long id = 0;
+            if (colon < end && *colon == ':') {
+                ++colon;
+                if (parseU64(colon, end, id)) coreId = int(id);
+            }
+        } else if (startsWith(p, end, "cpu MHz") && coreId >= 0) {
+            const char* colon = p;
+            while (colon < end && *colon != ':' && *colon != '\n') ++colon;
+            unsigned long long whole = 0, frac = 0, scale = 1;
+            if (colon < end && *colon == ':') ++colon;
+            if (parseU64(colon, end, whole)) {
+                if (colon < end && *colon == '.') {
+                    ++colon;
+                    while (colon < end && *colon >= '0' && *colon <= '9' && scale < 1000000) {
+                        frac = frac * 10 + unsigned(*colon++ - '0');
+                        scale *= 10;
+                    }
+                }
+                if (std::size_t(coreId) >= stats.coreFreq.size())
+                    stats.coreFreq.resize(std::size_t(coreId) + 1, 0.0);
+                stats.coreFreq[std::size_t(coreId)] = double(whole) + double(frac) / double(scale);
+            }
+        }
+        p = nextLine(p, end);
+    }
+}
+
+CpuCoresStats CpuFreqReader::read()
+{
+    refreshOnline();
+
+    CpuCoresStats stats;
+    stats.totalCores = qint32(m_cpus.size());
+    if (!m_cpus.empty()) stats.coreFreq.assign(std::size_t(m_cpus.back()) + 1, 0.0);
+
+    if (m_haveCpufreq) {
+        for (std::size_t i = 0; i < m_cpus.size(); ++i) {
+            std::string_view text = m_freq[i].read();
+            const char* p = text.data();
+            unsigned long long khz = 0;
+            if (!text.empty() && parseU64(p, p + text.size(), khz) && khz > 0)
+                stats.coreFreq[std::size_t(m_cpus[i])] = khz / 1000.0;
+        }
+    } else {
+        readCpuinfo(stats);
+    }
+
+    double sumMhz = 0.0;
+    int count = 0;
+    for (double mhz : stats.coreFreq) {
+        if (mhz <= 0) continue;
+        sumMhz += mhz;
+        ++count;
+    }
+    stats.averageFreq = (count > 0) ? (sumMhz / count) : 0.0;
+    if (stats.totalCores == 0) stats.totalCores = count;
+    return stats;
+}
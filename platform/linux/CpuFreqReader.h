@@ -0,0 +1,35 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <platform/linux/ProcFile.h>
+#include <string>
+#include <vector>
+
+// Per-CPU current frequency from cpufreq. The CPU set comes from
+// <cpuRoot>/online; one scaling_cur_freq descriptor per online CPU stays
+// open, and the set is rebuilt only when the online mask changes (hotplug).
+// Falls back to the "cpu MHz" lines of /proc/cpuinfo when cpufreq is absent.
+class CpuFreqReader {
+public:
+    explicit CpuFreqReader(std::string cpuRoot = "/sys/devices/system/cpu",
+                           std::string cpuinfoPath = "/proc/cpuinfo");
+
+    CpuCoresStats read();
+
+    // Online CPU ids as of the last read()
+    const std::vector<int>& onlineCpus() const { return m_cpus; }
+
+private:
+    void refreshOnline();
+    void reopen();
+    void readCpuinfo(CpuCoresStats& stats);
+
+    std::string m_root;
+    std::string m_cpuinfoPath;
+    ProcFile m_online;
+    std::string m_onlineText;
+    std::vector<int> m_cpus;
+    std::vector<ProcFile> m_freq;   // parallel to m_cpus; closed if no cpufreq
+    bool m_haveCpufreq = false;
+    ProcFile m_cpuinfo{0};          // sized on first use
+};
@@ -0,0 +1,141 @@
+#include <platform/linux/CpuUsageSampler.h>
+#include <algorithm>
+
+namespace {
+
+// out[i] = 100 * (cur[i] - prev[i]) / total[i], clamping counters that went
+// backwards (iowait does on some kernels) to 0
+void shareOf(const std::vector<unsigned long long>& cur,
+             const std::vector<unsigned long long>& prev,
+             const std::vector<double>& total,
+             std::vector<double>& out, std::size_t first)
+{
+    const std::size_t n = cur.size();
+    out.resize(n - first);
+    const unsigned long long* c = cur.data();
+    const unsigned long long* p = prev.data();
+    const double* t = total.data();
+    double* o = out.data();
+    for (std::size_t i = first; i < n; ++i) {
+        const unsigned long long d = c[i] > p[i] ? c[i] - p[i] : 0;
+        o[i - first] = t[i] > 0 ? 100.0 * double(d) / t[i] : 0.0;
+    }
+}
+
+void addDelta(const std::vector<unsigned long long>& cur,
+              const std::vector<unsigned long long>& prev,
+              std::vector<double>& total)
+{
+    const std::size_t n = cur.size();
+    const unsigned long long* c = cur.data();
+    const unsigned long long* p = prev.data();
+    double* t = total.data();
+    for (std::size_t i = 0; i < n; ++i)
+        t[i] += double(c[i] > p[i] ? c[i] - p[i] : 0);
+}
+
+} // namespace
+
+void CpuUsageSampler::realignPrevious()
+{
+    // CPUs went on- or offline: match rows by id, new CPUs start from their
+    // current counters (zero delta this round)
+    CpuJiffies aligned;
+    for (std::size_t i = 0; i < m_cur.size(); ++i) {
+        const auto it = std::find(m_prev.cpuId.begin(), m_prev.cpuId.end(), m_cur.cpuId[i]);
+        const CpuJiffies& src = it == m_prev.cpuId.end() ? m_cur : m_prev;
+        const std::size_t j = it == m_prev.cpuId.end() ? i : std::size_t(it - m_prev.cpuId.begin());
+        aligned.cpuId.push_back(m_cur.cpuId[i]);
+        aligned.user.push_back(src.user[j]);
+        aligned.nice.push_back(src.nice[j]);
+        aligned.system.push_back(src.system[j]);
+        aligned.idle.push_back(src.idle[j]);
+        aligned.iowait.push_back(src.iowait[j]);
+        aligned.irq.push_back(src.irq[j]);
+        aligned.softirq.push_back(src.softirq[j]);
+        aligned.steal.push_back(src.steal[j]);
+    }
+    m_prev = std::move(aligned);
+}
+
+void CpuUsageSampler::sample(std::string_view procStat, CpuStats& out, bool perCore)
+{
+    // The aggregate line comes first
+    if (!perCore) {
+        const std::size_t eol = procStat.find('\n');
+        if (eol != std::string_view::npos) procStat = procStat.substr(0, eol + 1);
+    }
+    if (!parseCpuJiffies(procStat, m_cur)) return;
+
+    if (!m_havePrev) {
+        std::swap(m_prev, m_cur);
+        m_havePrev = true;
+        if (!perCore) return;
+        CpuUtilization& u = out.perCore;
+        const std::size_t cores = m_prev.size() - 1;
+        u.cpuId.assign(m_prev.cpuId.begin() + 1, m_prev.cpuId.end());
+        for (std::vector<double>* v : {&u.usage, &u.user, &u.nice, &u.system, &u.idle,
+                                       &u.iowait, &u.irq, &u.softirq, &u.steal})
+            v->assign(cores, 0.0);
+        return;
+    }
+    if (perCore && m_cur.cpuId != m_prev.cpuId) realignPrevious();
+
+    // Aggregate-only samples have just row 0; m_prev keeps its CPU rows
+    const std::size_t n = m_cur.size();
+    m_total.assign(n, 0.0);
+    addDelta(m_cur.user, m_prev.user, m_total);
+    addDelta(m_cur.nice, m_prev.nice, m_total);
+    addDelta(m_cur.system, m_prev.system, m_total);
+    addDelta(m_cur.idle, m_prev.idle, m_total);
+    addDelta(m_cur.iowait, m_prev.iowait, m_total);
+    addDelta(m_cur.irq, m_prev.irq, m_total);
+    addDelta(m_cur.softirq, m_prev.softirq, m_total);
+    addDelta(m_cur.steal, m_prev.steal, m_total);
+
+    if (perCore) {
+        CpuUtilization& u = out.perCore;
+        u.cpuId.assign(m_cur.cpuId.begin() + 1, m_cur.cpuId.end());
+        shareOf(m_cur.user, m_prev.user, m_total, u.user, 1);
+        shareOf(m_cur.nice, m_prev.nice, m_total, u.nice, 1);
+        shareOf(m_cur.system, m_prev.system, m_total, u.system, 1);
+        shareOf(m_cur.idle, m_prev.idle, m_total, u.idle, 1);
+        shareOf(m_cur.iowait, m_prev.iowait, m_total, u.iowait, 1);
+        shareOf(m_cur.irq, m_prev.irq, m_total, u.irq, 1);
+        shareOf(m_cur.softirq, m_prev.softirq, m_total, u.softirq, 1);
+        shareOf(m_cur.steal, m_prev.steal, m_total, u.steal, 1);
+
+        u.usage.resize(n - 1);
+        for (std::size_t i = 0; i + 1 < n; ++i)
+            u.usage[i] = m_total[i + 1] > 0 ? std::max(0.0, 100.0 - u.idle[i] - u.iowait[i]) : 0.0;
+    }
+
+    // Row 0 is the aggregate line
+    auto share = [&](const std::vector<unsigned long long>& cur, const std::vector<unsigned long long>& prev) {
+        const unsigned long long d = cur[0] > prev[0] ? cur[0] - prev[0] : 0;
+        return m_total[0] > 0 ? 100.0 * double(d) / m_total[0] : 0.0;
+    };
+    CpuTimeShares& t = out.cpuTimes;
+    t.user = share(m_cur.user, m_prev.user);
+    t.nice = share(m_cur.nice, m_prev.nice);
+    t.system = share(m_cur.system, m_prev.system);
+    t.idle = share(m_cur.idle, m_prev.idle);
+    t.iowait = share(m_cur.iowait, m_prev.iowait);
+    t.irq = share(m_cur.irq, m_prev.irq);
+    t.softirq = share(m_cur.softirq, m_prev.softirq);
+    t.steal = share(m_cur.steal, m_prev.steal);
+    out.cpuUsage = m_total[0] > 0 ? std::max(0.0, 100.0 - t.idle - t.iowait) : 0.0;
+
+    if (perCore) {
+        std::swap(m_prev, m_cur);
+        return;
+    }
+    m_prev.user[0] = m_cur.user[0];
+    m_prev.nice[0] = m_cur.nice[0];
+    m_prev.system[0] = m_cur.system[0];
+    m_prev.idle[0] = m_cur.idle[0];
+    m_prev.iowait[0] = m_cur.iowait[0];
+    m_prev.irq[0] = m_cur.irq[0];
+    m_prev.softirq[0] = m_cur.softirq[0];
+    m_prev.steal[0] = m_cur.steal[0];
+}
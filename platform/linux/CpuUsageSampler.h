@@ -0,0 +1,28 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <platform/linux/ProcReaders.h>
+#include <string_view>
+
+// Aggregate and per-CPU utilization from consecutive /proc/stat samples.
+// Each monitor owns one, so separate instances never share deltas. All
+// counters live in CpuJiffies arrays; the delta step is one flat loop per
+// category over every CPU.
+class CpuUsageSampler {
+public:
+    // Parses procStat (one pass over the cpu lines) and fills cpuUsage,
+    // cpuTimes and perCore of out. The first sample reports zeros.
+    // perCore = false parses only the aggregate line and leaves out.perCore
+    // alone; the next full sample then covers the longer interval per CPU.
+    void sample(std::string_view procStat, CpuStats& out, bool perCore = true);
+
+private:
+    void realignPrevious();
+
+    CpuJiffies m_prev;
+    CpuJiffies m_cur;
+    bool m_havePrev = false;
+
+    // Scratch for the per-row totals, reused between samples
+    std::vector<double> m_total;
+};
@@ -0,0 +1,136 @@
+#include <platform/linux/DiskStatsReader.h>
+#include <platform/linux/ProcParse.h>
+#include <algorithm>
+#include <unistd.h>
+
+using namespace procparse;
+
+// diskstats counts in 512-byte sectors whatever the device's sector size
+static constexpr unsigned long long kSectorBytes = 512;
+
+DiskStatsReader::DiskStatsReader(const std::string& procRoot, std::string sysRoot)
+    : m_file(procRoot + "/diskstats", 16 * 1024)
+    , m_sysRoot(std::move(sysRoot))
+{
+}
+
+int DiskStatsReader::intern(std::string_view name, quint32 major, quint32 minor)
+{
+    std::string key(name);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        Device& d = m_devices[std::size_t(it->second)];
+        if (d.major != major || d.minor != minor) {
+            // Another device under the same name: its counters start over
+            d.major = major;
+            d.minor = minor;
+            d.seenTick = 0;
+        }
+        return it->second;
+    }
+
+    Device d;
+    d.name = QString::fromStdString(key);
+    d.major = major;
+    d.minor = minor;
+    d.partition = ::access((m_sysRoot + "/class/block/" + key + "/partition").c_str(), F_OK) == 0;
+    d.key = std::move(key);
+    const int slot = int(m_devices.size());
+    m_index.emplace(d.key, slot);
+    m_devices.push_back(std::move(d));
+    return slot;
+}
+
+DiskStats DiskStatsReader::read()
+{
+    DiskStats out;
+    const std::string_view text = m_file.readAll();
+    if (text.empty()) return out;
+
+    const auto now = std::chrono::steady_clock::now();
+    const bool first = m_tick == 0;
+    const double seconds = first ? 0.0 : std::chrono::duration<double>(now - m_last).count();
+    out.intervalSeconds = seconds;
+    m_last = now;
+    ++m_tick;
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+    std::size_t line = 0;
+    out.devices.reserve(m_devices.size());
+
+    while (p < end) {
+        const char* lineEnd = nextLine(p, end);
+
+        // "   8       0 sda 1 2 3 4 5 6 7 8 9 10 11 ..."
+        unsigned long long major = 0, minor = 0;
+        if (!parseU64(p, lineEnd, major) || !parseU64(p, lineEnd, minor)) { p = lineEnd; continue; }
+        p = skipSpaces(p, lineEnd);
+        const char* nameStart = p;
+        p = skipToken(p, lineEnd);
+        const std::string_view name(nameStart, std::size_t(p - nameStart));
+
+        unsigned long long v[11] = {};
+        int fields = 0;
+        while (fields < 11 && parseU64(p, lineEnd, v[fields])) ++fields;
+        if (name.empty() || fields < 11) { p = lineEnd; continue; }
+
+        // Same line as last time is the common case: no hashing
+        int slot = line < m_lineDevice.size() ? m_lineDevice[line] : -1;
+        if (slot < 0 || m_devices[std::size_t(slot)].key != name
+            || m_devices[std::size_t(slot)].major != quint32(major) || m_devices[std::size_t(slot)].minor != quint32(minor))
+            slot = intern(name, quint32(major), quint32(minor));
+        if (line < m_lineDevice.size()) m_lineDevice[line] = slot;
+        else m_lineDevice.push_back(slot);
+        ++line;
+
+        Device& d = m_devices[std::size_t(slot)];
+        Counters c;
+        c.reads = v[0];
+        c.readSectors = v[2];
+        c.readTimeMs = v[3];
+        c.writes = v[4];
+        c.writeSectors = v[6];
+        c.writeTimeMs = v[7];
+        c.inFlight = v[8];
+        c.ioTimeMs = v[9];
+        c.weightedTimeMs = v[10];
+
+        DiskDeviceStats s;
+        s.name = d.name;
+        s.index = slot;
+        s.major = d.major;
+        s.minor = d.minor;
+        s.partition = d.partition;
+        s.reads = c.reads;
+        s.readBytes = c.readSectors * kSectorBytes;
+        s.readTimeMs = c.readTimeMs;
+        s.writes = c.writes;
+        s.writeBytes = c.writeSectors * kSectorBytes;
+        s.writeTimeMs = c.writeTimeMs;
+        s.inFlight = c.inFlight;
+        s.ioTimeMs = c.ioTimeMs;
+
+        // Seen in the previous read too, so prev is from one interval ago
+        if (!first && d.seenTick + 1 == m_tick && seconds > 0) {
+            const Counters& b = d.prev;
+            const unsigned long long reads = counterDelta(c.reads, b.reads);
+            const unsigned long long writes = counterDelta(c.writes, b.writes);
+            const double ms = seconds * 1000.0;
+            s.readBytesPerSec = double(counterDelta(c.readSectors, b.readSectors) * kSectorBytes) / seconds;
+            s.writeBytesPerSec = double(counterDelta(c.writeSectors, b.writeSectors) * kSectorBytes) / seconds;
+            s.readIops = double(reads) / seconds;
+            s.writeIops = double(writes) / seconds;
+            s.utilization = std::min(100.0, double(counterDelta(c.ioTimeMs, b.ioTimeMs)) / ms * 100.0);
+            s.readLatencyMs = reads ? double(counterDelta(c.readTimeMs, b.readTimeMs)) / double(reads) : 0.0;
+            s.writeLatencyMs = writes ? double(counterDelta(c.writeTimeMs, b.writeTimeMs)) / double(writes) : 0.0;
+            s.queueDepth = double(counterDelta(c.weightedTimeMs, b.weightedTimeMs)) / ms;
+        }
+        d.prev = c;
+        d.seenTick = m_tick;
+        out.devices.push_back(std::move(s));
+        p = lineEnd;
+    }
+    m_lineDevice.resize(line);
+    return out;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <core/DiskStats.h>
+#include <platform/linux/ProcFile.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Per-device throughput, IOPS, utilization and latency from /proc/diskstats.
+// The file stays open and is re-read with pread(); lines are scanned in
+// place. Every device is interned once into a stable index, and a device
+// found on the same line as in the previous read is matched with a single
+// name compare, so a tick is a pass over the file plus array updates.
+class DiskStatsReader {
+public:
+    explicit DiskStatsReader(const std::string& procRoot = "/proc", std::string sysRoot = "/sys");
+
+    DiskStats read();
+
+    std::size_t deviceCount() const { return m_devices.size(); }
+
+private:
+    struct Counters {
+        unsigned long long reads = 0, readSectors = 0, readTimeMs = 0;
+        unsigned long long writes = 0, writeSectors = 0, writeTimeMs = 0;
+        unsigned long long inFlight = 0, ioTimeMs = 0, weightedTimeMs = 0;
+    };
+
+    struct Device {
+        std::string key;
+        QString name;
+        quint32 major = 0;
+        quint32 minor = 0;
+        bool partition = false;
+        Counters prev;
+        quint64 seenTick = 0;       // read() that last saw the device
+    };
+
+    int intern(std::string_view name, quint32 major, quint32 minor);
+
+    ProcFile m_file;
+    std::string m_sysRoot;
+    std::vector<Device> m_devices;
+    std::unordered_map<std::string, int> m_index;   // name -> m_devices slot
+    std::vector<int> m_lineDevice;                  // previous read: line -> slot
+    std::chrono::steady_clock::time_point m_last{};
+    quint64 m_tick = 0;
+};
@@ -0,0 +1,164 @@
+#include <platform/linux/HwmonSensors.h>
+#include <platform/linux/ProcParse.h>
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool isCpuChip(const std::string& chipName)
+{
+    return chipName.find("coretemp") != std::string::npos
+        || chipName.find("k10temp") != std::string::npos
+        || chipName.find("cpu") != std::string::npos;
+}
+
+std::string readLine(const fs::path& file)
+{
+    std::ifstream f(file);
+    std::string line;
+    if (f) std::getline(f, line);
+    return line;
+}
+
+// "Package id 1" -> 1, "Core 12" -> 12
+bool trailingNumber(const std::string& s, const char* prefix, int& out)
+{
+    const std::size_t len = std::char_traits<char>::length(prefix);
+    if (s.compare(0, len, prefix) != 0) return false;
+    const char* p = s.c_str() + len;
+    unsigned long long v = 0;
+    if (!procparse::parseU64(p, s.c_str() + s.size(), v)) return false;
+    out = int(v);
+    return true;
+}
+
+} // namespace
+
+HwmonSensors::HwmonSensors(std::string hwmonRoot, std::chrono::seconds rescanInterval)
+    : m_root(std::move(hwmonRoot))
+    , m_rescanInterval(rescanInterval)
+{
+}
+
+void HwmonSensors::refresh()
+{
+    m_discovered = false;
+}
+
+void HwmonSensors::discover()
+{
+    m_sensors.clear();
+    m_discovered = true;
+    m_lastDiscovery = std::chrono::steady_clock::now();
+
+    std::error_code ec;
+    std::vector<fs::path> chips;
+    for (const auto& entry : fs::directory_iterator(m_root, ec)) chips.push_back(entry.path());
+    if (ec) return;
+    std::sort(chips.begin(), chips.end());
+
+    int nextPackage = 0;
+    for (const fs::path& chip : chips) {
+        // Older drivers keep their attributes under device/
+        fs::path dir = chip;
+        std::string chipName = readLine(dir / "name");
+        if (chipName.empty()) {
+            dir = chip / "device";
+            chipName = readLine(dir / "name");
+        }
+        if (!isCpuChip(chipName)) continue;
+
+        std::vector<std::pair<int, fs::path>> inputs;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            int index = 0;
+            if (name.size() > 10 && name.compare(name.size() - 6, 6, "_input") == 0
+                && trailingNumber(name, "temp", index))
+                inputs.emplace_back(index, entry.path());
+        }
+        std::sort(inputs.begin(), inputs.end());
+
+        // coretemp names its package explicitly; k10temp and friends expose
+        // one chip per package, so number those in discovery order
+        int chipPackage = -1;
+        const std::size_t firstSensor = m_sensors.size();
+
+        for (const auto& [index, inputPath] : inputs) {
+            Sensor s;
+            // Unsupported channels fail every read; do not keep them around
+            if (!s.input.open(inputPath.string()) || s.input.read().empty()) continue;
+
+            const std::string label = readLine(dir / ("temp" + std::to_string(index) + "_label"));
+            s.chip = QString::fromStdString(chipName);
+            s.label = QString::fromStdString(label.empty() ? "temp" + std::to_string(index) : label);
+
+            int n = 0;
+            if (trailingNumber(label, "Package id ", n)) {
+                s.kind = Kind::Package;
+                s.package = n;
+                chipPackage = n;
+            } else if (trailingNumber(label, "Core ", n)) {
+                s.kind = Kind::Core;
+                s.core = n;
+            } else if (label == "Tctl" || label == "Tdie" || label.empty()) {
+                s.kind = Kind::Package;
+            }
+            m_sensors.push_back(std::move(s));
+        }
+
+        if (m_sensors.size() == firstSensor) continue;
+        if (chipPackage < 0) chipPackage = nextPackage;
+        nextPackage = std::max(nextPackage, chipPackage + 1);
+        for (std::size_t i = firstSensor; i < m_sensors.size(); ++i)
+            m_sensors[i].package = chipPackage;
+
+        // k10temp reports Tctl and Tdie for the same die; keep only the first
+        bool havePackage = false;
+        for (std::size_t i = firstSensor; i < m_sensors.size(); ++i) {
+            if (m_sensors[i].kind != Kind::Package) continue;
+            if (havePackage) m_sensors[i].kind = Kind::Other;
+            havePackage = true;
+        }
+    }
+}
+
+CpuTemperatures HwmonSensors::read()
+{
+    if (!m_discovered || std::chrono::steady_clock::now() - m_lastDiscovery >= m_rescanInterval)
+        discover();
+
+    CpuTemperatures temps;
+    temps.sensors.reserve(m_sensors.size());
+    bool lost = false;
+
+    for (Sensor& s : m_sensors) {
+        std::string_view text = s.input.read();
+        const char* p = text.data();
+        long long milliC = 0;
+        if (text.empty()) {
+            if (s.input.error() == ENODEV || s.input.error() == ENOENT) lost = true;
+            continue;
+        }
+        if (!procparse::parseI64(p, text.data() + text.size(), milliC)) continue;
+
+        const double celsius = milliC / 1000.0;
+        temps.sensors.push_back({s.chip, s.label, celsius});
+        temps.max = std::max(temps.max, celsius);
+
+        if (s.kind == Kind::Package) {
+            if (std::size_t(s.package) >= temps.packages.size())
+                temps.packages.resize(std::size_t(s.package) + 1, -1.0);
+            temps.packages[std::size_t(s.package)] = celsius;
+        } else if (s.kind == Kind::Core) {
+            temps.cores.push_back({qint16(s.package), qint16(s.core), celsius});
+        }
+    }
+
+    // A device disappeared underneath us; look again next time
+    if (lost) m_discovered = false;
+    return temps;
+}
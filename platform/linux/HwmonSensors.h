@@ -0,0 +1,47 @@
+#pragma once
+
+#include <core/CpuStats.h>
+#include <platform/linux/ProcFile.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// CPU temperature sensors under /sys/class/hwmon. Discovery (walking the
+// hwmon devices, matching CPU drivers, reading temp*_label) runs once; after
+// that every temp*_input stays open and a sample is one pread per sensor.
+// Rediscovery happens on refresh(), every rescanInterval (sysfs does not
+// send inotify events for devices coming and going), or when a sensor read
+// fails because its device went away.
+class HwmonSensors {
+public:
+    explicit HwmonSensors(std::string hwmonRoot = "/sys/class/hwmon",
+                          std::chrono::seconds rescanInterval = std::chrono::seconds(30));
+
+    HwmonSensors(const HwmonSensors&) = delete;
+    HwmonSensors& operator=(const HwmonSensors&) = delete;
+
+    void refresh();
+    CpuTemperatures read();
+
+    std::size_t sensorCount() const { return m_sensors.size(); }
+
+private:
+    enum class Kind { Package, Core, Other };
+
+    struct Sensor {
+        ProcFile input;
+        QString chip;
+        QString label;
+        Kind kind = Kind::Other;
+        int package = 0;
+        int core = 0;
+    };
+
+    void discover();
+
+    std::string m_root;
+    std::chrono::seconds m_rescanInterval;
+    std::chrono::steady_clock::time_point m_lastDiscovery{};
+    std::vector<Sensor> m_sensors;
+    bool m_discovered = false;
+};
@@ -1,217 +1,98 @@
 #include <platform/linux/LinuxSystemMonitor.h>
-#include <fstream>
-#include <sstream>
+#include <platform/linux/ProcReaders.h>
+#include <platform/linux/HwmonSensors.h>
+#include <platform/linux/CpuFreqReader.h>
+#include <platform/linux/CpuUsageSampler.h>
+#include <algorithm>
 #include <string>
-#include <dirent.h>
 #include <unistd.h>
-#include <filesystem>
-#include <thread>
-#include <regex>
+#include <sys/resource.h>
 #include <sys/types.h>
 
-namespace fs = std::filesystem;
-
 // ----- CPU -----
-struct CpuLoad {
-    unsigned long long user=0, nice=0, system=0, idle=0;
-};
-
-static double readCpuTemperature() {
-    namespace fs = std::filesystem;
-
-    for (const auto& entry : fs::directory_iterator("/sys/class/hwmon")) {
-        std::ifstream nameFile(entry.path() / "name");
-        std::string chipName;
-        if (nameFile && std::getline(nameFile, chipName)) {
-            // Filter only CPU-related sensors
-            if (chipName.find("coretemp") != std::string::npos ||
-                chipName.find("k10temp") != std::string::npos ||
-                chipName.find("cpu") != std::string::npos)
-            {
-                // Many hwmon devices have multiple temp*_input
-                for (int i = 1; i < 10; ++i) {
-                    std::ifstream tempFile(entry.path() / ("temp" + std::to_string(i) + "_input"));
-                    if (tempFile) {
-                        long milliC;
-                        tempFile >> milliC;
-                        return milliC / 1000.0; // convert to Celsius
-                    }
-                }
-            }
-        }
-    }
-    return -1.0; // unavailable
+static CpuTemperatures readCpuTemperature(HwmonSensors& hwmon)
+{
+    return hwmon.read();
 }
 
 // -------- CPU LOAD --------
-static CpuLoad readCpuLoad()
+// Fills the utilization fields of cpu from one pass over /proc/stat and
+// returns the aggregate usage; perCore = false stops after the "cpu" line
+static double cpuPercent(ProcFile& procStat, CpuUsageSampler& sampler, CpuStats& cpu, bool perCore)
 {
-    CpuLoad load{};
-    std::ifstream file("/proc/stat");
-    std::string cpu;
-    if (file.is_open()) {
-        file >> cpu >> load.user >> load.nice >> load.system >> load.idle;
-    }
-    return load;
-}
-
-static CpuCoresStats readLinuxCpuCores()
-{
-    CpuCoresStats stats;
-    double sumMhz = 0.0;
-    int count = 0;
-
-    // ---- 1) sysfs: /sys/devices/system/cpu/cpu*/cpufreq/scaling_cur_freq ----
-    const fs::path sysCpu = "/sys/devices/system/cpu";
-    std::regex cpuDirRe(R"(cpu(\d+))");
-    bool gotSysfs = false;
-
-    if (fs::exists(sysCpu) && fs::is_directory(sysCpu)) {
-        for (const auto& entry : fs::directory_iterator(sysCpu)) {
-            if (!entry.is_directory()) continue;
-            const std::string name = entry.path().filename().string();
-            std::smatch m;
-            if (!std::regex_match(name, m, cpuDirRe)) continue;
-
-            int coreId = std::stoi(m[1].str());
-            fs::path freqFile = entry.path() / "cpufreq" / "scaling_cur_freq";
-            if (!fs::exists(freqFile)) continue;
-
-            std::ifstream f(freqFile);
-            long long khz = 0;
-            if (f && (f >> khz) && khz > 0) {
-                double mhz = khz / 1000.0;
-                stats.coresMap[coreId] = mhz;
-                sumMhz += mhz;
-                ++count;
-                gotSysfs = true;
-            }
-        }
-    }
-
-    // ---- 2) fallback: /proc/cpuinfo -> “cpu MHz” lines (one per CPU) ----
-    if (!gotSysfs) {
-        std::ifstream ci("/proc/cpuinfo");
-        std::string line;
-        int coreId = 0;
-        while (std::getline(ci, line)) {
-            if (line.rfind("cpu MHz", 0) == 0) {
-                auto pos = line.find(':');
-                if (pos != std::string::npos) {
-                    double mhz = std::stod(line.substr(pos + 1));
-                    stats.coresMap[coreId++] = mhz;
-                    sumMhz += mhz;
-                    ++count;
-                }
-            }
-        }
-    }
-
-    // ---- 3) finalize / last-resort cores count ----
-    stats.totalCores = count;
-    stats.averageFreq = (count > 0) ? (sumMhz / count) : 0.0;
-
-    if (stats.totalCores == 0) {
-        // at least report core count even if freq unavailable
-        stats.totalCores = int(std::thread::hardware_concurrency());
-    }
-
-    return stats;
+    sampler.sample(procStat.read(), cpu, perCore);
+    return cpu.cpuUsage;
 }
 
-static double cpuPercent()
+static CpuCoresStats readLinuxCpuCores(CpuFreqReader& freq)
 {
-    static bool first = true;
-    static CpuLoad prev;
-    CpuLoad cur = readCpuLoad();
-
-    if (first) { prev = cur; first = false; return 0.0; }
-
-    unsigned long long userDiff = cur.user - prev.user;
-    unsigned long long niceDiff = cur.nice - prev.nice;
-    unsigned long long sysDiff  = cur.system - prev.system;
-    unsigned long long idleDiff = cur.idle - prev.idle;
-    prev = cur;
-
-    double total = userDiff + niceDiff + sysDiff + idleDiff;
-    if (total == 0) return 0.0;
-    return 100.0 * (userDiff + niceDiff + sysDiff) / total;
+    return freq.read();
 }
 
 // -------- MEMORY --------
-static MemStats readMemStats()
+static MemStats readMemStats(ProcFile& meminfo)
 {
     MemStats ms{};
-    std::ifstream file("/proc/meminfo");
-    std::string key;
-    unsigned long value;
-    std::string unit;
-
-    unsigned long memFree=0, buffers=0, cached=0;
-
-    while (file >> key >> value >> unit) {
-        if (key == "MemTotal:")   ms.total = value * 1024ULL;
-        else if (key == "MemFree:") memFree = value * 1024ULL;
-        else if (key == "Buffers:") buffers = value * 1024ULL;
-        else if (key == "Cached:") cached = value * 1024ULL;
-        else if (key == "SwapTotal:") ms.swapTotal = value * 1024ULL;
-        else if (key == "SwapFree:") {
-            unsigned long swapFree = value * 1024ULL;
-            ms.swapUsed = ms.swapTotal - swapFree;
-        }
-    }
-
-    ms.free = memFree + buffers + cached;
-    ms.used = ms.total - ms.free;
+    parseMemInfo(meminfo.read(), ms);
     return ms;
 }
 
-// -------- PROCESSES / THREADS --------
-static ProcessThreadTotals readProcessThreadTotals()
-{
-    ProcessThreadTotals totals{};
-
-    DIR *proc = opendir("/proc");
-    if (!proc) return totals;
-
-    struct dirent *entry;
-    while ((entry = readdir(proc)) != nullptr) {
-        // Only numeric dirs are PIDs
-        pid_t pid = atoi(entry->d_name);
-        if (pid <= 0) continue;
-
-        std::string statusPath = std::string("/proc/") + entry->d_name + "/status";
-        std::ifstream statusFile(statusPath);
-        if (!statusFile.is_open()) continue;
-
-        std::string line;
-        int threads = 0;
-        while (std::getline(statusFile, line)) {
-            if (line.rfind("Threads:", 0) == 0) {
-                std::istringstream iss(line);
-                std::string tmp;
-                iss >> tmp >> threads;
-                break;
-            }
-        }
-
-        totals.processCount++;
-        totals.threadCount += threads;
-    }
+// -------- PRESSURE --------
+static ResourcePressure readPressure(ProcFile& file)
+{
+    ResourcePressure rp;
+    if (file.isOpen()) parsePressure(file.read(), rp);
+    return rp;
+}
 
-    closedir(proc);
-    return totals;
+// -------- PROCESSES / THREADS --------
+static ProcessThreadTotals readProcessThreadTotals(ProcScanner& scanner, ProcEventTracker& events)
+{
+    if (events.isActive()) return events.totals();
+    return scanner.scanTotals();
 }
 
 
 
 // -------- Implementation --------
+LinuxSystemMonitor::LinuxSystemMonitor(const LinuxMonitorOptions& options)
+    : m_procStat(options.procRoot + "/stat", 64 * 1024)   // cpu lines come first; the intr line may be truncated
+    , m_meminfo(options.procRoot + "/meminfo", 8 * 1024)
+    , m_cpuPressure(options.procRoot + "/pressure/cpu", 256)
+    , m_memoryPressure(options.procRoot + "/pressure/memory", 256)
+    , m_ioPressure(options.procRoot + "/pressure/io", 256)
+    , m_scanner(options.procRoot, 0, options.ioUring ? ProcScanner::Backend::IoUring : ProcScanner::Backend::Sync)
+    , m_processTable(m_scanner)
+    , m_procEvents(m_scanner, options.procRescanInterval)
+    , m_hwmon(options.sysRoot + "/class/hwmon")
+    , m_cpuFreq(options.sysRoot + "/devices/system/cpu", options.procRoot + "/cpuinfo")
+    , m_cgroups(options.sysRoot + "/fs/cgroup", options.cgroupWorkers)
+    , m_disks(options.procRoot, options.sysRoot)
+    , m_net(options.procRoot, options.sysRoot)
+    , m_threads(m_scanner)
+{
+    // Without CAP_NET_ADMIN this fails and we keep scanning /proc
+    if (options.procEvents) m_procEvents.start();
+}
+
 CpuStats LinuxSystemMonitor::getCpuStats()
+{
+    return getCpuStats(Metric::Cpu);
+}
+
+CpuStats LinuxSystemMonitor::getCpuStats(MetricMask fields)
 {
     CpuStats cpu{};
-    cpu.cpuUsage = cpuPercent();
-    cpu.cores = readLinuxCpuCores();
-    cpu.cpuClock = cpu.cores.averageFreq;
+    if (fields & (Metric::CpuUsage | Metric::CpuPerCore)) {
+        ProbeScope probe(m_probes.cpuUsage);
+        cpu.cpuUsage = cpuPercent(m_procStat, m_cpuUsage, cpu, fields & Metric::CpuPerCore);
+    }
+    // One scaling_cur_freq pread per online CPU
+    if (fields & Metric::CpuFrequency) {
+        ProbeScope probe(m_probes.cpuFrequency);
+        cpu.cores = readLinuxCpuCores(m_cpuFreq);
+        cpu.cpuClock = cpu.cores.averageFreq;
+    }
 
     /*
     // For clock frequency, we can read from /proc/cpuinfo (first processor)
@@ -227,16 +108,119 @@ CpuStats LinuxSystemMonitor::getCpuStats()
         }
     }
     */
-    cpu.cpuTemperature = readCpuTemperature(); // Usually requires lm-sensors or /sys/class/thermal
+    // One pread per hwmon sensor
+    if (!(fields & Metric::CpuTemperature)) return cpu;
+    {
+        ProbeScope probe(m_probes.cpuTemperature);
+        cpu.temperatures = readCpuTemperature(m_hwmon);
+    }
+    if (!cpu.temperatures.packages.empty() && cpu.temperatures.packages[0] >= 0)
+        cpu.cpuTemperature = cpu.temperatures.packages[0];
+    else if (!cpu.temperatures.sensors.empty())
+        cpu.cpuTemperature = cpu.temperatures.sensors.front().celsius;
+    else
+        cpu.cpuTemperature = -1.0; // unavailable
     return cpu;
 }
 
 MemStats LinuxSystemMonitor::getMemStats()
 {
-    return readMemStats();
+    ProbeScope probe(m_probes.memory);
+    return readMemStats(m_meminfo);
+}
+
+PressureStats LinuxSystemMonitor::getPressureStats()
+{
+    ProbeScope probe(m_probes.pressure);
+    PressureStats ps;
+    ps.cpu = readPressure(m_cpuPressure);
+    ps.memory = readPressure(m_memoryPressure);
+    ps.io = readPressure(m_ioPressure);
+    return ps;
+}
+
+DiskStats LinuxSystemMonitor::getDiskStats()
+{
+    ProbeScope probe(m_probes.disk);
+    return m_disks.read();
+}
+
+NetStats LinuxSystemMonitor::getNetStats()
+{
+    ProbeScope probe(m_probes.network);
+    return m_net.read();
 }
 
 ProcessThreadTotals LinuxSystemMonitor::getProcessThreadCount()
 {
-    return readProcessThreadTotals();
+    ProbeScope probe(m_probes.processes);
+    return readProcessThreadTotals(m_scanner, m_procEvents);
+}
+
+void LinuxSystemMonitor::refreshSensors()
+{
+    m_hwmon.refresh();
+}
+
+ProcessTable LinuxSystemMonitor::getProcessTable()
+{
+    ProbeScope probe(m_probes.processTable);
+    if (!m_procEvents.isActive()) return m_processTable.refresh();
+
+    const std::vector<int>& pids = m_procEvents.pids();
+    m_procEvents.takeExecs(m_execs);
+    for (int pid : m_execs) m_processTable.invalidateStatic(pid);
+    return m_processTable.refresh(pids);
+}
+
+TopProcesses LinuxSystemMonitor::getTopProcesses(int n, ProcessSortKey key)
+{
+    ProbeScope probe(m_probes.topProcesses);
+    const std::size_t keep = std::size_t(std::max(0, n));
+    if (!m_procEvents.isActive()) return m_processTable.top(keep, key);
+
+    m_procEvents.takeExecs(m_execs);
+    for (int pid : m_execs) m_processTable.invalidateStatic(pid);
+    return m_processTable.top(m_procEvents.pids(), keep, key);
+}
+
+CgroupTable LinuxSystemMonitor::getCgroupTable()
+{
+    ProbeScope probe(m_probes.cgroups);
+    return m_cgroups.read();
+}
+
+bool LinuxSystemMonitor::watchProcess(qint32 pid)
+{
+    return m_threads.watch(pid);
+}
+
+void LinuxSystemMonitor::unwatchProcess(qint32 pid)
+{
+    m_threads.unwatch(pid);
+}
+
+ThreadTable LinuxSystemMonitor::getThreadTable()
+{
+    ProbeScope probe(m_probes.threads);
+    return m_threads.read();
+}
+
+SelfStats LinuxSystemMonitor::getSelfStats()
+{
+    SelfStats s;
+    const CollectorProbe* probes[] = {
+        &m_probes.cpuUsage, &m_probes.cpuFrequency, &m_probes.cpuTemperature, &m_probes.memory,
+        &m_probes.processes, &m_probes.pressure, &m_probes.disk, &m_probes.network,
+        &m_probes.processTable, &m_probes.topProcesses, &m_probes.cgroups, &m_probes.threads,
+    };
+    s.collectors.reserve(std::size(probes));
+    for (const CollectorProbe* p : probes) s.collectors.push_back(p->stats());
+
+    rusage usage{};
+    if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+        s.cpuSeconds = double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+                     + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+    return s;
 }
@@ -1,12 +1,108 @@
 #pragma once
 
 #include <core/ISystemMonitor.h>
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ProcFile.h>
+#include <platform/linux/ProcScanner.h>
+#include <platform/linux/ProcessTableCache.h>
+#include <platform/linux/ProcEventTracker.h>
+#include <platform/linux/HwmonSensors.h>
+#include <platform/linux/CpuFreqReader.h>
+#include <platform/linux/CpuUsageSampler.h>
+#include <platform/linux/CgroupCollector.h>
+#include <platform/linux/DiskStatsReader.h>
+#include <platform/linux/NetDevReader.h>
+#include <platform/linux/ThreadWatcher.h>
+#include <chrono>
+#include <string>
 
 
+struct LinuxMonitorOptions {
+    // Where procfs and sysfs are mounted; point these at a synthetic tree
+    // to benchmark or load-test the collectors
+    std::string procRoot = "/proc";
+    std::string sysRoot = "/sys";
+
+    // Track processes through the netlink proc connector instead of scanning
+    // /proc every tick. Falls back to scanning if the connector is unavailable.
+    bool procEvents = false;
+    // Full /proc rescan interval that reconciles the event-driven counts
+    std::chrono::seconds procRescanInterval{30};
+
+    // Read <pid>/stat in io_uring batches when counting processes/threads.
+    // Silently stays synchronous where io_uring is unavailable.
+    bool ioUring = false;
+
+    // Helper threads reading cgroups in getCgroupTable(); 0 reads inline
+    unsigned cgroupWorkers = 0;
+};
+
 class LinuxSystemMonitor : public ISystemMonitor {
 public:
+    explicit LinuxSystemMonitor(const LinuxMonitorOptions& options = {});
     ~LinuxSystemMonitor() override = default;
     CpuStats getCpuStats() override;
+    CpuStats getCpuStats(MetricMask fields) override;
     MemStats getMemStats() override;
     ProcessThreadTotals getProcessThreadCount() override;
+    PressureStats getPressureStats() override;
+    DiskStats getDiskStats() override;
+    NetStats getNetStats() override;
+    ProcessTable getProcessTable() override;
+    // Selects while walking /proc; totals come from the same walk
+    TopProcesses getTopProcesses(int n, ProcessSortKey key) override;
+    // The hierarchy under <sysRoot>/fs/cgroup is walked on the first call
+    CgroupTable getCgroupTable() override;
+    // Watched threads keep their stat, schedstat and status files open.
+    // Both only queue a change in ThreadWatcher, so any thread may call them.
+    bool watchProcess(qint32 pid) override;
+    void unwatchProcess(qint32 pid) override;
+    ThreadTable getThreadTable() override;
+    // Reads only atomics: safe from any thread, concurrently with collection
+    SelfStats getSelfStats() override;
+
+    // True when process accounting runs on proc connector events
+    bool usingProcEvents() const { return m_procEvents.isActive(); }
+    // True when /proc scans go through io_uring
+    bool usingIoUring() const { return m_scanner.backend() == ProcScanner::Backend::IoUring; }
+
+    // Forces hwmon sensor rediscovery on the next getCpuStats()
+    void refreshSensors();
+
+private:
+    // Opened once, re-read with pread() on every sample
+    ProcFile m_procStat;
+    ProcFile m_meminfo;
+    ProcFile m_cpuPressure;
+    ProcFile m_memoryPressure;
+    ProcFile m_ioPressure;
+    ProcScanner m_scanner;
+    ProcessTableCache m_processTable;
+    ProcEventTracker m_procEvents;
+    std::vector<int> m_execs;
+    HwmonSensors m_hwmon;
+    CpuFreqReader m_cpuFreq;
+    CpuUsageSampler m_cpuUsage;
+    CgroupCollector m_cgroups;
+    DiskStatsReader m_disks;
+    NetDevReader m_net;
+    ThreadWatcher m_threads;
+
+    // One per collector; a getter times itself into its probe and charges
+    // the syscalls made on its behalf
+    struct Probes {
+        CollectorProbe cpuUsage{"cpu.usage"};
+        CollectorProbe cpuFrequency{"cpu.frequency"};
+        CollectorProbe cpuTemperature{"cpu.temperature"};
+        CollectorProbe memory{"memory"};
+        CollectorProbe processes{"processes"};
+        CollectorProbe pressure{"pressure"};
+        CollectorProbe disk{"disk"};
+        CollectorProbe network{"network"};
+        CollectorProbe processTable{"process.table"};
+        CollectorProbe topProcesses{"process.top"};
+        CollectorProbe cgroups{"cgroups"};
+        CollectorProbe threads{"threads"};
+    };
+    Probes m_probes;
 };
@@ -0,0 +1,129 @@
+#include <platform/linux/NetDevReader.h>
+#include <platform/linux/ProcParse.h>
+
+using namespace procparse;
+
+NetDevReader::NetDevReader(const std::string& procRoot, std::string sysRoot)
+    : m_file(procRoot + "/net/dev", 16 * 1024)
+    , m_sysRoot(std::move(sysRoot))
+{
+}
+
+int NetDevReader::readIfindex(const std::string& name) const
+{
+    ProcFile f(m_sysRoot + "/class/net/" + name + "/ifindex", 32);
+    const std::string_view text = f.read();
+    const char* p = text.data();
+    unsigned long long v = 0;
+    return parseU64(p, p + text.size(), v) ? int(v) : 0;
+}
+
+int NetDevReader::intern(std::string_view name)
+{
+    std::string key(name);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) return it->second;
+
+    Interface i;
+    i.name = QString::fromStdString(key);
+    i.ifindex = readIfindex(key);
+    i.key = std::move(key);
+    const int slot = int(m_interfaces.size());
+    m_index.emplace(i.key, slot);
+    m_interfaces.push_back(std::move(i));
+    return slot;
+}
+
+NetStats NetDevReader::read()
+{
+    NetStats out;
+    const std::string_view text = m_file.readAll();
+    if (text.empty()) return out;
+
+    const auto now = std::chrono::steady_clock::now();
+    const bool first = m_tick == 0;
+    const double seconds = first ? 0.0 : std::chrono::duration<double>(now - m_last).count();
+    out.intervalSeconds = seconds;
+    m_last = now;
+    ++m_tick;
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+    std::size_t line = 0;
+    out.interfaces.reserve(m_interfaces.size());
+
+    while (p < end) {
+        const char* lineEnd = nextLine(p, end);
+
+        // "  eth0: 1116 16 0 0 0 0 0 0 1188 16 0 0 0 0 0 0"; the two header
+        // lines have no ':'. Old kernels glue big counters to the colon.
+        p = skipSpaces(p, lineEnd);
+        const char* nameStart = p;
+        while (p < lineEnd && *p != ':' && *p != '\n') ++p;
+        if (p >= lineEnd || *p != ':') { p = lineEnd; continue; }
+        const std::string_view name(nameStart, std::size_t(p - nameStart));
+        ++p;
+
+        unsigned long long v[16] = {};
+        int fields = 0;
+        while (fields < 16 && parseU64(p, lineEnd, v[fields])) ++fields;
+        if (name.empty() || fields < 16) { p = lineEnd; continue; }
+
+        int slot = line < m_lineInterface.size() ? m_lineInterface[line] : -1;
+        if (slot < 0 || m_interfaces[std::size_t(slot)].key != name) slot = intern(name);
+        if (line < m_lineInterface.size()) m_lineInterface[line] = slot;
+        else m_lineInterface.push_back(slot);
+        ++line;
+
+        Interface& iface = m_interfaces[std::size_t(slot)];
+        Counters c;
+        c.rxBytes = v[0];
+        c.rxPackets = v[1];
+        c.rxErrors = v[2];
+        c.rxDropped = v[3];
+        c.txBytes = v[8];
+        c.txPackets = v[9];
+        c.txErrors = v[10];
+        c.txDropped = v[11];
+
+        NetInterfaceStats s;
+        s.name = iface.name;
+        s.index = slot;
+        s.rxBytes = c.rxBytes;
+        s.rxPackets = c.rxPackets;
+        s.rxErrors = c.rxErrors;
+        s.rxDropped = c.rxDropped;
+        s.txBytes = c.txBytes;
+        s.txPackets = c.txPackets;
+        s.txErrors = c.txErrors;
+        s.txDropped = c.txDropped;
+
+        // Only a drop needs telling apart; sysfs is not read otherwise
+        const Counters& b = iface.prev;
+        const bool dropped = c.rxBytes < b.rxBytes || c.txBytes < b.txBytes || c.rxPackets < b.rxPackets
+                          || c.txPackets < b.txPackets || c.rxErrors < b.rxErrors || c.txErrors < b.txErrors;
+        if (dropped && iface.ifindex != 0) {
+            const int ifindex = readIfindex(iface.key);
+            if (ifindex != 0 && ifindex != iface.ifindex) {
+                // Another interface under the same name: its counters start over
+                iface.ifindex = ifindex;
+                iface.seenTick = 0;
+            }
+        }
+
+        if (!first && iface.seenTick + 1 == m_tick && seconds > 0) {
+            s.rxBytesPerSec = double(counterDelta(c.rxBytes, b.rxBytes)) / seconds;
+            s.txBytesPerSec = double(counterDelta(c.txBytes, b.txBytes)) / seconds;
+            s.rxPacketsPerSec = double(counterDelta(c.rxPackets, b.rxPackets)) / seconds;
+            s.txPacketsPerSec = double(counterDelta(c.txPackets, b.txPackets)) / seconds;
+            s.rxErrorsPerSec = double(counterDelta(c.rxErrors, b.rxErrors)) / seconds;
+            s.txErrorsPerSec = double(counterDelta(c.txErrors, b.txErrors)) / seconds;
+        }
+        iface.prev = c;
+        iface.seenTick = m_tick;
+        out.interfaces.push_back(std::move(s));
+        p = lineEnd;
+    }
+    m_lineInterface.resize(line);
+    return out;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <core/NetStats.h>
+#include <platform/linux/ProcFile.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Per-interface byte, packet and error rates from /proc/net/dev, read the
+// same way as DiskStatsReader: one pread, in-place scanning, interfaces
+// interned once into stable indices and matched by line position first.
+// Scales to hosts with hundreds of veth interfaces; the buffer grows with
+// the file.
+//
+// /proc/net/dev names interfaces but does not number them, and a veth or tap
+// deleted and re-created under the same name starts its counters over. When
+// a counter drops, <sys>/class/net/<name>/ifindex tells such a re-creation
+// (the interface starts over, like a new one) from a 32-bit counter wrap.
+class NetDevReader {
+public:
+    explicit NetDevReader(const std::string& procRoot = "/proc", std::string sysRoot = "/sys");
+
+    NetStats read();
+
+    std::size_t interfaceCount() const { return m_interfaces.size(); }
+
+private:
+    struct Counters {
+        unsigned long long rxBytes = 0, rxPackets = 0, rxErrors = 0, rxDropped = 0;
+        unsigned long long txBytes = 0, txPackets = 0, txErrors = 0, txDropped = 0;
+    };
+
+    struct Interface {
+        std::string key;
+        QString name;
+        Counters prev;
+        quint64 seenTick = 0;
+        int ifindex = 0;                // 0 where sysfs does not say
+    };
+
+    int intern(std::string_view name);
+    int readIfindex(const std::string& name) const;
+
+    ProcFile m_file;
+    std::string m_sysRoot;
+    std::vector<Interface> m_interfaces;
+    std::unordered_map<std::string, int> m_index;
+    std::vector<int> m_lineInterface;
+    std::chrono::steady_clock::time_point m_last{};
+    quint64 m_tick = 0;
+};
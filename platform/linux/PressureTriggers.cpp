@@ -0,0 +1,153 @@
+#include <platform/linux/PressureTriggers.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+static const char* resourceFile(PressureResource resource)
+{
+    switch (resource) {
+    case PressureResource::Cpu: return "/pressure/cpu";
+    case PressureResource::Memory: return "/pressure/memory";
+    case PressureResource::Io: return "/pressure/io";
+    }
+    return "/pressure/cpu";
+}
+
+PressureTriggers::PressureTriggers(std::string procRoot)
+    : m_procRoot(std::move(procRoot))
+{
+}
+
+PressureTriggers::~PressureTriggers()
+{
+    stop();
+    for (const Trigger& t : m_triggers) ::close(t.fd);
+}
+
+int PressureTriggers::add(PressureResource resource, PressureKind kind,
+                          std::chrono::microseconds stall, std::chrono::microseconds window, Callback fn)
+{
+    const int fd = ::open((m_procRoot + resourceFile(resource)).c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // The kernel wants the trailing NUL as part of the write
+    char spec[64];
+    const int n = std::snprintf(spec, sizeof(spec), "%s %lld %lld",
+                                kind == PressureKind::Full ? "full" : "some",
+                                (long long)stall.count(), (long long)window.count());
+    if (n <= 0 || ::write(fd, spec, std::size_t(n) + 1) < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Trigger t;
+    t.id = m_nextId++;
+    t.fd = fd;
+    t.resource = resource;
+    t.kind = kind;
+    t.fn = std::make_shared<Callback>(std::move(fn));
+    m_triggers.push_back(std::move(t));
+    wake();
+    return m_triggers.back().id;
+}
+
+void PressureTriggers::remove(int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_triggers.begin(), m_triggers.end(), [id](const Trigger& t) { return t.id == id; });
+    if (it == m_triggers.end()) return;
+    // The poll thread may be waiting on this fd; closing it there avoids the
+    // number being reused under its feet
+    if (isRunning()) m_retired.push_back(it->fd);
+    else ::close(it->fd);
+    m_triggers.erase(it);
+    wake();
+}
+
+bool PressureTriggers::start()
+{
+    if (isRunning()) return true;
+    if (::pipe2(m_wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) return false;
+    m_stop = false;
+    m_thread = std::thread(&PressureTriggers::run, this);
+    return true;
+}
+
+void PressureTriggers::stop()
+{
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            wake();
+        }
+        m_thread.join();
+    }
+    for (int fd : m_retired) ::close(fd);
+    m_retired.clear();
+    for (int& fd : m_wakeFds) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+}
+
+// Caller holds m_mutex
+void PressureTriggers::wake()
+{
+    if (m_wakeFds[1] < 0) return;
+    const char byte = 1;
+    while (::write(m_wakeFds[1], &byte, 1) < 0 && errno == EINTR) {}
+}
+
+void PressureTriggers::run()
+{
+    std::vector<pollfd> fds;
+    std::vector<Trigger> polled;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stop) return;
+            for (int fd : m_retired) ::close(fd);
+            m_retired.clear();
+            polled = m_triggers;
+        }
+
+        fds.clear();
+        fds.push_back({m_wakeFds[0], POLLIN, 0});
+        for (const Trigger& t : polled) fds.push_back({t.fd, POLLPRI, 0});
+
+        if (::poll(fds.data(), nfds_t(fds.size()), -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+
+        if (fds[0].revents) {
+            char drain[64];
+            while (::read(m_wakeFds[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        for (std::size_t i = 0; i < polled.size(); ++i) {
+            const short revents = fds[i + 1].revents;
+            const Trigger& t = polled[i];
+            if (revents & (POLLERR | POLLNVAL)) {
+                // The trigger is gone (e.g. its cgroup was removed); stop polling it
+                remove(t.id);
+                continue;
+            }
+            if (!(revents & POLLPRI)) continue;
+
+            m_events.fetch_add(1, std::memory_order_relaxed);
+            PressureEvent e;
+            e.trigger = t.id;
+            e.resource = t.resource;
+            e.kind = t.kind;
+            e.time = now;
+            (*t.fn)(e);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <core/PressureStats.h>
+#include <QtCore/qtypes.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PSI triggers: the kernel signals a trigger fd as soon as stall time within
+// a window crosses a threshold ("some 150ms per 1s"), so stalls are seen
+// within milliseconds without sampling /proc/pressure any faster. One thread
+// poll()s every registered trigger and runs its callback on that thread.
+//
+// Needs Linux 5.2+. The kernel accepts windows of 500 ms to 10 s. Without
+// CAP_SYS_RESOURCE (Linux 6.5+) windows must be a multiple of 2 s and are
+// only checked on the kernel's 2 s averaging tick.
+class PressureTriggers {
+public:
+    using Callback = std::function<void(const PressureEvent&)>;
+
+    explicit PressureTriggers(std::string procRoot = "/proc");
+    ~PressureTriggers();
+
+    PressureTriggers(const PressureTriggers&) = delete;
+    PressureTriggers& operator=(const PressureTriggers&) = delete;
+
+    // Registers a trigger on /proc/pressure/<resource>; returns its id, or -1
+    // if the kernel refused it. Works before and after start().
+    int add(PressureResource resource, PressureKind kind,
+            std::chrono::microseconds stall, std::chrono::microseconds window, Callback fn);
+    // A callback already dispatched may still run once after remove()
+    // returns on another thread.
+    void remove(int id);
+
+    bool start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    // Trigger events delivered so far
+    quint64 events() const { return m_events.load(std::memory_order_relaxed); }
+
+private:
+    struct Trigger {
+        int id = -1;
+        int fd = -1;
+        PressureResource resource = PressureResource::Cpu;
+        PressureKind kind = PressureKind::Some;
+        std::shared_ptr<Callback> fn;
+    };
+
+    void run();
+    void wake();
+
+    std::string m_procRoot;
+    std::mutex m_mutex;
+    std::vector<Trigger> m_triggers;
+    std::vector<int> m_retired;         // fds the poll thread closes once out of poll()
+    int m_nextId = 1;
+    int m_wakeFds[2] = {-1, -1};
+    bool m_stop = false;
+    std::atomic<quint64> m_events{0};
+    std::thread m_thread;
+};
@@ -0,0 +1,256 @@
+#include <platform/linux/ProcEventTracker.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// How long start() waits for the kernel to acknowledge the subscription
+constexpr int kAckTimeoutMs = 500;
+
+bool sendMcastOp(int sock, proc_cn_mcast_op op, unsigned tag = 0)
+{
+    alignas(nlmsghdr) char buf[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+    auto* nl = reinterpret_cast<nlmsghdr*>(buf);
+    nl->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(op));
+    nl->nlmsg_type = NLMSG_DONE;
+
+    auto* cn = static_cast<cn_msg*>(NLMSG_DATA(nl));
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->ack = tag;
+    cn->len = sizeof(op);
+    std::memcpy(cn->data, &op, sizeof(op));
+
+    return ::send(sock, nl, nl->nlmsg_len, 0) == ssize_t(nl->nlmsg_len);
+}
+
+// Waits for the PROC_EVENT_NONE acknowledging our mcast op and returns its
+// verdict. Acks go to the whole group; ours echoes tag + 1 in cn_msg::ack
+// (the kernel fills in seq itself).
+// Events queued ahead of it are dropped: the caller rescans afterwards.
+// False on a rejection (EPERM outside the initial user/pid namespace) or no
+// answer within kAckTimeoutMs (kernels that reject silently).
+bool awaitAck(int sock, unsigned tag)
+{
+    alignas(nlmsghdr) char buf[8192];
+    int waitedMs = 0;
+    while (waitedMs < kAckTimeoutMs) {
+        ssize_t n = ::recv(sock, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) return false;
+            pollfd pfd{sock, POLLIN, 0};
+            if (::poll(&pfd, 1, 50) == 0) waitedMs += 50;
+            continue;
+        }
+        int len = int(n);
+        for (auto* nl = reinterpret_cast<nlmsghdr*>(buf); NLMSG_OK(nl, len); nl = NLMSG_NEXT(nl, len)) {
+            if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_NOOP) continue;
+            const auto* cn = static_cast<const cn_msg*>(NLMSG_DATA(nl));
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC) continue;
+            if (cn->ack != tag + 1) continue;
+            const auto* ev = reinterpret_cast<const proc_event*>(cn->data);
+            if (ev->what == proc_event::PROC_EVENT_NONE) return ev->event_data.ack.err == 0;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ProcEventTracker::ProcEventTracker(ProcScanner& scanner, std::chrono::seconds rescanInterval)
+    : m_scanner(scanner)
+    , m_rescanInterval(rescanInterval)
+    , m_recvBuf(64 * 1024)
+{
+}
+
+ProcEventTracker::~ProcEventTracker()
+{
+    stop();
+}
+
+bool ProcEventTracker::start()
+{
+    if (m_sock >= 0) return true;
+
+    int sock = ::socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock < 0) return false;
+
+    // Bursts of forks between two ticks must fit; FORCE needs CAP_NET_ADMIN,
+    // which we have if the subscription below is going to work at all
+    int rcvbuf = 8 * 1024 * 1024;
+    if (::setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) < 0)
+        ::setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    sockaddr_nl sa{};
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = CN_IDX_PROC;
+    sa.nl_pid = 0; // let the kernel pick a port id
+
+    // Any nonzero tag distinguishes our ack from those of other listeners
+    const unsigned tag = (unsigned(::getpid()) ^ unsigned(sock) << 24 ^ 0x5359534dU) & 0x7fffffffU;
+    if (::bind(sock, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) < 0
+        || !sendMcastOp(sock, PROC_CN_MCAST_LISTEN, tag)) {
+        ::close(sock);
+        return false;
+    }
+    // A send that went through does not mean the kernel accepted it
+    if (!awaitAck(sock, tag)) {
+        sendMcastOp(sock, PROC_CN_MCAST_IGNORE);
+        ::close(sock);
+        return false;
+    }
+
+    m_sock = sock;
+    // Baseline after subscribing so no event falls between the two
+    rescan();
+    return true;
+}
+
+void ProcEventTracker::stop()
+{
+    if (m_sock < 0) return;
+    sendMcastOp(m_sock, PROC_CN_MCAST_IGNORE);
+    ::close(m_sock);
+    m_sock = -1;
+}
+
+void ProcEventTracker::onFork(int childPid, int childTgid)
+{
+    if (childPid == childTgid) {
+        // New process starts with one thread; ignore if the rescan saw it
+        if (m_threads.emplace(childTgid, 1).second) {
+            ++m_threadTotal;
+            m_pidListDirty = true;
+        }
+    } else {
+        auto it = m_threads.find(childTgid);
+        if (it != m_threads.end()) {
+            ++it->second;
+            ++m_threadTotal;
+        }
+    }
+}
+
+void ProcEventTracker::onExit(int pid, int tgid)
+{
+    auto it = m_threads.find(tgid);
+    if (it == m_threads.end()) return;
+
+    if (pid == tgid) {
+        // Group leader gone: treat the whole process as exited
+        m_threadTotal -= it->second;
+        m_threads.erase(it);
+        m_execs.erase(tgid);
+        m_pidListDirty = true;
+    } else if (it->second > 1) {
+        --it->second;
+        --m_threadTotal;
+    }
+}
+
+bool ProcEventTracker::drain()
+{
+    for (;;) {
+        ssize_t n = ::recv(m_sock, m_recvBuf.data(), m_recvBuf.size(), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            // ENOBUFS: the receive queue overflowed and events are lost
+            return false;
+        }
+        if (n == 0) return true;
+
+        int len = int(n);
+        for (auto* nl = reinterpret_cast<nlmsghdr*>(m_recvBuf.data()); NLMSG_OK(nl, len);
+             nl = NLMSG_NEXT(nl, len)) {
+            if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_NOOP) continue;
+
+            auto* cn = static_cast<cn_msg*>(NLMSG_DATA(nl));
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC) continue;
+
+            const auto* ev = reinterpret_cast<const proc_event*>(cn->data);
+            switch (ev->what) {
+            case proc_event::PROC_EVENT_FORK:
+                onFork(ev->event_data.fork.child_pid, ev->event_data.fork.child_tgid);
+                break;
+            case proc_event::PROC_EVENT_EXEC:
+                m_execs.insert(ev->event_data.exec.process_tgid);
+                break;
+            case proc_event::PROC_EVENT_EXIT:
+                onExit(ev->event_data.exit.process_pid, ev->event_data.exit.process_tgid);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void ProcEventTracker::rescan()
+{
+    // Empty the socket before scanning, applying what is queued. Those events
+    // predate the scan, which already reflects them and replaces their effect
+    // on the counts below; left queued, they would be applied on top of the
+    // scan and counted twice. Applying (not discarding) them keeps their exec
+    // notices. Events that race with the scan still arrive afterwards:
+    // process fork/exit is idempotent (emplace/erase), a thread event may
+    // leave a count off by one until the next rescan.
+    if (m_sock >= 0) drain();
+
+    m_scanner.scanThreads(m_scanPids, m_scanThreads);
+
+    m_threads.clear();
+    m_threadTotal = 0;
+    for (std::size_t i = 0; i < m_scanPids.size(); ++i) {
+        if (m_scanThreads[i] < 0) continue;
+        m_threads.emplace(m_scanPids[i], m_scanThreads[i]);
+        m_threadTotal += m_scanThreads[i];
+    }
+    m_pidListDirty = true;
+    m_lastRescan = std::chrono::steady_clock::now();
+    ++m_rescans;
+}
+
+void ProcEventTracker::update()
+{
+    if (m_sock < 0) return;
+
+    const bool complete = drain();
+    if (!complete || std::chrono::steady_clock::now() - m_lastRescan >= m_rescanInterval)
+        rescan();
+}
+
+ProcessThreadTotals ProcEventTracker::totals()
+{
+    update();
+    ProcessThreadTotals totals{};
+    totals.processCount = qint32(m_threads.size());
+    totals.threadCount = m_threadTotal;
+    return totals;
+}
+
+const std::vector<int>& ProcEventTracker::pids()
+{
+    update();
+    if (m_pidListDirty) {
+        m_pidList.clear();
+        m_pidList.reserve(m_threads.size());
+        for (const auto& kv : m_threads) m_pidList.push_back(kv.first);
+        m_pidListDirty = false;
+    }
+    return m_pidList;
+}
+
+void ProcEventTracker::takeExecs(std::vector<int>& out)
+{
+    out.assign(m_execs.begin(), m_execs.end());
+    m_execs.clear();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <core/ProcessStats.h>
+#include <platform/linux/ProcScanner.h>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Event-driven process/thread accounting from the kernel proc connector
+// (NETLINK_CONNECTOR, CN_IDX_PROC). fork/exit events keep a per-process
+// thread count current, so a tick costs O(events) instead of O(PIDs).
+// A full ProcScanner pass still runs every rescanInterval, and immediately
+// after the socket reports lost events, to reconcile drift.
+//
+// start() fails without CAP_NET_ADMIN, or when the kernel does not
+// acknowledge the subscription (outside the initial user/pid namespace);
+// callers then stay on the scan path.
+class ProcEventTracker {
+public:
+    ProcEventTracker(ProcScanner& scanner, std::chrono::seconds rescanInterval);
+    ~ProcEventTracker();
+
+    ProcEventTracker(const ProcEventTracker&) = delete;
+    ProcEventTracker& operator=(const ProcEventTracker&) = delete;
+
+    bool start();
+    void stop();
+    bool isActive() const { return m_sock >= 0; }
+
+    // Applies queued events (rescanning if due) and returns the totals.
+    ProcessThreadTotals totals();
+
+    // Current process (tgid) set, refreshed like totals().
+    const std::vector<int>& pids();
+
+    // PIDs that exec'd since the last call; their comm/cmdline are stale.
+    void takeExecs(std::vector<int>& out);
+
+    unsigned long long rescanCount() const { return m_rescans; }
+
+private:
+    void update();
+    bool drain();   // false if the kernel dropped events
+    void rescan();
+    void onFork(int childPid, int childTgid);
+    void onExit(int pid, int tgid);
+
+    ProcScanner& m_scanner;
+    std::chrono::seconds m_rescanInterval;
+    std::chrono::steady_clock::time_point m_lastRescan{};
+    int m_sock = -1;
+
+    std::unordered_map<int, int> m_threads;  // tgid -> thread count
+    qlonglong m_threadTotal = 0;
+    std::unordered_set<int> m_execs;
+    std::vector<int> m_pidList;
+    bool m_pidListDirty = true;
+
+    std::vector<char> m_recvBuf;
+    std::vector<int> m_scanPids;
+    std::vector<int> m_scanThreads;
+    unsigned long long m_rescans = 0;
+};
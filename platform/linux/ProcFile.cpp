@@ -0,0 +1,89 @@
+#include <platform/linux/ProcFile.h>
+#include <core/SelfInstrumentation.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcFile::ProcFile(std::size_t capacity)
+    : m_buf(capacity)
+{
+}
+
+ProcFile::ProcFile(const std::string& path, std::size_t capacity)
+    : m_buf(capacity)
+{
+    open(path);
+}
+
+ProcFile::~ProcFile()
+{
+    close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : m_fd(other.m_fd), m_error(other.m_error), m_buf(std::move(other.m_buf))
+{
+    other.m_fd = -1;
+}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        m_fd = other.m_fd;
+        m_error = other.m_error;
+        m_buf = std::move(other.m_buf);
+        other.m_fd = -1;
+    }
+    return *this;
+}
+
+bool ProcFile::open(const std::string& path)
+{
+    close();
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    return m_fd >= 0;
+}
+
+void ProcFile::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+std::string_view ProcFile::read()
+{
+    m_error = 0;
+    if (m_fd < 0 || m_buf.empty()) return {};
+
+    // procfs regenerates the content on every read at offset 0. seq_file and
+    // sysfs fill the whole request unless they hit EOF, as do regular files,
+    // so a short read is the end and only a full buffer needs another look.
+    std::size_t off = 0;
+    while (off < m_buf.size()) {
+        const std::size_t want = m_buf.size() - off;
+        ssize_t n = ::pread(m_fd, m_buf.data() + off, want, off_t(off));
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            m_error = errno;
+            return {};
+        }
+        off += std::size_t(n);
+        if (std::size_t(n) < want) break;
+    }
+    return std::string_view(m_buf.data(), off);
+}
+
+std::string_view ProcFile::readAll()
+{
+    std::string_view content = read();
+    // A full buffer may mean the file was cut short
+    while (m_fd >= 0 && !m_buf.empty() && content.size() == m_buf.size()) {
+        m_buf.resize(m_buf.size() * 2);
+        content = read();
+    }
+    return content;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A procfs/sysfs file that is opened once and re-read with pread() from
+// offset 0 into a buffer allocated up front, so sampling it costs a single
+// syscall and no allocation as long as the content fits the buffer.
+class ProcFile {
+public:
+    explicit ProcFile(std::size_t capacity = 4096);
+    ProcFile(const std::string& path, std::size_t capacity);
+    ~ProcFile();
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+    int fd() const { return m_fd; }
+
+    // Re-reads the whole file (up to capacity). Returns an empty view on error.
+    // The view stays valid until the next read().
+    std::string_view read();
+    // errno of the last failed read(), 0 after one that succeeded
+    int error() const { return m_error; }
+
+    // Like read(), but doubles the buffer until the whole file fits. For
+    // files that grow with the host (one line per device or interface).
+    std::string_view readAll();
+
+private:
+    int m_fd = -1;
+    int m_error = 0;
+    std::vector<char> m_buf;
+};
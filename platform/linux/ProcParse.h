@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string_view>
+
+// Minimal non-allocating scanners for procfs/sysfs text. Each helper works on
+// a [p, end) cursor and never reads past end.
+namespace procparse {
+
+inline const char* skipSpaces(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* skipToken(const char* p, const char* end)
+{
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n') ++p;
+    return p;
+}
+
+// Returns the start of the next line (or end).
+inline const char* nextLine(const char* p, const char* end)
+{
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+inline bool startsWith(const char* p, const char* end, std::string_view prefix)
+{
+    return std::string_view::size_type(end - p) >= prefix.size()
+        && std::string_view(p, prefix.size()) == prefix;
+}
+
+// Parses an unsigned decimal after optional blanks and advances p past it.
+inline bool parseU64(const char*& p, const char* end, unsigned long long& out)
+{
+    p = skipSpaces(p, end);
+    if (p >= end || *p < '0' || *p > '9') return false;
+    unsigned long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + unsigned(*p - '0');
+        ++p;
+    }
+    out = v;
+    return true;
+}
+
+inline bool parseI64(const char*& p, const char* end, long long& out)
+{
+    p = skipSpaces(p, end);
+    bool neg = false;
+    if (p < end && *p == '-') { neg = true; ++p; }
+    unsigned long long v = 0;
+    if (!parseU64(p, end, v)) return false;
+    out = neg ? -(long long)v : (long long)v;
+    return true;
+}
+
+// Parses a non-negative decimal such as "12.34" after optional blanks.
+inline bool parseDecimal(const char*& p, const char* end, double& out)
+{
+    unsigned long long whole = 0;
+    if (!parseU64(p, end, whole)) return false;
+    double v = double(whole);
+    if (p < end && *p == '.') {
+        double scale = 0.1;
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p, scale *= 0.1)
+            v += (*p - '0') * scale;
+    }
+    out = v;
+    return true;
+}
+
+// Growth of a cumulative kernel counter between two samples. Counters some
+// drivers still keep in 32 bits wrap at 2^32; a drop from the upper half of
+// that range is taken as such a wrap. Any other drop means the counter was
+// reset (device re-created, driver reloaded) and counts from zero.
+inline unsigned long long counterDelta(unsigned long long now, unsigned long long before)
+{
+    if (now >= before) return now - before;
+    if (before >= 0x80000000ULL && before <= 0xFFFFFFFFULL) return (0x100000000ULL - before) + now;
+    return now;
+}
+
+} // namespace procparse
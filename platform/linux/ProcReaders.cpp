@@ -0,0 +1,363 @@
+#include <platform/linux/ProcReaders.h>
+#include <platform/linux/ProcParse.h>
+#include <algorithm>
+
+using namespace procparse;
+
+bool parseCpuLoad(std::string_view procStat, CpuLoad& out)
+{
+    const char* p = procStat.data();
+    const char* end = p + procStat.size();
+
+    // "cpu  user nice system idle ..." is always the first line
+    if (!startsWith(p, end, "cpu ")) return false;
+    p += 4;
+    return parseU64(p, end, out.user)
+        && parseU64(p, end, out.nice)
+        && parseU64(p, end, out.system)
+        && parseU64(p, end, out.idle);
+}
+
+void CpuJiffies::clear()
+{
+    cpuId.clear();
+    user.clear(); nice.clear(); system.clear(); idle.clear();
+    iowait.clear(); irq.clear(); softirq.clear(); steal.clear();
+}
+
+bool parseCpuJiffies(std::string_view procStat, CpuJiffies& out)
+{
+    out.clear();
+    const char* p = procStat.data();
+    const char* end = p + procStat.size();
+
+    // The cpu lines lead the file; stop at the first other line
+    while (p < end && startsWith(p, end, "cpu")) {
+        const char* lineEnd = nextLine(p, end);
+        // A truncated last line would yield garbage counters
+        if (lineEnd == end && (lineEnd == p || lineEnd[-1] != '\n')) break;
+
+        p += 3;
+        long long id = -1;
+        if (*p != ' ' && !parseI64(p, lineEnd, id)) break;
+
+        unsigned long long v[8] = {};
+        for (unsigned long long& field : v) {
+            // Old kernels stop after idle/iowait; missing fields stay 0
+            if (!parseU64(p, lineEnd, field)) break;
+        }
+
+        out.cpuId.push_back(int(id));
+        out.user.push_back(v[0]);
+        out.nice.push_back(v[1]);
+        out.system.push_back(v[2]);
+        out.idle.push_back(v[3]);
+        out.iowait.push_back(v[4]);
+        out.irq.push_back(v[5]);
+        out.softirq.push_back(v[6]);
+        out.steal.push_back(v[7]);
+        p = lineEnd;
+    }
+    return out.size() > 0 && out.cpuId[0] == -1;
+}
+
+// -------- /proc/meminfo --------
+namespace {
+
+struct MemInfoKey {
+    std::string_view name;
+    quint64 MemInfo::*field;
+};
+
+constexpr MemInfoKey kMemInfoKeys[] = {
+    {"MemTotal", &MemInfo::memTotal},           {"MemFree", &MemInfo::memFree},
+    {"MemAvailable", &MemInfo::memAvailable},   {"Buffers", &MemInfo::buffers},
+    {"Cached", &MemInfo::cached},               {"SwapCached", &MemInfo::swapCached},
+    {"Active", &MemInfo::active},               {"Inactive", &MemInfo::inactive},
+    {"Active(anon)", &MemInfo::activeAnon},     {"Inactive(anon)", &MemInfo::inactiveAnon},
+    {"Active(file)", &MemInfo::activeFile},     {"Inactive(file)", &MemInfo::inactiveFile},
+    {"Unevictable", &MemInfo::unevictable},     {"Mlocked", &MemInfo::mlocked},
+    {"SwapTotal", &MemInfo::swapTotal},         {"SwapFree", &MemInfo::swapFree},
+    {"Zswap", &MemInfo::zswap},                 {"Zswapped", &MemInfo::zswapped},
+    {"Dirty", &MemInfo::dirty},                 {"Writeback", &MemInfo::writeback},
+    {"AnonPages", &MemInfo::anonPages},         {"Mapped", &MemInfo::mapped},
+    {"Shmem", &MemInfo::shmem},                 {"KReclaimable", &MemInfo::kReclaimable},
+    {"Slab", &MemInfo::slab},                   {"SReclaimable", &MemInfo::sReclaimable},
+    {"SUnreclaim", &MemInfo::sUnreclaim},       {"KernelStack", &MemInfo::kernelStack},
+    {"ShadowCallStack", &MemInfo::shadowCallStack}, {"PageTables", &MemInfo::pageTables},
+    {"SecPageTables", &MemInfo::secPageTables}, {"NFS_Unstable", &MemInfo::nfsUnstable},
+    {"Bounce", &MemInfo::bounce},               {"WritebackTmp", &MemInfo::writebackTmp},
+    {"CommitLimit", &MemInfo::commitLimit},     {"Committed_AS", &MemInfo::committedAs},
+    {"VmallocTotal", &MemInfo::vmallocTotal},   {"VmallocUsed", &MemInfo::vmallocUsed},
+    {"VmallocChunk", &MemInfo::vmallocChunk},   {"Percpu", &MemInfo::percpu},
+    {"HardwareCorrupted", &MemInfo::hardwareCorrupted},
+    {"AnonHugePages", &MemInfo::anonHugePages}, {"ShmemHugePages", &MemInfo::shmemHugePages},
+    {"ShmemPmdMapped", &MemInfo::shmemPmdMapped}, {"FileHugePages", &MemInfo::fileHugePages},
+    {"FilePmdMapped", &MemInfo::filePmdMapped}, {"CmaTotal", &MemInfo::cmaTotal},
+    {"CmaFree", &MemInfo::cmaFree},             {"Unaccepted", &MemInfo::unaccepted},
+    {"HugePages_Total", &MemInfo::hugePagesTotal}, {"HugePages_Free", &MemInfo::hugePagesFree},
+    {"HugePages_Rsvd", &MemInfo::hugePagesRsvd}, {"HugePages_Surp", &MemInfo::hugePagesSurp},
+    {"Hugepagesize", &MemInfo::hugepageSize},   {"Hugetlb", &MemInfo::hugetlb},
+    {"DirectMap4k", &MemInfo::directMap4k},     {"DirectMap2M", &MemInfo::directMap2M},
+    {"DirectMap1G", &MemInfo::directMap1G},
+};
+constexpr std::size_t kMemInfoKeyCount = sizeof(kMemInfoKeys) / sizeof(kMemInfoKeys[0]);
+
+// Perfect hash over the key set: h = h * 31 + c from a seed, folded into 256
+// slots. The seed was searched offline; buildMemInfoTable() proves at compile
+// time that no two keys share a slot, so adding a key that collides fails the
+// build and needs a new seed.
+constexpr unsigned kMemInfoSeed = 1742;
+constexpr std::size_t kMemInfoSlots = 256;
+
+constexpr unsigned memInfoHashStep(unsigned h, char c) { return h * 31u + static_cast<unsigned char>(c); }
+constexpr std::size_t memInfoSlot(unsigned h) { return (h ^ (h >> 15)) % kMemInfoSlots; }
+
+constexpr unsigned memInfoHash(std::string_view name)
+{
+    unsigned h = kMemInfoSeed;
+    for (char c : name) h = memInfoHashStep(h, c);
+    return h;
+}
+
+struct MemInfoTable {
+    unsigned char slot[kMemInfoSlots] = {};  // index into kMemInfoKeys + 1; 0 is empty
+    bool perfect = true;
+};
+
+constexpr MemInfoTable buildMemInfoTable()
+{
+    MemInfoTable t;
+    for (std::size_t i = 0; i < kMemInfoKeyCount; ++i) {
+        unsigned char& s = t.slot[memInfoSlot(memInfoHash(kMemInfoKeys[i].name))];
+        if (s != 0) t.perfect = false;
+        s = static_cast<unsigned char>(i + 1);
+    }
+    return t;
+}
+
+constexpr MemInfoTable kMemInfoTable = buildMemInfoTable();
+static_assert(kMemInfoTable.perfect, "meminfo keys collide; pick another kMemInfoSeed");
+static_assert(kMemInfoKeyCount < 255, "meminfo slot index is a byte");
+
+constexpr quint64 kMissing = ~quint64(0);
+
+} // namespace
+
+bool parseMemInfo(std::string_view meminfo, MemStats& out)
+{
+    const char* p = meminfo.data();
+    const char* end = p + meminfo.size();
+
+    MemInfo& info = out.info;
+    info = MemInfo{};
+    info.memAvailable = kMissing;     // absent before Linux 3.14
+
+    while (p < end) {
+        // Hash the key while looking for its ':'
+        const char* key = p;
+        unsigned h = kMemInfoSeed;
+        while (p < end && *p != ':' && *p != '\n') h = memInfoHashStep(h, *p++);
+        if (p >= end || *p != ':') { p = nextLine(p, end); continue; }
+
+        const unsigned char slot = kMemInfoTable.slot[memInfoSlot(h)];
+        const MemInfoKey* k = slot ? &kMemInfoKeys[slot - 1] : nullptr;
+        ++p;
+
+        unsigned long long v = 0;
+        if (k && k->name == std::string_view(key, std::size_t(p - 1 - key)) && parseU64(p, end, v)) {
+            // HugePages_* are page counts without a unit
+            p = skipSpaces(p, end);
+            if (startsWith(p, end, "kB")) v *= 1024ULL;
+            info.*(k->field) = v;
+        }
+        p = nextLine(p, end);
+    }
+
+    if (info.memAvailable == kMissing) {
+        // The kernel's own pre-3.14 estimate is not exported; this is the
+        // classic one, which counts all page cache as reclaimable
+        info.memAvailable = std::min(info.memTotal, info.memFree + info.buffers + info.cached + info.sReclaimable);
+    }
+
+    out.total = info.memTotal;
+    out.free = info.memFree;
+    out.available = info.memAvailable;
+    out.used = out.total > out.available ? out.total - out.available : 0;
+    out.swapTotal = info.swapTotal;
+    out.swapUsed = info.swapTotal > info.swapFree ? info.swapTotal - info.swapFree : 0;
+    out.committed = info.committedAs;
+    out.commitLimit = info.commitLimit;
+    return out.total > 0;
+}
+
+bool parsePressure(std::string_view pressure, ResourcePressure& out)
+{
+    const char* p = pressure.data();
+    const char* end = p + pressure.size();
+
+    out = ResourcePressure{};
+    while (p < end) {
+        PressureAverages* line = nullptr;
+        if (startsWith(p, end, "some ")) line = &out.some;
+        else if (startsWith(p, end, "full ")) line = &out.full;
+        if (!line) { p = nextLine(p, end); continue; }
+        p += 5;
+
+        if (!startsWith(p, end, "avg10=")) return false;
+        p += 6;
+        if (!parseDecimal(p, end, line->avg10)) return false;
+        p = skipSpaces(p, end);
+        if (!startsWith(p, end, "avg60=")) return false;
+        p += 6;
+        if (!parseDecimal(p, end, line->avg60)) return false;
+        p = skipSpaces(p, end);
+        if (!startsWith(p, end, "avg300=")) return false;
+        p += 7;
+        if (!parseDecimal(p, end, line->avg300)) return false;
+        p = skipSpaces(p, end);
+        if (!startsWith(p, end, "total=")) return false;
+        p += 6;
+        unsigned long long total = 0;
+        if (!parseU64(p, end, total)) return false;
+        line->totalUs = total;
+
+        out.available = true;
+        p = nextLine(p, end);
+    }
+    return out.available;
+}
+
+bool parseStatNumThreads(std::string_view pidStat, long long& threads)
+{
+    // comm (field 2) may contain spaces or ')', so count from the last ')'
+    std::size_t close = pidStat.rfind(')');
+    if (close == std::string_view::npos) return false;
+
+    const char* p = pidStat.data() + close + 1;
+    const char* end = pidStat.data() + pidStat.size();
+
+    // fields 3..19 (state .. nice) precede num_threads
+    for (int field = 3; field < 20; ++field) {
+        p = skipSpaces(p, end);
+        p = skipToken(p, end);
+    }
+    return parseI64(p, end, threads);
+}
+
+bool parsePidStat(std::string_view pidStat, PidStat& out)
+{
+    std::size_t open = pidStat.find('(');
+    std::size_t close = pidStat.rfind(')');
+    if (open == std::string_view::npos || close == std::string_view::npos || close < open)
+        return false;
+    out.comm = pidStat.substr(open + 1, close - open - 1);
+
+    const char* p = pidStat.data() + close + 1;
+    const char* end = pidStat.data() + pidStat.size();
+
+    p = skipSpaces(p, end);
+    if (p >= end) return false;
+    out.state = *p++;
+
+    long long ppid = 0;
+    if (!parseI64(p, end, ppid)) return false;
+    out.ppid = int(ppid);
+
+    // fields 5..13: pgrp .. cmajflt
+    for (int field = 5; field < 14; ++field) {
+        p = skipSpaces(p, end);
+        p = skipToken(p, end);
+    }
+    if (!parseU64(p, end, out.utime) || !parseU64(p, end, out.stime)) return false;
+
+    // fields 16..19: cutime cstime priority nice
+    for (int field = 16; field < 20; ++field) {
+        p = skipSpaces(p, end);
+        p = skipToken(p, end);
+    }
+    if (!parseI64(p, end, out.numThreads)) return false;
+
+    p = skipSpaces(p, end);
+    p = skipToken(p, end);              // 21: itrealvalue
+    if (!parseU64(p, end, out.startTime)) return false;
+
+    p = skipSpaces(p, end);
+    p = skipToken(p, end);              // 23: vsize
+    return parseI64(p, end, out.rssPages);
+}
+
+bool parseTaskStat(std::string_view taskStat, TaskStat& out)
+{
+    std::size_t open = taskStat.find('(');
+    std::size_t close = taskStat.rfind(')');
+    if (open == std::string_view::npos || close == std::string_view::npos || close < open)
+        return false;
+    out.comm = taskStat.substr(open + 1, close - open - 1);
+
+    const char* p = taskStat.data() + close + 1;
+    const char* end = taskStat.data() + taskStat.size();
+
+    p = skipSpaces(p, end);
+    if (p >= end) return false;
+    out.state = *p++;
+
+    // fields 4..13: ppid .. cmajflt
+    for (int field = 4; field < 14; ++field) {
+        p = skipSpaces(p, end);
+        p = skipToken(p, end);
+    }
+    if (!parseU64(p, end, out.utime) || !parseU64(p, end, out.stime)) return false;
+
+    // fields 16..38: cutime .. exit_signal
+    for (int field = 16; field < 39; ++field) {
+        p = skipSpaces(p, end);
+        p = skipToken(p, end);
+    }
+    long long processor = -1;
+    if (!parseI64(p, end, processor)) return false;
+    out.processor = int(processor);
+    return true;
+}
+
+bool parseTaskSchedstat(std::string_view schedstat, TaskSchedstat& out)
+{
+    const char* p = schedstat.data();
+    const char* end = p + schedstat.size();
+    return parseU64(p, end, out.runNs) && parseU64(p, end, out.waitNs) && parseU64(p, end, out.timeslices);
+}
+
+bool parseContextSwitches(std::string_view status, unsigned long long& voluntary, unsigned long long& involuntary)
+{
+    constexpr std::string_view kVoluntary = "\nvoluntary_ctxt_switches:";
+    constexpr std::string_view kInvoluntary = "\nnonvoluntary_ctxt_switches:";
+
+    const std::size_t v = status.rfind(kVoluntary);
+    const std::size_t n = status.rfind(kInvoluntary);
+    if (v == std::string_view::npos || n == std::string_view::npos) return false;
+
+    const char* end = status.data() + status.size();
+    const char* p = status.data() + v + kVoluntary.size();
+    const char* q = status.data() + n + kInvoluntary.size();
+    return parseU64(p, end, voluntary) && parseU64(q, end, involuntary);
+}
+
+bool parseCpuList(std::string_view list, std::vector<int>& cpus)
+{
+    cpus.clear();
+    const char* p = list.data();
+    const char* end = p + list.size();
+
+    while (p < end && *p != '\n') {
+        unsigned long long first = 0, last = 0;
+        if (!parseU64(p, end, first)) return false;
+        last = first;
+        if (p < end && *p == '-') {
+            ++p;
+            if (!parseU64(p, end, last) || last < first) return false;
+        }
+        for (unsigned long long cpu = first; cpu <= last; ++cpu) cpus.push_back(int(cpu));
+        if (p < end && *p == ',') ++p;
+    }
+    return !cpus.empty();
+}
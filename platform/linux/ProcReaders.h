@@ -0,0 +1,78 @@
+#pragma once
+
+#include <core/MemStats.h>
+#include <core/PressureStats.h>
+#include <string_view>
+#include <vector>
+
+// Parsers for the procfs files LinuxSystemMonitor samples. They take the raw
+// file content (see ProcFile) and do not allocate.
+
+struct CpuLoad {
+    unsigned long long user=0, nice=0, system=0, idle=0;
+};
+
+// Aggregate "cpu" line of /proc/stat.
+bool parseCpuLoad(std::string_view procStat, CpuLoad& out);
+
+// Every "cpu"/"cpuN" line of /proc/stat as a structure of arrays. Row 0 is
+// the aggregate line (cpuId -1), the rest follow the file order. clear()
+// keeps capacity so re-parsing the same host does not allocate.
+struct CpuJiffies {
+    std::vector<int> cpuId;
+    std::vector<unsigned long long> user, nice, system, idle, iowait, irq, softirq, steal;
+
+    std::size_t size() const { return cpuId.size(); }
+    void clear();
+};
+
+bool parseCpuJiffies(std::string_view procStat, CpuJiffies& out);
+
+// /proc/meminfo -> MemStats (bytes). Every field lands in MemStats::info;
+// usage is based on MemAvailable. Cost is one pass over the file however
+// many keys are known.
+bool parseMemInfo(std::string_view meminfo, MemStats& out);
+
+// /proc/pressure/{cpu,memory,io}: "some avg10=.. avg60=.. avg300=.. total=.."
+// and, on newer kernels, a "full" line. Sets out.available.
+bool parsePressure(std::string_view pressure, ResourcePressure& out);
+
+// num_threads (field 20) of a /proc/<pid>/stat line.
+bool parseStatNumThreads(std::string_view pidStat, long long& threads);
+
+// Fields of /proc/<pid>/stat used by the process table.
+struct PidStat {
+    std::string_view comm;      // points into the parsed buffer
+    char state = '?';
+    int ppid = 0;
+    unsigned long long utime = 0, stime = 0;
+    long long numThreads = 0;
+    unsigned long long startTime = 0;
+    long long rssPages = 0;
+};
+
+bool parsePidStat(std::string_view pidStat, PidStat& out);
+
+// Fields of /proc/<pid>/task/<tid>/stat used by the thread watch list.
+struct TaskStat {
+    std::string_view comm;      // points into the parsed buffer
+    char state = '?';
+    unsigned long long utime = 0, stime = 0;
+    int processor = -1;         // field 39: CPU the task last ran on
+};
+
+bool parseTaskStat(std::string_view taskStat, TaskStat& out);
+
+// /proc/<pid>/task/<tid>/schedstat: "run_ns wait_ns timeslices"
+struct TaskSchedstat {
+    unsigned long long runNs = 0, waitNs = 0, timeslices = 0;
+};
+
+bool parseTaskSchedstat(std::string_view schedstat, TaskSchedstat& out);
+
+// voluntary_ctxt_switches and nonvoluntary_ctxt_switches of a status file.
+// They are its last lines, so the search starts from the end.
+bool parseContextSwitches(std::string_view status, unsigned long long& voluntary, unsigned long long& involuntary);
+
+// Kernel cpulist format ("0-3,8,10-11") as in /sys/devices/system/cpu/online.
+bool parseCpuList(std::string_view list, std::vector<int>& cpus);
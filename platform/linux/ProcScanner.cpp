@@ -0,0 +1,196 @@
+#include <platform/linux/ProcScanner.h>
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ProcReaders.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Kernel layout for getdents64 records (glibc only exposes it via readdir)
+struct LinuxDirent64 {
+    unsigned long long d_ino;
+    long long          d_off;
+    unsigned short     d_reclen;
+    unsigned char      d_type;
+    char               d_name[1];
+};
+
+unsigned defaultWorkers()
+{
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    return std::min(4u, hw);
+}
+
+// PID directories are all-digit names; returns 0 for anything else
+int parsePid(const char* name)
+{
+    int pid = 0;
+    for (const char* c = name; *c; ++c) {
+        if (*c < '0' || *c > '9') return 0;
+        pid = pid * 10 + (*c - '0');
+    }
+    return pid;
+}
+
+// Formats "<pid>/stat" into buf without going through std::string
+void formatStatPath(char* buf, std::size_t size, int pid)
+{
+    std::snprintf(buf, size, "%d/stat", pid);
+}
+
+// Reads num_threads for one PID; false if it vanished mid-scan
+bool readThreads(int procFd, int pid, long long& threads)
+{
+    char path[32];
+    formatStatPath(path, sizeof(path), pid);
+
+    int fd = ::openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    // field 20 sits well within the first few hundred bytes
+    char buf[512];
+    ssize_t n;
+    do {
+        n = ::read(fd, buf, sizeof(buf));
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    selfprobe::countSyscalls(3, n > 0 ? quint64(n) : 0);
+    if (n <= 0) return false;
+
+    threads = 0;
+    parseStatNumThreads(std::string_view(buf, std::size_t(n)), threads);
+    return true;
+}
+
+} // namespace
+
+ProcScanner::ProcScanner(std::string procRoot, unsigned workers, Backend backend)
+    : m_root(std::move(procRoot))
+    , m_direntBuf(32 * 1024)
+    , m_pool((workers ? workers : defaultWorkers()) - 1)
+{
+    m_procFd = ::open(m_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (backend == Backend::IoUring) {
+        m_uring = std::make_unique<UringStatReader>();
+        if (!m_uring->isAvailable()) m_uring.reset();
+    }
+}
+
+ProcScanner::~ProcScanner()
+{
+    if (m_procFd >= 0) ::close(m_procFd);
+}
+
+bool ProcScanner::listPids(std::vector<int>& pids)
+{
+    pids.clear();
+    if (m_procFd < 0) return false;
+    selfprobe::countSyscalls(1);
+    if (::lseek(m_procFd, 0, SEEK_SET) < 0) return false;
+
+    for (;;) {
+        long n = ::syscall(SYS_getdents64, m_procFd, m_direntBuf.data(), m_direntBuf.size());
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) break;
+
+        for (long off = 0; off < n;) {
+            auto* d = reinterpret_cast<LinuxDirent64*>(m_direntBuf.data() + off);
+            off += d->d_reclen;
+            if (d->d_type != DT_DIR && d->d_type != DT_UNKNOWN) continue;
+            int pid = parsePid(d->d_name);
+            if (pid > 0) pids.push_back(pid);
+        }
+    }
+    return true;
+}
+
+ProcessThreadTotals ProcScanner::scanTotals()
+{
+    if (!listPids(m_pids)) return {};
+    return readThreadCounts(m_pids, nullptr);
+}
+
+ProcessThreadTotals ProcScanner::scanThreads(std::vector<int>& pids, std::vector<int>& threads)
+{
+    threads.clear();
+    if (!listPids(pids)) return {};
+    threads.resize(pids.size(), -1);
+    return readThreadCounts(pids, threads.data());
+}
+
+bool ProcScanner::readThreadCountsUring(const std::vector<int>& pids, int* threadsOut, ProcessThreadTotals& totals)
+{
+    totals = {};
+    return m_uring->readStats(m_procFd, pids, [&](std::size_t i, std::string_view text) {
+        long long threads = 0;
+        parseStatNumThreads(text, threads);
+        if (threadsOut) threadsOut[i] = int(threads);
+        totals.processCount++;
+        totals.threadCount += threads;
+    });
+}
+
+ProcessThreadTotals ProcScanner::readThreadCounts(const std::vector<int>& pids, int* threadsOut)
+{
+    ProcessThreadTotals totals{};
+    const int procFd = m_procFd;
+    const std::size_t count = pids.size();
+
+    if (m_uring) {
+        if (readThreadCountsUring(pids, threadsOut, totals)) return totals;
+        // The ring broke part-way: drop it and redo the scan synchronously.
+        // Dropping it is safe even if chains were still in flight: readStats()
+        // then leaked their buffers and paths instead of freeing them.
+        m_uring.reset();
+        totals = {};
+        if (threadsOut) std::fill(threadsOut, threadsOut + count, -1);
+    }
+
+    if (count < kParallelThreshold || m_pool.helperCount() == 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            long long threads = 0;
+            if (!readThreads(procFd, pids[i], threads)) continue;
+            if (threadsOut) threadsOut[i] = int(threads);
+            totals.processCount++;
+            totals.threadCount += threads;
+        }
+        return totals;
+    }
+
+    // A few chunks per thread keeps the tail short when some PIDs are slow
+    const std::size_t chunks = std::size_t(m_pool.helperCount() + 1) * 4;
+    const std::size_t per = (count + chunks - 1) / chunks;
+    std::atomic<qint32> processes{0};
+    std::atomic<qlonglong> threadsTotal{0};
+
+    m_pool.run(chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * per;
+        const std::size_t end = std::min(count, begin + per);
+        qint32 localProcs = 0;
+        qlonglong localThreads = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            long long threads = 0;
+            if (!readThreads(procFd, pids[i], threads)) continue;
+            if (threadsOut) threadsOut[i] = int(threads);
+            ++localProcs;
+            localThreads += threads;
+        }
+        processes.fetch_add(localProcs, std::memory_order_relaxed);
+        threadsTotal.fetch_add(localThreads, std::memory_order_relaxed);
+    });
+
+    totals.processCount = processes.load();
+    totals.threadCount = threadsTotal.load();
+    return totals;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <core/ProcessStats.h>
+#include <platform/linux/UringStatReader.h>
+#include <platform/linux/WorkerPool.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Walks a procfs root for process/thread totals. The root directory stays
+// open; PIDs are listed with batched getdents64 and each <pid>/stat is opened
+// relative to it with openat, so no path is built or resolved from "/".
+// Large PID lists are split across a small WorkerPool, or with the IoUring
+// backend submitted in batches through one io_uring (UringStatReader).
+class ProcScanner {
+public:
+    enum class Backend { Sync, IoUring };
+
+    // workers == 0 picks min(4, hardware threads). IoUring falls back to
+    // Sync where io_uring is unavailable.
+    explicit ProcScanner(std::string procRoot = "/proc", unsigned workers = 0, Backend backend = Backend::Sync);
+    ~ProcScanner();
+
+    ProcScanner(const ProcScanner&) = delete;
+    ProcScanner& operator=(const ProcScanner&) = delete;
+
+    bool isOpen() const { return m_procFd >= 0; }
+    int procFd() const { return m_procFd; }
+    WorkerPool& pool() { return m_pool; }
+    Backend backend() const { return m_uring ? Backend::IoUring : Backend::Sync; }
+
+    // Lists every numeric entry of the root into pids (reusing its storage).
+    bool listPids(std::vector<int>& pids);
+
+    ProcessThreadTotals scanTotals();
+
+    // Lists the root into pids and fills threads[i] with num_threads of
+    // pids[i], or -1 if that PID vanished before it could be read.
+    ProcessThreadTotals scanThreads(std::vector<int>& pids, std::vector<int>& threads);
+
+    // Below this many PIDs the scan stays on the calling thread
+    static constexpr std::size_t kParallelThreshold = 2048;
+
+private:
+    ProcessThreadTotals readThreadCounts(const std::vector<int>& pids, int* threads);
+    bool readThreadCountsUring(const std::vector<int>& pids, int* threads, ProcessThreadTotals& totals);
+
+    std::string m_root;
+    int m_procFd = -1;
+    std::vector<char> m_direntBuf;
+    std::vector<int> m_pids;
+    WorkerPool m_pool;
+    std::unique_ptr<UringStatReader> m_uring;   // null for the Sync backend
+};
@@ -0,0 +1,250 @@
+#include <platform/linux/ProcessTableCache.h>
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ProcReaders.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Reads <pid>/<name> relative to the proc root into buf; returns bytes or -1
+ssize_t readPidFile(int procFd, int pid, const char* name, char* buf, std::size_t size)
+{
+    char path[48];
+    std::snprintf(path, sizeof(path), "%d/%s", pid, name);
+
+    int fd = ::openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    ssize_t n;
+    do {
+        n = ::read(fd, buf, size);
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    selfprobe::countSyscalls(3, n > 0 ? quint64(n) : 0);
+    return n;
+}
+
+} // namespace
+
+ProcessTableCache::ProcessTableCache(ProcScanner& scanner)
+    : m_scanner(scanner)
+{
+    long hz = ::sysconf(_SC_CLK_TCK);
+    if (hz > 0) m_ticksPerSec = double(hz);
+    long page = ::sysconf(_SC_PAGESIZE);
+    if (page > 0) m_pageSize = page;
+}
+
+bool ProcessTableCache::readVolatile(Entry& e)
+{
+    char buf[1024];
+    ssize_t n = readPidFile(m_scanner.procFd(), e.info.pid, "stat", buf, sizeof(buf));
+    if (n <= 0) return false;
+
+    PidStat st;
+    if (!parsePidStat(std::string_view(buf, std::size_t(n)), st)) return false;
+
+    // Same PID, different process: start over and report exit + add
+    if (!e.isNew && st.startTime != e.info.startTime) {
+        e.isNew = true;
+        e.reusedSinceTable = e.inTable;
+        e.needsCmdline = true;
+        e.hasPrev[TableView] = e.hasPrev[TopView] = false;
+    }
+
+    if (e.isNew || e.staleStatic) {
+        e.info.comm = QString::fromUtf8(st.comm.data(), qsizetype(st.comm.size()));
+        e.info.ppid = st.ppid;
+        e.info.startTime = st.startTime;
+        e.staleStatic = false;
+    }
+    e.info.state = st.state;
+    e.info.utime = st.utime;
+    e.info.stime = st.stime;
+    e.info.threads = qint32(st.numThreads);
+    e.info.rssBytes = st.rssPages > 0 ? quint64(st.rssPages) * quint64(m_pageSize) : 0;
+    return true;
+}
+
+void ProcessTableCache::readStatic(Entry& e)
+{
+    e.info.cmdline.clear();
+    e.needsCmdline = false;
+
+    char buf[4096];
+    ssize_t n = readPidFile(m_scanner.procFd(), e.info.pid, "cmdline", buf, sizeof(buf));
+    if (n <= 0) return;
+
+    // argv is NUL-separated (and NUL-terminated)
+    std::size_t len = std::size_t(n);
+    while (len > 0 && buf[len - 1] == '\0') --len;
+    for (std::size_t i = 0; i < len; ++i)
+        if (buf[i] == '\0') buf[i] = ' ';
+    e.info.cmdline = QString::fromUtf8(buf, qsizetype(len));
+}
+
+void ProcessTableCache::invalidateStatic(int pid)
+{
+    auto it = m_entries.find(pid);
+    if (it == m_entries.end()) return;
+    it->second.staleStatic = true;
+    it->second.needsCmdline = true;
+}
+
+ProcessTable ProcessTableCache::refresh()
+{
+    std::vector<int> pids;
+    pids.swap(m_pids);
+    m_scanner.listPids(pids);
+    ProcessTable table = refresh(pids);
+    m_pids.swap(pids);
+    return table;
+}
+
+double ProcessTableCache::update(const std::vector<int>& pids, bool cmdline, View view)
+{
+    const unsigned long long gen = ++m_generation;
+
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = m_lastRefresh[view].time_since_epoch().count() == 0
+        ? 0.0
+        : std::chrono::duration<double>(now - m_lastRefresh[view]).count();
+    m_lastRefresh[view] = now;
+
+    // 1) serial: insert unknown PIDs so the map is not modified while reading
+    m_live.clear();
+    m_live.reserve(pids.size());
+    for (int pid : pids) {
+        auto [it, inserted] = m_entries.try_emplace(pid);
+        Entry& e = it->second;
+        if (inserted) e.info.pid = pid;
+        e.seenGeneration = gen;
+        m_live.push_back(&e);
+    }
+
+    // 2) parallel: re-read <pid>/stat (and cmdline for new PIDs if asked)
+    const std::size_t count = m_live.size();
+    const std::size_t chunks = count < ProcScanner::kParallelThreshold
+        ? (count ? 1 : 0)
+        : std::size_t(m_scanner.pool().helperCount() + 1) * 4;
+    const std::size_t per = chunks ? (count + chunks - 1) / chunks : 0;
+
+    m_scanner.pool().run(chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * per;
+        const std::size_t end = std::min(count, begin + per);
+        for (std::size_t i = begin; i < end; ++i) {
+            Entry& e = *m_live[i];
+            e.alive = readVolatile(e);
+            if (cmdline && e.alive && e.needsCmdline) readStatic(e);
+        }
+    });
+    return elapsed;
+}
+
+void ProcessTableCache::settle(Entry& e, View view, double elapsed)
+{
+    const quint64 ticks = e.info.utime + e.info.stime;
+    e.isNew = false;
+    if (!e.hasPrev[view]) {
+        e.info.cpuPercent = 0.0;
+    } else if (elapsed > 0.0) {
+        const quint64 delta = ticks >= e.prevTicks[view] ? ticks - e.prevTicks[view] : 0;
+        e.info.cpuPercent = 100.0 * double(delta) / (elapsed * m_ticksPerSec);
+    }
+    e.prevTicks[view] = ticks;
+    e.hasPrev[view] = true;
+}
+
+void ProcessTableCache::sweep()
+{
+    const unsigned long long gen = m_generation;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        Entry& e = it->second;
+        if (e.seenGeneration == gen && e.alive) { ++it; continue; }
+
+        // Shown by the last table and now gone; the next table reports it
+        if (e.inTable) m_tableExited.push_back(it->first);
+        it = m_entries.erase(it);
+    }
+}
+
+ProcessTable ProcessTableCache::refresh(const std::vector<int>& pids)
+{
+    ProcessTable table;
+    const double elapsed = update(pids, true, TableView);
+
+    table.processes.reserve(m_live.size());
+    for (Entry* e : m_live) {
+        if (!e->alive) continue;
+        if (e->reusedSinceTable) {
+            table.exited.push_back(e->info.pid);
+            table.added.push_back(e->info.pid);
+        } else if (!e->inTable) {
+            table.added.push_back(e->info.pid);
+        }
+        e->inTable = true;
+        e->reusedSinceTable = false;
+        settle(*e, TableView, elapsed);
+        table.processes.push_back(e->info);
+    }
+    sweep();
+    // Including what a top() in between dropped
+    table.exited.insert(table.exited.end(), m_tableExited.begin(), m_tableExited.end());
+    m_tableExited.clear();
+    return table;
+}
+
+TopProcesses ProcessTableCache::top(std::size_t n, ProcessSortKey key)
+{
+    std::vector<int> pids;
+    pids.swap(m_pids);
+    m_scanner.listPids(pids);
+    TopProcesses result = top(pids, n, key);
+    m_pids.swap(pids);
+    return result;
+}
+
+TopProcesses ProcessTableCache::top(const std::vector<int>& pids, std::size_t n, ProcessSortKey key)
+{
+    TopProcesses result;
+    result.key = key;
+    result.intervalSeconds = update(pids, false, TopView);
+
+    // Heap ordered so the weakest of the kept entries sits at the front; a
+    // candidate only costs a comparison unless it beats that one
+    const auto ranksAbove = [key](const Entry* a, const Entry* b) {
+        return processRanksAbove(a->info, b->info, key);
+    };
+    m_heap.clear();
+    if (n > 0) m_heap.reserve(std::min(n, m_live.size()));
+
+    for (Entry* e : m_live) {
+        if (!e->alive) continue;
+        settle(*e, TopView, result.intervalSeconds);
+        result.totals.processCount++;
+        result.totals.threadCount += e->info.threads;
+
+        if (n == 0) continue;
+        if (m_heap.size() < n) {
+            m_heap.push_back(e);
+            std::push_heap(m_heap.begin(), m_heap.end(), ranksAbove);
+        } else if (ranksAbove(e, m_heap.front())) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), ranksAbove);
+            m_heap.back() = e;
+            std::push_heap(m_heap.begin(), m_heap.end(), ranksAbove);
+        }
+    }
+    std::sort_heap(m_heap.begin(), m_heap.end(), ranksAbove);
+
+    result.processes.reserve(m_heap.size());
+    for (Entry* e : m_heap) {
+        if (e->needsCmdline) readStatic(*e);
+        result.processes.push_back(e->info);
+    }
+    m_heap.clear();
+    sweep();
+    return result;
+}
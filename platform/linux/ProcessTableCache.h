@@ -0,0 +1,78 @@
+#pragma once
+
+#include <core/ProcessStats.h>
+#include <platform/linux/ProcScanner.h>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+// PID-keyed cache behind LinuxSystemMonitor::getProcessTable() and
+// getTopProcesses(). comm, cmdline, ppid and start time are parsed once when
+// a PID first shows up; later refreshes only re-read <pid>/stat for the
+// volatile counters. A PID whose start time changed is treated as exited +
+// added (PID reuse).
+//
+// refresh() and top() share the per-PID state but keep their own view of
+// it: each has its own previous CPU ticks and timestamp, so CPU% always
+// covers the interval since the same call was last made, and a table's
+// added/exited lists are against the previous table, including PIDs that
+// a top() in between already saw come or go.
+class ProcessTableCache {
+public:
+    explicit ProcessTableCache(ProcScanner& scanner);
+
+    // Lists the proc root and refreshes every PID in it.
+    ProcessTable refresh();
+
+    // Refreshes an explicitly known PID set instead of listing the root.
+    ProcessTable refresh(const std::vector<int>& pids);
+
+    // One walk over pids (or the listed root) that keeps only the n best by
+    // key in a bounded heap: nothing is copied or sorted for the rest, and
+    // cmdline is read only for the winners. Shares per-PID state with
+    // refresh(); CPU% covers the interval since the previous top().
+    TopProcesses top(std::size_t n, ProcessSortKey key);
+    TopProcesses top(const std::vector<int>& pids, std::size_t n, ProcessSortKey key);
+
+    // Re-reads comm and cmdline of pid on the next refresh (after exec).
+    void invalidateStatic(int pid);
+
+    std::size_t size() const { return m_entries.size(); }
+
+private:
+    // refresh() and top() each settle CPU% against their own previous call
+    enum View { TableView, TopView, ViewCount };
+
+    struct Entry {
+        ProcessInfo info;
+        quint64 prevTicks[ViewCount] = {0, 0};     // utime + stime at the view's previous call
+        bool hasPrev[ViewCount] = {false, false};
+        unsigned long long seenGeneration = 0;
+        bool isNew = true;          // not settled yet (new or reused PID)
+        bool inTable = false;       // part of the last refresh() table
+        bool reusedSinceTable = false;  // that table showed an earlier process under this PID
+        bool staleStatic = false;   // exec'd since comm was read
+        bool needsCmdline = true;   // new, reused or exec'd and cmdline not read yet
+        bool alive = false;
+    };
+
+    // Steps shared by refresh() and top(): re-read every PID, then per live
+    // entry fold in the CPU delta, then drop what is gone
+    double update(const std::vector<int>& pids, bool cmdline, View view);
+    void settle(Entry& e, View view, double elapsed);
+    void sweep();
+
+    bool readVolatile(Entry& e);
+    void readStatic(Entry& e);
+
+    ProcScanner& m_scanner;
+    std::unordered_map<int, Entry> m_entries;
+    std::vector<int> m_pids;
+    std::vector<Entry*> m_live;
+    std::vector<Entry*> m_heap;     // top(): the n best so far, weakest at the front
+    unsigned long long m_generation = 0;
+    std::vector<qint32> m_tableExited;      // dropped since the last table, were in it
+    std::chrono::steady_clock::time_point m_lastRefresh[ViewCount] = {};
+    double m_ticksPerSec = 100.0;
+    long m_pageSize = 4096;
+};
@@ -0,0 +1,242 @@
+#include <platform/linux/StreamAggregator.h>
+#include <core/SelfInstrumentation.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kMaxEvents = 512;
+constexpr std::size_t kReadBytes = 64 * 1024;
+
+qint64 nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+StreamAggregator::StreamAggregator(StreamAggregatorOptions options)
+    : m_options(options)
+{
+}
+
+StreamAggregator::~StreamAggregator()
+{
+    stop();
+}
+
+bool StreamAggregator::start(const std::string& listen)
+{
+    if (isRunning()) return false;
+
+    StreamEndpoint endpoint;
+    if (!StreamEndpoint::parse(listen, endpoint)) return false;
+    m_listenFd = endpoint.listen(SOMAXCONN);
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_listenFd < 0 || m_epollFd < 0 || m_wakeFd < 0) {
+        stop();
+        return false;
+    }
+    m_unixPath = endpoint.unixPath;
+
+    // Listener and wake fd are level-triggered and told apart by fd
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_listenFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+    ev.data.fd = m_wakeFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    m_port = 0;
+    if (m_unixPath.empty()) {
+        sockaddr_storage bound{};
+        socklen_t boundLen = sizeof(bound);
+        ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&bound), &boundLen);
+        m_port = ntohs(bound.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                                                   : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+    }
+
+    m_thread = std::thread(&StreamAggregator::run, this);
+    return true;
+}
+
+void StreamAggregator::stop()
+{
+    if (m_thread.joinable()) {
+        const quint64 one = 1;
+        while (::write(m_wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        m_thread.join();
+    }
+    for (auto& c : m_connections) {
+        if (c) closeConnection(c->fd);
+    }
+    m_connections.clear();
+    m_acceptPaused = false;
+    auto closeFd = [](int& fd) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    };
+    closeFd(m_listenFd);
+    closeFd(m_epollFd);
+    closeFd(m_wakeFd);
+    if (!m_unixPath.empty()) ::unlink(m_unixPath.c_str());
+    m_unixPath.clear();
+}
+
+void StreamAggregator::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(m_options.rollupIntervalMs);
+    Clock::time_point due = Clock::now() + interval;
+    epoll_event events[kMaxEvents];
+
+    for (;;) {
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(due - Clock::now()).count();
+        const int n = ::epoll_wait(m_epollFd, events, kMaxEvents, int(std::max<qint64>(wait, 0)));
+        if (n < 0 && errno != EINTR) return;
+
+        const qint64 now = nowMs();
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == m_wakeFd) return;     // stop()
+            if (fd == m_listenFd) {
+                accept();
+                continue;
+            }
+            Connection* c = std::size_t(fd) < m_connections.size() ? m_connections[std::size_t(fd)].get() : nullptr;
+            if (!c) continue;
+            // EPOLLHUP/EPOLLERR: read() reports EOF or the error
+            if (!onReadable(*c, now)) closeConnection(fd);
+        }
+
+        if (Clock::now() >= due) {
+            publishRollup();
+            due += interval;
+            if (due < Clock::now()) due = Clock::now() + interval;  // fell behind; skip ticks
+        }
+    }
+}
+
+void StreamAggregator::accept()
+{
+    for (;;) {
+        const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // Out of descriptors: stop polling the listener (it would spin)
+            // until a connection closes
+            if (errno == EMFILE || errno == ENFILE) {
+                ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_listenFd, nullptr);
+                m_acceptPaused = true;
+            }
+            return;
+        }
+        if (m_connectionCount.load(std::memory_order_relaxed) >= m_options.maxConnections) {
+            ::close(fd);
+            continue;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        if (m_connections.size() <= std::size_t(fd)) m_connections.resize(std::size_t(fd) + 1);
+        auto c = std::make_unique<Connection>();
+        c->fd = fd;
+        m_connections[std::size_t(fd)] = std::move(c);
+        m_connectionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Edge-triggered: drains the socket. False to close the connection.
+bool StreamAggregator::onReadable(Connection& c, qint64 now)
+{
+    static thread_local unsigned char buf[kReadBytes];
+    for (;;) {
+        const ssize_t n = ::read(c.fd, buf, sizeof(buf));
+        if (n > 0) {
+            m_bytes += quint64(n);
+            selfprobe::countSyscalls(1, quint64(n));
+            std::size_t used = 0;
+            if (c.in.empty()) {
+                // Common case: whole frames, decoded in place
+                if (!decode(c, buf, std::size_t(n), used, now)) return false;
+                c.in.assign(buf + used, buf + n);
+            } else {
+                c.in.insert(c.in.end(), buf, buf + n);
+                if (!decode(c, c.in.data(), c.in.size(), used, now)) return false;
+                c.in.erase(c.in.begin(), c.in.begin() + std::ptrdiff_t(used));
+            }
+            continue;
+        }
+        if (n == 0) return false;   // agent went away
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+// Applies every complete frame in [data, data + size); used is what they took
+bool StreamAggregator::decode(Connection& c, const unsigned char* data, std::size_t size, std::size_t& used,
+                              qint64 now)
+{
+    used = 0;
+    RecordedSample sample;
+    for (;;) {
+        std::size_t frame = 0;
+        switch (c.decoder.next(data + used, size - used, frame, sample)) {
+        case StreamDecoder::Result::NeedMore:
+            return true;
+        case StreamDecoder::Result::Error:
+            ++m_errors;
+            return false;
+        case StreamDecoder::Result::Hello:
+            if (c.node < 0) c.node = m_table.addNode(c.decoder.node());
+            else m_table.rename(c.node, c.decoder.node());
+            break;
+        case StreamDecoder::Result::Sample:
+            m_table.update(c.node, sample, now);
+            m_samples.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        used += frame;
+    }
+}
+
+void StreamAggregator::closeConnection(int fd)
+{
+    std::unique_ptr<Connection>& c = m_connections[std::size_t(fd)];
+    if (!c) return;
+    if (c->node >= 0) m_table.removeNode(c->node);
+    ::close(fd);    // also drops it from the epoll set
+    c.reset();
+    m_connectionCount.fetch_sub(1, std::memory_order_relaxed);
+
+    if (m_acceptPaused) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = m_listenFd;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+        m_acceptPaused = false;
+    }
+}
+
+void StreamAggregator::publishRollup()
+{
+    FleetRollup rollup;
+    m_table.rollup(nowMs(), m_options.staleMs, rollup);
+    rollup.samples = m_samples.load(std::memory_order_relaxed);
+    rollup.bytes = m_bytes;
+    rollup.protocolErrors = m_errors;
+    auto snap = m_rollup.publish(std::move(rollup), std::chrono::system_clock::now());
+    for (const auto& fn : m_listeners) fn(*snap);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <core/FleetRollup.h>
+#include <core/Snapshot.h>
+#include <core/StreamProtocol.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct StreamAggregatorOptions {
+    qint64 rollupIntervalMs = 1000;
+    qint64 staleMs = 5000;              // nodes silent this long are left out of rollups
+    std::size_t maxConnections = 65536;
+};
+
+// Receiving end of the agent stream (see StreamProtocol.h). One thread runs
+// an edge-triggered epoll loop over every agent connection, decodes frames
+// straight out of the read buffer, keeps the latest sample of every node in
+// a FleetTable and publishes a FleetRollup every rollupIntervalMs.
+//
+// Each connection is one node, named by its Hello; a malformed frame closes
+// it. The process needs a file descriptor per agent (see RLIMIT_NOFILE).
+class StreamAggregator {
+public:
+    explicit StreamAggregator(StreamAggregatorOptions options = {});
+    ~StreamAggregator();
+
+    StreamAggregator(const StreamAggregator&) = delete;
+    StreamAggregator& operator=(const StreamAggregator&) = delete;
+
+    // "host:port" (port 0 picks a free one, see port()) or "unix:/path"
+    bool start(const std::string& listen);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    quint16 port() const { return m_port; }
+
+    // Runs on the aggregator's thread; register before start()
+    void onRollup(std::function<void(const Snapshot<FleetRollup>&)> fn) { m_listeners.push_back(std::move(fn)); }
+    SnapshotSlot<FleetRollup>::Ptr rollup() const { return m_rollup.load(); }
+
+    quint64 samples() const { return m_samples.load(std::memory_order_relaxed); }
+    quint64 connections() const { return m_connectionCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        int fd = -1;
+        int node = -1;
+        StreamDecoder decoder;
+        std::vector<unsigned char> in;  // start of a frame that has not fully arrived
+    };
+
+    void run();
+    void accept();
+    bool onReadable(Connection& c, qint64 nowMs);
+    bool decode(Connection& c, const unsigned char* data, std::size_t size, std::size_t& used, qint64 nowMs);
+    void closeConnection(int fd);
+    void publishRollup();
+
+    StreamAggregatorOptions m_options;
+    int m_epollFd = -1;
+    int m_listenFd = -1;
+    int m_wakeFd = -1;
+    quint16 m_port = 0;
+    std::string m_unixPath;
+    bool m_acceptPaused = false;
+
+    std::vector<std::unique_ptr<Connection>> m_connections;     // by fd
+    FleetTable m_table;
+    SnapshotSlot<FleetRollup> m_rollup;
+    std::vector<std::function<void(const Snapshot<FleetRollup>&)>> m_listeners;
+
+    std::atomic<quint64> m_samples{0};
+    std::atomic<quint64> m_connectionCount{0};
+    quint64 m_bytes = 0;
+    quint64 m_errors = 0;
+    std::thread m_thread;
+};
@@ -0,0 +1,397 @@
+#include <platform/linux/ThreadWatcher.h>
+#include <core/SelfInstrumentation.h>
+#include <platform/linux/ProcParse.h>
+#include <platform/linux/ProcReaders.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using procparse::counterDelta;
+
+namespace {
+
+// Kernel layout for getdents64 records (glibc only exposes it via readdir)
+struct LinuxDirent64 {
+    unsigned long long d_ino;
+    long long          d_off;
+    unsigned short     d_reclen;
+    unsigned char      d_type;
+    char               d_name[1];
+};
+
+constexpr const char* kFileNames[] = {"stat", "schedstat", "status"};
+constexpr std::size_t kReadBuffer = 4096;   // status is the largest, ~1.5 KiB
+
+// Task directories hold all-digit names only; returns 0 for anything else
+int parseTid(const char* name)
+{
+    int tid = 0;
+    for (const char* c = name; *c; ++c) {
+        if (*c < '0' || *c > '9') return 0;
+        tid = tid * 10 + (*c - '0');
+    }
+    return tid;
+}
+
+ssize_t readPinned(int fd, char* buf, std::size_t size)
+{
+    ssize_t n;
+    do {
+        n = ::pread(fd, buf, size, 0);
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+ssize_t readRelative(int dirFd, const char* path, char* buf, std::size_t size)
+{
+    int fd = ::openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        selfprobe::countSyscalls(1);
+        return -1;
+    }
+    ssize_t n;
+    do {
+        n = ::read(fd, buf, size);
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    selfprobe::countSyscalls(3, n > 0 ? quint64(n) : 0);
+    return n;
+}
+
+} // namespace
+
+ThreadWatcher::ThreadWatcher(ProcScanner& scanner)
+    : m_scanner(scanner)
+    , m_direntBuf(32 * 1024)
+{
+    long hz = ::sysconf(_SC_CLK_TCK);
+    if (hz > 0) m_ticksPerSec = double(hz);
+
+    rlimit rl{};
+    m_fileBudget = 512;
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0)
+        m_fileBudget = rl.rlim_cur == RLIM_INFINITY ? std::size_t(1) << 20 : std::size_t(rl.rlim_cur / 2);
+}
+
+ThreadWatcher::~ThreadWatcher()
+{
+    for (Process& p : m_processes) closeProcess(p);
+}
+
+// -------- watch list --------
+bool ThreadWatcher::watch(int pid)
+{
+    // Runs beside read(): only the procfs descriptor, fixed once the scanner
+    // is constructed, is used outside the lock
+    if (pid <= 0 || !m_scanner.isOpen()) return false;
+    char path[32];
+    std::snprintf(path, sizeof(path), "%d/task", pid);
+    if (::faccessat(m_scanner.procFd(), path, F_OK, 0) != 0) return false;
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back({pid, true});
+    return true;
+}
+
+void ThreadWatcher::unwatch(int pid)
+{
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back({pid, false});
+}
+
+void ThreadWatcher::applyPending()
+{
+    std::vector<Change> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+    }
+    for (const Change& c : pending) {
+        auto it = std::find_if(m_processes.begin(), m_processes.end(),
+                               [&](const Process& p) { return p.pid == c.pid; });
+        if (!c.watch) {
+            if (it == m_processes.end()) continue;
+            closeProcess(*it);
+            m_processes.erase(it);
+        } else if (it == m_processes.end()) {
+            Process p;
+            p.pid = c.pid;
+            if (openProcess(p)) m_processes.push_back(std::move(p));
+            else closeProcess(p);
+        }
+    }
+}
+
+// -------- descriptors --------
+bool ThreadWatcher::openProcess(Process& p)
+{
+    char path[32];
+    std::snprintf(path, sizeof(path), "%d/stat", p.pid);
+    p.statFd = ::openat(m_scanner.procFd(), path, O_RDONLY | O_CLOEXEC);
+    std::snprintf(path, sizeof(path), "%d/task", p.pid);
+    p.taskFd = ::openat(m_scanner.procFd(), path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    selfprobe::countSyscalls(2);
+    m_openFiles += (p.statFd >= 0) + (p.taskFd >= 0);
+    return p.statFd >= 0 && p.taskFd >= 0;
+}
+
+void ThreadWatcher::closeProcess(Process& p)
+{
+    for (Task& t : p.tasks) closeTask(t);
+    p.tasks.clear();
+    for (int* fd : {&p.statFd, &p.taskFd}) {
+        if (*fd < 0) continue;
+        ::close(*fd);
+        *fd = -1;
+        --m_openFiles;
+    }
+}
+
+void ThreadWatcher::openTask(Task& t, int taskFd)
+{
+    if (m_openFiles + FileCount > m_fileBudget) return;     // read through openat instead
+
+    char path[32];
+    for (int f = 0; f < FileCount; ++f) {
+        std::snprintf(path, sizeof(path), "%d/%s", t.tid, kFileNames[f]);
+        t.fds[f] = ::openat(taskFd, path, O_RDONLY | O_CLOEXEC);
+        if (t.fds[f] >= 0) ++m_openFiles;
+    }
+    selfprobe::countSyscalls(FileCount);
+    // schedstat is missing without CONFIG_SCHED_INFO; stat is what decides
+    // whether the thread is there
+    t.pinned = t.fds[Stat] >= 0;
+}
+
+void ThreadWatcher::closeTask(Task& t)
+{
+    for (int& fd : t.fds) {
+        if (fd < 0) continue;
+        ::close(fd);
+        fd = -1;
+        --m_openFiles;
+    }
+    t.pinned = false;
+}
+
+// -------- process and task list --------
+// false once the process exited or its PID was reused
+bool ThreadWatcher::refreshProcess(Process& p)
+{
+    char buf[1024];
+    const ssize_t n = readPinned(p.statFd, buf, sizeof(buf));
+    PidStat st;
+    if (n <= 0 || !parsePidStat(std::string_view(buf, std::size_t(n)), st)) return false;
+    if (p.startTime == 0) p.startTime = st.startTime;
+    else if (st.startTime != p.startTime) return false;
+
+    if (p.rawComm != st.comm) {
+        p.rawComm.assign(st.comm.data(), st.comm.size());
+        p.comm = QString::fromUtf8(st.comm.data(), qsizetype(st.comm.size()));
+    }
+
+    if (st.numThreads != qint64(p.tasks.size()) || ++p.readsSinceList >= kRelistEvery) p.relist = true;
+    return true;
+}
+
+// Lists <pid>/task and merges it into p.tasks, recording added and exited
+// threads. The first listing of a process reports nothing as added.
+bool ThreadWatcher::listTasks(Process& p)
+{
+    m_tids.clear();
+    selfprobe::countSyscalls(1);
+    if (::lseek(p.taskFd, 0, SEEK_SET) < 0) return false;
+    for (;;) {
+        long n = ::syscall(SYS_getdents64, p.taskFd, m_direntBuf.data(), m_direntBuf.size());
+        selfprobe::countSyscalls(1, n > 0 ? quint64(n) : 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) break;
+        for (long off = 0; off < n;) {
+            auto* d = reinterpret_cast<LinuxDirent64*>(m_direntBuf.data() + off);
+            off += d->d_reclen;
+            int tid = parseTid(d->d_name);
+            if (tid > 0) m_tids.push_back(tid);
+        }
+    }
+    // An exited process lists as empty
+    if (m_tids.empty()) return false;
+    std::sort(m_tids.begin(), m_tids.end());
+
+    const bool first = !p.listed;
+    std::vector<Task> merged;
+    merged.reserve(m_tids.size());
+    std::size_t i = 0;
+    for (int tid : m_tids) {
+        while (i < p.tasks.size() && p.tasks[i].tid < tid) {
+            p.exited.push_back(p.tasks[i].tid);
+            closeTask(p.tasks[i++]);
+        }
+        if (i < p.tasks.size() && p.tasks[i].tid == tid) {
+            merged.push_back(std::move(p.tasks[i++]));
+            continue;
+        }
+        Task t;
+        t.tid = tid;
+        t.stats.tid = tid;
+        openTask(t, p.taskFd);
+        merged.push_back(std::move(t));
+        if (!first) p.added.push_back(tid);
+    }
+    for (; i < p.tasks.size(); ++i) {
+        p.exited.push_back(p.tasks[i].tid);
+        closeTask(p.tasks[i]);
+    }
+    p.tasks.swap(merged);
+    p.listed = true;
+    p.relist = false;
+    p.readsSinceList = 0;
+    return true;
+}
+
+// -------- per-thread read --------
+// Runs on WorkerPool threads: touches nothing but t
+bool ThreadWatcher::readTask(Task& t, int taskFd, double seconds) const
+{
+    char buf[kReadBuffer];
+    auto readFile = [&](File f) -> ssize_t {
+        if (t.pinned) return t.fds[f] >= 0 ? readPinned(t.fds[f], buf, sizeof(buf)) : -1;
+        char path[32];
+        std::snprintf(path, sizeof(path), "%d/%s", t.tid, kFileNames[f]);
+        return readRelative(taskFd, path, buf, sizeof(buf));
+    };
+
+    ThreadStats& s = t.stats;
+    const quint64 prevUtime = s.utime, prevStime = s.stime;
+    const quint64 prevRun = s.runNs, prevWait = s.waitNs, prevSlices = s.timeslices;
+    const quint64 prevVoluntary = s.voluntarySwitches, prevInvoluntary = s.involuntarySwitches;
+
+    ssize_t n = readFile(Stat);
+    TaskStat st;
+    if (n <= 0 || !parseTaskStat(std::string_view(buf, std::size_t(n)), st)) return false;
+    if (t.rawComm != st.comm) {
+        t.rawComm.assign(st.comm.data(), st.comm.size());
+        s.comm = QString::fromUtf8(st.comm.data(), qsizetype(st.comm.size()));
+    }
+    s.state = st.state;
+    s.processor = st.processor;
+    s.utime = st.utime;
+    s.stime = st.stime;
+
+    n = readFile(Schedstat);
+    TaskSchedstat sched;
+    const bool hasSched = n > 0 && parseTaskSchedstat(std::string_view(buf, std::size_t(n)), sched);
+    s.runNs = sched.runNs;
+    s.waitNs = sched.waitNs;
+    s.timeslices = sched.timeslices;
+
+    // Every context switch ends a timeslice: unchanged means the counts are too
+    if (t.fresh || !hasSched || s.timeslices != prevSlices) {
+        n = readFile(Status);
+        unsigned long long voluntary = 0, involuntary = 0;
+        if (n > 0 && parseContextSwitches(std::string_view(buf, std::size_t(n)), voluntary, involuntary)) {
+            s.voluntarySwitches = voluntary;
+            s.involuntarySwitches = involuntary;
+        }
+    }
+
+    if (t.fresh || seconds <= 0) {
+        s.cpuPercent = s.userPercent = s.systemPercent = s.runDelayPercent = 0;
+        s.voluntaryPerSec = s.involuntaryPerSec = 0;
+    } else {
+        const double tickPercent = 100.0 / (m_ticksPerSec * seconds);
+        s.userPercent = double(counterDelta(s.utime, prevUtime)) * tickPercent;
+        s.systemPercent = double(counterDelta(s.stime, prevStime)) * tickPercent;
+        s.cpuPercent = hasSched ? double(counterDelta(s.runNs, prevRun)) / 1e9 / seconds * 100.0
+                                : s.userPercent + s.systemPercent;
+        s.runDelayPercent = double(counterDelta(s.waitNs, prevWait)) / 1e9 / seconds * 100.0;
+        s.voluntaryPerSec = double(counterDelta(s.voluntarySwitches, prevVoluntary)) / seconds;
+        s.involuntaryPerSec = double(counterDelta(s.involuntarySwitches, prevInvoluntary)) / seconds;
+    }
+    t.fresh = false;
+    return true;
+}
+
+// -------- table --------
+ThreadTable ThreadWatcher::read()
+{
+    applyPending();
+
+    ThreadTable table;
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = m_lastRead.time_since_epoch().count() == 0
+        ? 0.0
+        : std::chrono::duration<double>(now - m_lastRead).count();
+    m_lastRead = now;
+    table.intervalSeconds = seconds;
+
+    m_work.clear();
+    for (Process& p : m_processes) {
+        p.added.clear();
+        p.exited.clear();
+        if (!refreshProcess(p) || (p.relist && !listTasks(p))) {
+            p.alive = false;
+            for (const Task& t : p.tasks) p.exited.push_back(t.tid);
+            closeProcess(p);
+            continue;
+        }
+        for (Task& t : p.tasks) m_work.push_back({&t, p.taskFd});
+    }
+
+    const std::size_t count = m_work.size();
+    const std::size_t chunks = count < ProcScanner::kParallelThreshold
+        ? (count ? 1 : 0)
+        : std::size_t(m_scanner.pool().helperCount() + 1) * 4;
+    const std::size_t per = chunks ? (count + chunks - 1) / chunks : 0;
+    m_scanner.pool().run(chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * per;
+        const std::size_t end = std::min(count, begin + per);
+        for (std::size_t i = begin; i < end; ++i)
+            m_work[i].task->ok = readTask(*m_work[i].task, m_work[i].taskFd, seconds);
+    });
+
+    m_threadCount = 0;
+    table.processes.reserve(m_processes.size());
+    for (Process& p : m_processes) {
+        WatchedProcess w;
+        w.pid = p.pid;
+        w.comm = p.comm;
+        w.alive = p.alive;
+
+        // A thread that failed to read has exited; the next listing picks
+        // up whatever replaced it
+        std::size_t kept = 0;
+        for (Task& t : p.tasks) {
+            if (!t.ok) {
+                p.exited.push_back(t.tid);
+                closeTask(t);
+                p.relist = true;
+                continue;
+            }
+            if (&p.tasks[kept] != &t) p.tasks[kept] = std::move(t);
+            ++kept;
+        }
+        p.tasks.resize(kept);
+        m_threadCount += kept;
+
+        w.threads.reserve(kept);
+        for (const Task& t : p.tasks) w.threads.push_back(t.stats);
+        std::sort(p.exited.begin(), p.exited.end());
+        w.added = std::move(p.added);
+        w.exited = std::move(p.exited);
+        table.processes.push_back(std::move(w));
+    }
+
+    m_processes.erase(std::remove_if(m_processes.begin(), m_processes.end(),
+                                     [](const Process& p) { return !p.alive; }),
+                      m_processes.end());
+    return table;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <core/ThreadStats.h>
+#include <platform/linux/ProcScanner.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Per-thread stats of a watch list of processes, read from
+// <pid>/task/<tid>/{stat,schedstat,status}.
+//
+// Every watched process keeps <pid>/stat and its task directory open; every
+// thread keeps its three files open and a read is one pread per file, parsed
+// in place. status (context switch counts) is only re-read for threads whose
+// schedstat timeslice count moved. The task directory is listed again when
+// num_threads changed, a thread failed to read, or every kRelistEvery reads
+// to catch one thread replacing another, so thread churn costs one
+// getdents64 pass and no path lookups for threads that stayed.
+//
+// Pinned descriptors are capped at half the RLIMIT_NOFILE soft limit; past
+// that, threads are read with openat relative to their task directory.
+// Large thread sets are read on the ProcScanner's WorkerPool.
+class ThreadWatcher {
+public:
+    explicit ThreadWatcher(ProcScanner& scanner);
+    ~ThreadWatcher();
+
+    ThreadWatcher(const ThreadWatcher&) = delete;
+    ThreadWatcher& operator=(const ThreadWatcher&) = delete;
+
+    // Safe from any thread; takes effect on the next read(). watch() is
+    // false if pid does not exist.
+    bool watch(int pid);
+    void unwatch(int pid);
+
+    ThreadTable read();
+
+    std::size_t threadCount() const { return m_threadCount; }
+    std::size_t openFiles() const { return m_openFiles; }
+
+    // Listing interval (in reads) when num_threads did not change
+    static constexpr unsigned kRelistEvery = 10;
+
+private:
+    enum File { Stat, Schedstat, Status, FileCount };
+
+    struct Task {
+        int tid = 0;
+        int fds[FileCount] = {-1, -1, -1};
+        bool pinned = false;            // fds are open; else openat per read
+        bool fresh = true;              // no previous sample yet
+        bool ok = false;                // last read succeeded
+        std::string rawComm;            // comm as last parsed, to skip re-decoding
+        ThreadStats stats;              // previous counters until the next read
+    };
+
+    struct Process {
+        int pid = 0;
+        QString comm;
+        std::string rawComm;
+        unsigned long long startTime = 0;
+        int statFd = -1;
+        int taskFd = -1;
+        std::vector<Task> tasks;        // ascending tid
+        std::vector<qint32> added;
+        std::vector<qint32> exited;
+        unsigned readsSinceList = 0;
+        bool listed = false;
+        bool relist = true;
+        bool alive = true;
+    };
+
+    struct Change {
+        int pid;
+        bool watch;
+    };
+
+    struct Work {
+        Task* task;
+        int taskFd;
+    };
+
+    void applyPending();
+    bool openProcess(Process& p);
+    void closeProcess(Process& p);
+    bool refreshProcess(Process& p);
+    bool listTasks(Process& p);
+    void openTask(Task& t, int taskFd);
+    void closeTask(Task& t);
+    bool readTask(Task& t, int taskFd, double seconds) const;
+
+    ProcScanner& m_scanner;
+    std::mutex m_pendingMutex;
+    std::vector<Change> m_pending;          // watch/unwatch calls in order
+    std::vector<Process> m_processes;
+    std::vector<Work> m_work;
+    std::vector<int> m_tids;
+    std::vector<char> m_direntBuf;
+    std::chrono::steady_clock::time_point m_lastRead{};
+    std::size_t m_threadCount = 0;
+    std::size_t m_openFiles = 0;
+    std::size_t m_fileBudget = 0;
+    double m_ticksPerSec = 100.0;
+};
@@ -0,0 +1,235 @@
+#include <platform/linux/UringStatReader.h>
+#include <core/SelfInstrumentation.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+// "<pid>/stat" fits easily
+constexpr std::size_t kPathSize = 24;
+
+enum Op : unsigned long long { OpOpen = 0, OpRead = 1, OpClose = 2 };
+
+unsigned long long userData(unsigned slot, Op op) { return (static_cast<unsigned long long>(slot) << 2) | op; }
+
+int ioUringSetup(unsigned entries, io_uring_params* p)
+{
+    return int(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return int(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count)
+{
+    return int(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// The ring indices are shared with the kernel
+unsigned loadAcquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+void storeRelease(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+} // namespace
+
+UringStatReader::UringStatReader(unsigned batch, std::size_t readSize)
+    : m_batch(batch ? batch : 1)
+    , m_readSize(readSize)
+    , m_buffers(std::size_t(m_batch) * readSize)
+    , m_paths(std::size_t(m_batch) * kPathSize)
+{
+    if (!setup()) teardown();
+}
+
+UringStatReader::~UringStatReader()
+{
+    teardown();
+}
+
+bool UringStatReader::setup()
+{
+    io_uring_params p{};
+    m_ringFd = ioUringSetup(m_batch * 3, &p);
+    if (m_ringFd < 0) return false;
+
+    // Every opcode of the chain has to exist (OPENAT and CLOSE: 5.6)
+    std::vector<char> probeBuf(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(probeBuf.data());
+    if (ioUringRegister(m_ringFd, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+    for (unsigned op : {unsigned(IORING_OP_OPENAT), unsigned(IORING_OP_READ_FIXED), unsigned(IORING_OP_CLOSE)}) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+
+    m_sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    m_cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+    m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) { m_sqRing = nullptr; return false; }
+    if (single) {
+        m_cqRing = m_sqRing;
+    } else {
+        m_cqRing = ::mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) { m_cqRing = nullptr; return false; }
+    }
+    m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED) { m_sqes = nullptr; return false; }
+
+    char* sq = static_cast<char*>(m_sqRing);
+    char* cq = static_cast<char*>(m_cqRing);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    m_cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    m_cqes = cq + p.cq_off.cqes;
+
+    // SQ slot i always holds SQE i, so submitting is just moving the tail
+    auto* array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    for (unsigned i = 0; i < p.sq_entries; ++i) array[i] = i;
+
+    // One direct-descriptor slot and one buffer region per chain
+    std::vector<int> files(m_batch, -1);
+    if (ioUringRegister(m_ringFd, IORING_REGISTER_FILES, files.data(), m_batch) < 0) return false;
+    iovec iov{m_buffers.data(), m_buffers.size()};
+    if (ioUringRegister(m_ringFd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) return false;
+    return true;
+}
+
+void UringStatReader::teardown()
+{
+    if (m_sqes) ::munmap(m_sqes, m_sqesSize);
+    if (m_cqRing && m_cqRing != m_sqRing) ::munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing) ::munmap(m_sqRing, m_sqRingSize);
+    m_sqes = m_cqRing = m_sqRing = nullptr;
+    if (m_ringFd >= 0) ::close(m_ringFd);
+    m_ringFd = -1;
+}
+
+// io-wq may still complete reads into the registered buffers after the ring
+// is closed; when completions can no longer be waited for, the buffers are
+// leaked rather than freed under it
+void UringStatReader::abandon()
+{
+    new std::vector<char>(std::move(m_buffers));
+    new std::vector<char>(std::move(m_paths));
+}
+
+bool UringStatReader::readStats(int dirFd, const std::vector<int>& pids,
+                                const std::function<void(std::size_t, std::string_view)>& onStat)
+{
+    if (m_ringFd < 0) return false;
+    auto* sqes = static_cast<io_uring_sqe*>(m_sqes);
+    auto* cqes = static_cast<io_uring_cqe*>(m_cqes);
+
+    for (std::size_t base = 0; base < pids.size(); base += m_batch) {
+        const unsigned count = unsigned(std::min<std::size_t>(m_batch, pids.size() - base));
+        unsigned tail = *m_sqTail;
+
+        for (unsigned slot = 0; slot < count; ++slot) {
+            char* path = m_paths.data() + std::size_t(slot) * kPathSize;
+            std::snprintf(path, kPathSize, "%d/stat", pids[base + slot]);
+
+            // Direct descriptors cannot be O_CLOEXEC; they never reach the fd table
+            io_uring_sqe* open = &sqes[tail++ & m_sqMask];
+            std::memset(open, 0, sizeof(*open));
+            open->opcode = IORING_OP_OPENAT;
+            open->fd = dirFd;
+            open->addr = reinterpret_cast<unsigned long long>(path);
+            open->open_flags = O_RDONLY;
+            open->file_index = slot + 1;
+            open->flags = IOSQE_IO_LINK;
+            open->user_data = userData(slot, OpOpen);
+
+            // Hard link: a short read must not cancel the close
+            io_uring_sqe* read = &sqes[tail++ & m_sqMask];
+            std::memset(read, 0, sizeof(*read));
+            read->opcode = IORING_OP_READ_FIXED;
+            read->fd = int(slot);
+            read->addr = reinterpret_cast<unsigned long long>(m_buffers.data() + std::size_t(slot) * m_readSize);
+            read->len = unsigned(m_readSize);
+            read->buf_index = 0;
+            read->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+            read->user_data = userData(slot, OpRead);
+
+            io_uring_sqe* close = &sqes[tail++ & m_sqMask];
+            std::memset(close, 0, sizeof(*close));
+            close->opcode = IORING_OP_CLOSE;
+            close->file_index = slot + 1;
+            close->user_data = userData(slot, OpClose);
+        }
+        storeRelease(m_sqTail, tail);
+
+        // A chain is done once its close completed (or was cancelled); only
+        // then may the next batch reuse its slot. Every SQE the kernel took
+        // posts exactly one CQE, so inFlight counts what it may still write.
+        unsigned toSubmit = count * 3;
+        unsigned inFlight = 0;
+        unsigned pending = count;
+        bool failed = false;
+        while (pending > 0) {
+            unsigned head = *m_cqHead;
+            const unsigned cqTail = loadAcquire(m_cqTail);
+            for (; head != cqTail; ++head) {
+                const io_uring_cqe& cqe = cqes[head & m_cqMask];
+                const unsigned slot = unsigned(cqe.user_data >> 2);
+                --inFlight;
+                switch (Op(cqe.user_data & 3)) {
+                case OpOpen:
+                    // Kernels before 5.15 reject opens into a direct slot
+                    if (cqe.res == -EINVAL) failed = true;
+                    break;
+                case OpRead:
+                    if (cqe.res > 0 && !failed) {
+                        selfprobe::countSyscalls(0, quint64(cqe.res));
+                        onStat(base + slot, std::string_view(m_buffers.data() + std::size_t(slot) * m_readSize,
+                                                             std::size_t(cqe.res)));
+                    }
+                    break;
+                case OpClose:
+                    --pending;
+                    break;
+                }
+            }
+            storeRelease(m_cqHead, head);
+            if (pending == 0) break;
+            // After a failure nothing more is submitted; what never reached
+            // the kernel will not complete
+            if (failed && inFlight == 0) break;
+
+            const int submitted = ioUringEnter(m_ringFd, failed ? 0 : toSubmit, 1, IORING_ENTER_GETEVENTS);
+            selfprobe::countSyscalls(1);
+            if (submitted < 0) {
+                if (errno == EINTR) continue;
+                // First error: stop submitting and wait for the chains
+                // already in flight. A second one leaves no way to wait.
+                if (failed || inFlight == 0) {
+                    if (inFlight > 0) abandon();
+                    break;
+                }
+                failed = true;
+                continue;
+            }
+            toSubmit -= std::min(toSubmit, unsigned(submitted));
+            inFlight += unsigned(submitted);
+        }
+        if (failed || pending > 0) {
+            // Nothing is in flight any more, or abandon() kept the buffers
+            // alive for what is: the ring can go
+            teardown();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// Reads <pid>/stat for many PIDs through io_uring instead of an openat,
+// read and close syscall each. Every PID is one linked chain: OPENAT into a
+// registered (direct) file slot, READ_FIXED from that slot into a registered
+// buffer, CLOSE of the slot. A whole batch of chains is submitted with one
+// io_uring_enter and each read is handed to the caller as its completion
+// arrives. The kernel runs the chains on its io-wq workers, so the calling
+// thread mostly waits.
+//
+// Talks to the kernel through raw syscalls (no liburing). isAvailable() is
+// false when io_uring is missing, disabled (kernel.io_uring_disabled,
+// seccomp) or lacks one of the opcodes; callers keep a synchronous path.
+class UringStatReader {
+public:
+    // batch: chains in flight at once; readSize: bytes read per file
+    explicit UringStatReader(unsigned batch = 256, std::size_t readSize = 512);
+    ~UringStatReader();
+
+    UringStatReader(const UringStatReader&) = delete;
+    UringStatReader& operator=(const UringStatReader&) = delete;
+
+    bool isAvailable() const { return m_ringFd >= 0; }
+
+    // Calls onStat(i, text) on the calling thread for every pids[i] whose
+    // stat could be read, in completion order; PIDs that are gone are
+    // skipped. False if the ring failed part-way (some PIDs may have been
+    // reported); the reader is unavailable from then on. Either way the
+    // reader can then be destroyed: chains that could not be waited for keep
+    // writing into buffers that are leaked, never freed (abandon()).
+    bool readStats(int dirFd, const std::vector<int>& pids,
+                   const std::function<void(std::size_t, std::string_view)>& onStat);
+
+private:
+    bool setup();
+    void teardown();
+    void abandon();
+
+    unsigned m_batch;
+    std::size_t m_readSize;
+    int m_ringFd = -1;
+
+    // Shared ring memory
+    void* m_sqRing = nullptr;
+    void* m_cqRing = nullptr;
+    void* m_sqes = nullptr;
+    std::size_t m_sqRingSize = 0;
+    std::size_t m_cqRingSize = 0;
+    std::size_t m_sqesSize = 0;
+    unsigned* m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    void* m_cqes = nullptr;
+
+    std::vector<char> m_buffers;        // registered: m_batch slots of m_readSize
+    std::vector<char> m_paths;          // "<pid>/stat" per slot, alive until its open runs
+};
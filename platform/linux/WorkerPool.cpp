@@ -0,0 +1,76 @@
+#include <platform/linux/WorkerPool.h>
+
+WorkerPool::WorkerPool(unsigned helpers)
+{
+    m_threads.reserve(helpers);
+    for (unsigned i = 0; i < helpers; ++i)
+        m_threads.emplace_back([this] { workerLoop(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+}
+
+void WorkerPool::drain()
+{
+    for (;;) {
+        std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= m_count) break;
+        (*m_task)(i);
+    }
+}
+
+void WorkerPool::run(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    if (count == 0) return;
+    if (m_threads.empty() || count == 1) {
+        for (std::size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_probe = selfprobe::t_current;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = unsigned(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+}
+
+void WorkerPool::workerLoop()
+{
+    unsigned long long seen = 0;
+    for (;;) {
+        CollectorProbe* probe = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+            probe = m_probe;
+        }
+
+        {
+            ProbeAttach attach(probe);
+            drain();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) m_done.notify_one();
+    }
+}
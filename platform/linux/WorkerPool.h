@@ -0,0 +1,44 @@
+#pragma once
+
+#include <core/SelfInstrumentation.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed set of helper threads for splitting one batch of independent
+// tasks. The calling thread takes part in the batch, so a pool with zero
+// helpers simply runs everything inline.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned helpers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned helperCount() const { return unsigned(m_threads.size()); }
+
+    // Calls task(i) for every i in [0, count) and returns once all are done.
+    // Not reentrant: one batch at a time.
+    void run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    CollectorProbe* m_probe = nullptr;      // caller's collector, charged for helper syscalls
+    std::size_t m_count = 0;
+    std::atomic<std::size_t> m_next{0};
+    unsigned m_busy = 0;
+    unsigned long long m_generation = 0;
+    bool m_stop = false;
+};
@@ -75,7 +75,9 @@ static CpuCoresStats readAppleSiliconCpuCores()
             int coreId   = m.captured(1).toInt();
             double mhz   = m.captured(2).toDouble();
 
-            stats.coresMap[coreId] = mhz;  // store per-core freq
+            if (coreId >= int(stats.coreFreq.size()))
+                stats.coreFreq.resize(coreId + 1, 0.0);
+            stats.coreFreq[coreId] = mhz;  // store per-core freq
             total += mhz;
             count++;
         }
@@ -163,6 +165,8 @@ MemStats MacSystemMonitor::getMemStats() {
         quint64 wired    = (quint64)vmStats.wire_count * pageSize;
         ms.free = freeMem;
         ms.used = active + inactive + wired;
+        // Inactive pages are reclaimed before anything is swapped out
+        ms.available = freeMem + inactive;
     }
 
     // swap info
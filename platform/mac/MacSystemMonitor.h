@@ -8,6 +8,7 @@
 class MacSystemMonitor : public ISystemMonitor {
 public:
     ~MacSystemMonitor() override = default;
+    using ISystemMonitor::getCpuStats;
     CpuStats getCpuStats() override;
     MemStats getMemStats() override;
     ProcessThreadTotals getProcessThreadCount() override;
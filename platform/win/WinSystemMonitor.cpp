@@ -74,6 +74,7 @@ static MemStats readMem() {
         ms.total = static_cast<quint64>(msex.ullTotalPhys);
         quint64 free = static_cast<quint64>(msex.ullAvailPhys);
         ms.free = free;
+        ms.available = free;
         ms.used = (ms.total > free) ? (ms.total - free) : 0;
     }
 
@@ -84,6 +85,8 @@ static MemStats readMem() {
         const quint64 commitTot  = static_cast<quint64>(pi.CommitTotal) * pageSize;
         const quint64 commitLim  = static_cast<quint64>(pi.CommitLimit) * pageSize;
         // Windows doesn't expose "swap used" exactly; commit charge is the closest public metric.
+        ms.committed = commitTot;
+        ms.commitLimit = commitLim;
         ms.swapTotal = commitLim;
         ms.swapUsed  = (commitTot > ms.total) ? (commitTot - ms.total) : 0; // heuristic
         // If you prefer, you can just report commitTot/commitLim directly:
@@ -6,6 +6,7 @@
 class WinSystemMonitor : public ISystemMonitor {
 public:
     ~WinSystemMonitor() override = default;
+    using ISystemMonitor::getCpuStats;
     CpuStats getCpuStats() override;
     MemStats getMemStats() override;
     ProcessThreadTotals getProcessThreadCount() override;
@@ -0,0 +1,101 @@
+// sysmon_aggregator.cpp
+// Central end of the agent stream: accepts statsTest --stream-to connections
+// (or bench/sysmon_fleetsim agents) and prints fleet-wide rollups, with
+// percentiles across nodes per metric, every interval.
+//
+//   sysmon_aggregator [--listen host:port|unix:path] [--interval-ms N] [--stale-ms N]
+//                     [--max-connections N] [--seconds N]
+#include <platform/linux/StreamAggregator.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+
+static std::atomic<bool> g_stop{false};
+
+static void onSignal(int)
+{
+    g_stop = true;
+}
+
+static int usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--listen host:port|unix:path] [--interval-ms N] [--stale-ms N]\n"
+                 "       [--max-connections N] [--seconds N]\n"
+                 "\n"
+                 "  --listen           where agents connect (default 127.0.0.1:9106)\n"
+                 "  --interval-ms N    rollup and print interval (default 1000)\n"
+                 "  --stale-ms N       leave out nodes silent this long (default 5000)\n"
+                 "  --seconds N        exit after N seconds, 0 = until SIGINT/SIGTERM (default 0)\n", argv0);
+    return 2;
+}
+
+// Every agent is a descriptor; take as many as we are allowed
+static void raiseFileLimit()
+{
+    rlimit rl{};
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+static void printRollup(const Snapshot<FleetRollup>& snap)
+{
+    const FleetRollup& r = snap.value;
+    std::printf("\nnodes %d (%d reporting)  samples %llu  received %.1f KiB  protocol errors %llu\n",
+                r.nodes, r.reporting, static_cast<unsigned long long>(r.samples), double(r.bytes) / 1024.0,
+                static_cast<unsigned long long>(r.protocolErrors));
+    std::printf("%-20s %6s %12s %12s %12s %12s %12s  %s\n", "metric", "nodes", "min", "p50", "p90", "p99", "max",
+                "max node");
+    for (const MetricRollup& m : r.metrics) {
+        if (m.nodes == 0) continue;
+        std::printf("%-20s %6d %12.6g %12.6g %12.6g %12.6g %12.6g  %s\n", m.name, m.nodes, m.min, m.p50, m.p90,
+                    m.p99, m.max, m.maxNode.c_str());
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string listen = "127.0.0.1:9106";
+    StreamAggregatorOptions options;
+    long seconds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--listen") && hasValue) listen = argv[++i];
+        else if (!std::strcmp(arg, "--interval-ms") && hasValue) options.rollupIntervalMs = std::atol(argv[++i]);
+        else if (!std::strcmp(arg, "--stale-ms") && hasValue) options.staleMs = std::atol(argv[++i]);
+        else if (!std::strcmp(arg, "--max-connections") && hasValue) options.maxConnections = std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--seconds") && hasValue) seconds = std::atol(argv[++i]);
+        else return usage(argv[0]);
+    }
+    if (options.rollupIntervalMs <= 0 || options.staleMs <= 0) return usage(argv[0]);
+
+    raiseFileLimit();
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    StreamAggregator aggregator(options);
+    aggregator.onRollup(printRollup);
+    if (!aggregator.start(listen)) {
+        std::fprintf(stderr, "cannot listen on %s\n", listen.c_str());
+        return 1;
+    }
+    if (aggregator.port()) std::printf("listening on port %u\n", unsigned(aggregator.port()));
+    else std::printf("listening on %s\n", listen.c_str());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (!g_stop && (seconds <= 0 || std::chrono::steady_clock::now() < deadline))
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    aggregator.stop();
+    return 0;
+}